@@ -0,0 +1,563 @@
+// loopback_benchmark.cpp - Full vsomeip path between gateway and ECU on one host
+//
+// Forks the central_gateway and a vehicle_ecu as separate processes with a
+// generated vsomeip configuration, once per transport:
+//   local: one routing manager (the gateway), the ECU talks to it over UDS
+//   udp:   each process is its own routing manager (127.0.0.1 / 127.0.0.2),
+//          SD disabled, requests travel over UDP on the loopback interface
+//   tcp:   same, but requests and responses travel over the service's
+//          reliable port (vsomeip disables Nagle on its TCP sockets)
+// With --coalesce, vsomeip's nPDU debounce batches requests and responses
+// into shared datagrams / segments. The ECU sweeps message rate x payload
+// size with acknowledged speed samples and reports throughput, round-trip
+// percentiles and CPU time per message of both processes.
+// --snapshot sends bulk snapshots (method 0x0011) over UDP instead, split
+// into SOME/IP-TP segments, and repeats the sweep for every combination of
+// segment length and separation time.
+#include <vsomeip/vsomeip.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "sensor_data.h"
+#include "async_log.h"
+#include "inflight_window.h"
+#include "load_generator.h"
+#include "process_cpu.h"
+#include "request_pool.h"
+#include "sensor_snapshot.h"
+
+namespace {
+
+const vsomeip::service_t kService = 0x1234;
+const vsomeip::instance_t kInstance = 0x0001;
+const uint16_t kGatewayPort = 30509;
+const uint16_t kGatewayReliablePort = 30510;
+// Largest single-sample payload that still fits one vsomeip UDP datagram
+const size_t kMaxPayload = 1400;
+
+struct LoopbackOptions {
+    std::vector<std::string> transports = {"local", "udp", "tcp"};
+    std::vector<double> rates_hz = {1000, 10000, 50000};
+    std::vector<size_t> sizes = {20, 256, 1024};
+    double duration_s = 3.0;
+    size_t window = 256;
+    // nPDU timings in ms for the speed method; 0 debounce sends every message on its own
+    unsigned debounce_ms = 0;
+    unsigned retention_ms = 0;
+    // Snapshot mode: SOME/IP-TP segment payload lengths and gaps between segments
+    bool snapshot = false;
+    std::vector<size_t> segment_lengths = {kMaxTpSegmentLength};
+    std::vector<size_t> separations_us = {0};
+    bool csv = false;
+};
+
+// Sweep defaults of snapshot mode, unless --rates / --sizes are given
+const std::vector<double> kSnapshotRates = {50, 200, 1000};
+const std::vector<size_t> kSnapshotSizes = {4096, 16384, 65536};
+
+// SOME/IP-TP parameters of one gateway / ECU pair; segment_length 0 without TP
+struct TpSegmentation {
+    size_t segment_length;
+    size_t separation_us;
+};
+
+struct SweepResult {
+    std::string transport;
+    double requested_hz;
+    size_t payload;
+    double achieved_hz;
+    uint64_t completed;
+    uint64_t timeouts;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+    unsigned debounce_ms;
+    size_t segment_length;  // 0 without SOME/IP-TP
+    size_t separation_us;
+    double ecu_cpu_us;      // per completed message
+    double gateway_cpu_us;
+};
+
+template <typename T>
+bool parse_list(const char* text, std::vector<T>& out, bool allow_zero = false) {
+    if (text == nullptr || *text == '\0') return false;
+    std::vector<T> values;
+    std::stringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        char* end = nullptr;
+        double value = std::strtod(item.c_str(), &end);
+        if (item.empty() || *end != '\0' || !(value > 0 || (allow_zero && value == 0))) return false;
+        values.push_back(static_cast<T>(value));
+    }
+    out = values;
+    return !out.empty();
+}
+
+bool parse_options(int argc, char** argv, LoopbackOptions& out, std::string& error) {
+    bool rates_given = false;
+    bool sizes_given = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--transport") {
+            std::string transport = value ? value : "";
+            if (transport == "all") {
+                out.transports = {"local", "udp", "tcp"};
+            } else if (transport == "local" || transport == "udp" || transport == "tcp") {
+                out.transports = {transport};
+            } else {
+                error = "--transport expects local, udp, tcp or all";
+                return false;
+            }
+            ++i;
+        } else if (arg == "--rates") {
+            if (!parse_list(value, out.rates_hz)) {
+                error = "--rates expects HZ[,HZ...]";
+                return false;
+            }
+            rates_given = true;
+            ++i;
+        } else if (arg == "--sizes") {
+            if (!parse_list(value, out.sizes)) {
+                error = "--sizes expects BYTES[,BYTES...]";
+                return false;
+            }
+            sizes_given = true;
+            ++i;
+        } else if (arg == "--snapshot") {
+            out.snapshot = true;
+        } else if (arg == "--segment") {
+            if (!parse_list(value, out.segment_lengths)) {
+                error = "--segment expects BYTES[,BYTES...]";
+                return false;
+            }
+            for (size_t length : out.segment_lengths) {
+                if (length % kTpSegmentAlignment != 0 || length > kMaxTpSegmentLength) {
+                    error = "--segment lengths must be multiples of " + std::to_string(kTpSegmentAlignment) +
+                            " up to " + std::to_string(kMaxTpSegmentLength) + " bytes";
+                    return false;
+                }
+            }
+            ++i;
+        } else if (arg == "--separation") {
+            if (!parse_list(value, out.separations_us, true)) {
+                error = "--separation expects MICROSECONDS[,MICROSECONDS...]";
+                return false;
+            }
+            ++i;
+        } else if (arg == "--duration") {
+            char* end = nullptr;
+            out.duration_s = value ? std::strtod(value, &end) : 0.0;
+            if (value == nullptr || *end != '\0' || !(out.duration_s > 0)) {
+                error = "--duration expects a positive number of seconds";
+                return false;
+            }
+            ++i;
+        } else if (arg == "--window") {
+            std::vector<size_t> window;
+            if (!parse_list(value, window) || window.size() != 1) {
+                error = "--window expects a number of requests";
+                return false;
+            }
+            out.window = window[0];
+            ++i;
+        } else if (arg == "--coalesce") {
+            // DEBOUNCE[:RETENTION] in ms; the retention defaults to twice the debounce
+            std::string text = value ? value : "";
+            size_t colon = text.find(':');
+            char* end = nullptr;
+            unsigned long debounce = std::strtoul(text.c_str(), &end, 10);
+            bool valid = !text.empty() && end == text.c_str() + (colon == std::string::npos ? text.size() : colon);
+            unsigned long retention = 2 * debounce;
+            if (valid && colon != std::string::npos) {
+                retention = std::strtoul(text.c_str() + colon + 1, &end, 10);
+                valid = colon + 1 < text.size() && *end == '\0' && retention >= debounce;
+            }
+            if (!valid || debounce > 1000) {
+                error = "--coalesce expects DEBOUNCE[:RETENTION] milliseconds, retention >= debounce";
+                return false;
+            }
+            out.debounce_ms = static_cast<unsigned>(debounce);
+            out.retention_ms = static_cast<unsigned>(retention);
+            ++i;
+        } else if (arg == "--csv") {
+            out.csv = true;
+        } else {
+            error = "unknown option " + arg;
+            return false;
+        }
+    }
+    
+    // Snapshots travel over UDP with SOME/IP-TP only
+    size_t min_size = extended_payload_size<SpeedSensor>();
+    size_t max_size = kMaxPayload;
+    if (out.snapshot) {
+        out.transports = {"udp"};
+        if (!rates_given) out.rates_hz = kSnapshotRates;
+        if (!sizes_given) out.sizes = kSnapshotSizes;
+        min_size = kSnapshotHeaderSize + snapshot_section_size(1);
+        max_size = kMaxSnapshotSize;
+    }
+    for (size_t size : out.sizes) {
+        if (size < min_size || size > max_size) {
+            error = "--sizes must lie between " + std::to_string(min_size) + " and " + std::to_string(max_size) +
+                    " bytes";
+            return false;
+        }
+    }
+    return true;
+}
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --transport T   local (UDS via one routing manager), udp or tcp (loopback), or all (default)\n"
+              << "  --rates LIST    request rates in messages/s (default 1000,10000,50000)\n"
+              << "  --sizes LIST    payload sizes in bytes, 20.." << kMaxPayload << " (default 20,256,1024)\n"
+              << "  --duration S    seconds per rate/size point (default 3)\n"
+              << "  --window N      unanswered requests in flight before the ECU waits (default 256)\n"
+              << "  --coalesce D[:R] vsomeip nPDU coalescing: wait D ms for more messages, hold one at most\n"
+              << "                  R ms (default 2 x D); off by default\n"
+              << "Snapshot mode:\n"
+              << "  --snapshot      send bulk snapshots (method 0x0011) over UDP with SOME/IP-TP; sizes up to "
+              << kMaxSnapshotSize << "\n"
+              << "                  bytes (default 4096,16384,65536) at rates 50,200,1000 unless given\n"
+              << "  --segment LIST  SOME/IP-TP segment lengths, multiples of 16 up to " << kMaxTpSegmentLength
+              << " (default " << kMaxTpSegmentLength << ")\n"
+              << "  --separation LIST  microseconds between two segments of a message (default 0)\n"
+              << "  --csv           print CSV rows instead of a table\n";
+}
+
+// ==================== CONFIGURATION ====================
+
+std::string application_entry(const char* name, const char* id) {
+    return std::string("{ \"name\": \"") + name + "\", \"id\": \"" + id + "\" }";
+}
+
+// One configuration file per process; the network name keeps the UDS
+// sockets apart from a gateway that may be running on the same host
+std::string write_config(const std::string& directory, const std::string& file, const std::string& unicast,
+                         const std::string& routing, const std::string& network, const std::string& services) {
+    std::string path = directory + "/" + file;
+    std::ofstream out(path);
+    out << "{\n"
+        << "  \"unicast\": \"" << unicast << "\",\n"
+        << "  \"network\": \"" << network << "\",\n"
+        << "  \"logging\": { \"level\": \"warning\", \"console\": \"true\" },\n"
+        << "  \"max-payload-size-unreliable\": \"" << kMaxSnapshotSize + 16 << "\",\n"
+        << "  \"applications\": [ " << application_entry("central_gateway", "0x0127") << ", "
+        << application_entry("vehicle_ecu", "0x0100") << " ],\n"
+        << "  \"services\": [ " << services << " ],\n"
+        << "  \"routing\": \"" << routing << "\",\n"
+        << "  \"service-discovery\": { \"enable\": \"false\" }\n"
+        << "}\n";
+    return path;
+}
+
+struct TransportConfig {
+    std::string gateway;
+    std::string ecu;
+};
+
+// Ports of the service entry; the reliable port carries no magic cookies
+std::string service_ports() {
+    return "\"unreliable\": \"" + std::to_string(kGatewayPort) + "\", \"reliable\": { \"port\": \"" +
+           std::to_string(kGatewayReliablePort) + "\", \"enable-magic-cookies\": \"false\" }";
+}
+
+// nPDU timings of the speed method for requests (ECU side) or responses (gateway side)
+std::string debounce_times(const LoopbackOptions& options, const char* direction) {
+    if (options.debounce_ms == 0) return "";
+    return std::string(", \"debounce-times\": { \"") + direction + "\": { \"0x0001\": { \"debounce-time\": \"" +
+           std::to_string(options.debounce_ms) + "\", \"maximum-retention-time\": \"" +
+           std::to_string(options.retention_ms) + "\" } } }";
+}
+
+// SOME/IP-TP segmentation of snapshot requests; both sides list the method
+std::string someip_tp(const LoopbackOptions& options, size_t segment_length, size_t separation_us) {
+    if (!options.snapshot) return "";
+    return ", \"someip-tp\": { \"client-to-service\": [ { \"method\": \"0x0011\", \"max-segment-length\": \"" +
+           std::to_string(segment_length) + "\", \"separation-time\": \"" + std::to_string(separation_us) +
+           "\" } ] }";
+}
+
+TransportConfig write_transport_config(const std::string& directory, const std::string& transport,
+                                       const LoopbackOptions& options, size_t segment_length, size_t separation_us) {
+    const std::string network = "vsomeip-loopback-" + std::to_string(::getpid());
+    const std::string tp = someip_tp(options, segment_length, separation_us);
+    const std::string offered = "{ \"service\": \"0x1234\", \"instance\": \"0x0001\", " + service_ports() +
+                                debounce_times(options, "responses") + tp + " }";
+    TransportConfig config;
+    if (transport == "local") {
+        config.gateway = write_config(directory, "local.json", "127.0.0.1", "central_gateway", network, offered);
+        config.ecu = config.gateway;
+    } else {
+        // Static remote service: the ECU reaches the gateway without SD
+        const std::string remote = "{ \"service\": \"0x1234\", \"instance\": \"0x0001\", \"unicast\": \"127.0.0.1\", " +
+                                   service_ports() + debounce_times(options, "requests") + tp + " }";
+        config.gateway = write_config(directory, transport + "-gateway.json", "127.0.0.1", "central_gateway",
+                                      network + "-gw", offered);
+        config.ecu = write_config(directory, transport + "-ecu.json", "127.0.0.2", "vehicle_ecu",
+                                  network + "-ecu", remote);
+    }
+    return config;
+}
+
+// ==================== GATEWAY PROCESS ====================
+
+std::shared_ptr<vsomeip::application> gateway;
+
+// The real gateway handlers, answering every acknowledged request
+int run_gateway(const std::string& config) {
+    ::setenv("VSOMEIP_CONFIGURATION", config.c_str(), 1);
+    console_log().set_enabled(false);
+    gateway = vsomeip::runtime::get()->create_application("central_gateway");
+    if (!gateway->init()) return 1;
+    set_response_sink([](const std::shared_ptr<vsomeip::message> &response) { gateway->send(response); });
+    for (auto method : Sensors::method_ids) {
+        gateway->register_message_handler(kService, kInstance, method, dispatch_sensor_message);
+    }
+    gateway->register_message_handler(kService, kInstance, kSensorSnapshotMethod, on_sensor_snapshot_message);
+    gateway->offer_service(kService, kInstance);
+    gateway->start();
+    return 0;
+}
+
+// ==================== ECU PROCESS ====================
+
+std::shared_ptr<vsomeip::application> ecu;
+std::atomic<bool> service_available(false);
+std::atomic<bool> running(true);
+std::atomic<InFlightWindow*> current_window(nullptr);
+
+// Snapshot with one speed section filling size bytes, rounded down to whole samples
+std::vector<uint8_t> make_snapshot(size_t size) {
+    const uint16_t count = static_cast<uint16_t>(
+        std::min<size_t>((size - kSnapshotHeaderSize - kBatchHeaderSize) / kBatchRecordSize, 0xFFFF));
+    std::vector<uint8_t> bytes(kSnapshotHeaderSize + snapshot_section_size(count));
+    encode_snapshot_header(0, 1, bytes.data(), kCurrentWireFormat);
+    uint8_t* section = bytes.data() + kSnapshotHeaderSize;
+    encode_batch_header<SpeedSensor>(count, section, kCurrentWireFormat);
+    for (uint16_t i = 0; i < count; ++i) {
+        SpeedData sample = {60.0f + i % 50, i};
+        encode_batch_record<SpeedSensor>(sample, i, section, kCurrentWireFormat);
+    }
+    return bytes;
+}
+
+SweepResult run_point(const LoopbackOptions& options, const std::string& transport, const TpSegmentation& tp,
+                      double rate_hz, size_t size, pid_t gateway_pid) {
+    InFlightWindow window(options.window, std::chrono::milliseconds(1000));
+    current_window.store(&window, std::memory_order_release);
+    std::vector<uint8_t> bytes = options.snapshot ? make_snapshot(size) : std::vector<uint8_t>(size, 0);
+    RequestPool pool(kService, kInstance, options.snapshot ? kSensorSnapshotMethod : SpeedSensor::method_id,
+                     vsomeip::message_type_e::MT_REQUEST, interface_version_of(kCurrentWireFormat),
+                     transport == "tcp", options.window + 16, bytes.size());
+    SpeedData data = {};
+    data.speed_kmh = 88.0f;
+
+    typedef DeadlinePacer::clock clock;
+    DeadlinePacer pacer(DeadlinePacer::interval_for(rate_hz, 1), clock::now());
+    const double ecu_cpu_before = process_cpu_s();
+    const double gateway_cpu_before = other_process_cpu_s(gateway_pid);
+    const auto start = clock::now();
+    const auto end = start + std::chrono::nanoseconds(static_cast<int64_t>(options.duration_s * 1e9));
+    uint32_t sequence = 0;
+
+    while (running && clock::now() < end) {
+        pacer.wait();
+        if (options.snapshot) {
+            encode_snapshot_header(sequence++, 1, bytes.data(), kCurrentWireFormat);
+        } else {
+            data.timestamp = sequence;
+            encode_sensor_data<SpeedSensor>(data, bytes.data(), kCurrentWireFormat);
+            encode_sample_extension<SpeedSensor>(SampleExtension{sequence++, monotonic_ns(), 0}, bytes.data(),
+                                                 kCurrentWireFormat);
+        }
+        auto request = pool.acquire(bytes.data(), bytes.size());
+        window.send(running, [&request]() {
+            ecu->send(request);
+            return request->get_session();
+        });
+    }
+    // Let the last responses arrive before the window goes away
+    auto drain_deadline = clock::now() + std::chrono::seconds(1);
+    while (window.in_flight() > 0 && clock::now() < drain_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    current_window.store(nullptr, std::memory_order_release);
+
+    SweepResult result;
+    result.transport = transport;
+    result.requested_hz = rate_hz;
+    result.payload = bytes.size();
+    result.completed = window.rtt().count();
+    result.timeouts = window.timeouts();
+    result.achieved_hz = elapsed > 0 ? result.completed / elapsed : 0.0;
+    result.p50_ns = window.rtt().percentile(0.50);
+    result.p99_ns = window.rtt().percentile(0.99);
+    result.p999_ns = window.rtt().percentile(0.999);
+    result.max_ns = window.rtt().max();
+    result.debounce_ms = options.debounce_ms;
+    result.segment_length = tp.segment_length;
+    result.separation_us = tp.separation_us;
+    const double messages = result.completed > 0 ? static_cast<double>(result.completed) : 1.0;
+    result.ecu_cpu_us = (process_cpu_s() - ecu_cpu_before) * 1e6 / messages;
+    result.gateway_cpu_us = (other_process_cpu_s(gateway_pid) - gateway_cpu_before) * 1e6 / messages;
+    return result;
+}
+
+void print_result(const SweepResult& r, bool csv) {
+    char line[256];
+    const double megabytes_s = r.achieved_hz * r.payload / 1e6;
+    if (csv) {
+        std::snprintf(line, sizeof(line), "%s,%u,%zu,%zu,%.0f,%zu,%.0f,%.2f,%llu,%llu,%.1f,%.1f,%.1f,%.1f,%.2f,%.2f\n",
+                      r.transport.c_str(), r.debounce_ms, r.segment_length, r.separation_us, r.requested_hz,
+                      r.payload, r.achieved_hz, megabytes_s,
+                      static_cast<unsigned long long>(r.completed), static_cast<unsigned long long>(r.timeouts),
+                      r.p50_ns / 1e3, r.p99_ns / 1e3, r.p999_ns / 1e3, r.max_ns / 1e3,
+                      r.ecu_cpu_us, r.gateway_cpu_us);
+    } else {
+        std::snprintf(line, sizeof(line),
+                      "%-6s %10.0f %6zu %10.0f %8.2f %8llu %8.1f %8.1f %8.1f %9.1f %9.2f %9.2f\n",
+                      r.transport.c_str(), r.requested_hz, r.payload, r.achieved_hz, megabytes_s,
+                      static_cast<unsigned long long>(r.timeouts),
+                      r.p50_ns / 1e3, r.p99_ns / 1e3, r.p999_ns / 1e3, r.max_ns / 1e3,
+                      r.ecu_cpu_us, r.gateway_cpu_us);
+    }
+    std::cout << line << std::flush;
+}
+
+int run_ecu(const LoopbackOptions& options, const std::string& transport, const TpSegmentation& tp,
+            const std::string& config, pid_t gateway_pid) {
+    ::setenv("VSOMEIP_CONFIGURATION", config.c_str(), 1);
+    console_log().set_enabled(false);
+    ecu = vsomeip::runtime::get()->create_application("vehicle_ecu");
+    if (!ecu->init()) return 1;
+    ecu->register_availability_handler(kService, kInstance,
+        [](vsomeip::service_t, vsomeip::instance_t, bool available) { service_available = available; });
+    ecu->register_message_handler(kService, kInstance,
+        options.snapshot ? kSensorSnapshotMethod : SpeedSensor::method_id,
+        [](const std::shared_ptr<vsomeip::message>& response) {
+            InFlightWindow* window = current_window.load(std::memory_order_acquire);
+            if (window) {
+                window->complete(response->get_session(), response->get_return_code() == vsomeip::return_code_e::E_OK);
+            }
+        });
+    ecu->request_service(kService, kInstance);
+    std::thread vsomeip_thread([]() { ecu->start(); });
+
+    auto wait_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!service_available && std::chrono::steady_clock::now() < wait_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    int status = 0;
+    if (!service_available) {
+        std::cerr << "❌ " << transport << ": gateway not available" << std::endl;
+        status = 1;
+    } else {
+        for (size_t size : options.sizes) {
+            for (double rate : options.rates_hz) {
+                print_result(run_point(options, transport, tp, rate, size, gateway_pid), options.csv);
+            }
+        }
+    }
+    ecu->stop();
+    vsomeip_thread.join();
+    return status;
+}
+
+// Runs fn in a child process; the child never returns into the caller
+template <typename Function>
+pid_t spawn(Function fn) {
+    std::cout.flush();
+    pid_t pid = ::fork();
+    if (pid == 0) ::_exit(fn());
+    return pid;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    LoopbackOptions options;
+    std::string error;
+    if (!parse_options(argc, argv, options, error)) {
+        std::cerr << "❌ " << error << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    char directory[] = "/tmp/vsomeip-loopback-XXXXXX";
+    if (::mkdtemp(directory) == nullptr) {
+        std::cerr << "❌ cannot create a configuration directory" << std::endl;
+        return 1;
+    }
+
+    if (options.csv) {
+        std::cout << "transport,debounce_ms,segment_bytes,separation_us,rate_hz,payload_bytes,achieved_hz,mb_per_s,"
+                     "completed,timeouts,rtt_p50_us,rtt_p99_us,rtt_p999_us,rtt_max_us,"
+                     "ecu_cpu_us_per_msg,gateway_cpu_us_per_msg\n";
+    } else {
+        if (options.debounce_ms > 0) {
+            std::cout << "nPDU coalescing of the speed method: " << options.debounce_ms << "ms debounce, "
+                      << options.retention_ms << "ms maximum retention\n";
+        }
+    }
+
+    // One gateway / ECU pair per transport and, in snapshot mode, per segmentation
+    std::vector<TpSegmentation> segmentations = {TpSegmentation{0, 0}};
+    if (options.snapshot) {
+        segmentations.clear();
+        for (size_t length : options.segment_lengths) {
+            for (size_t separation : options.separations_us) {
+                segmentations.push_back(TpSegmentation{length, separation});
+            }
+        }
+    }
+
+    int status = 0;
+    for (const std::string& transport : options.transports) {
+        for (const TpSegmentation& tp : segmentations) {
+            if (!options.csv) {
+                if (options.snapshot) {
+                    std::cout << "SOME/IP-TP: " << tp.segment_length << "-byte segments, " << tp.separation_us
+                              << "us separation\n";
+                }
+                std::cout << "transport    rate/s  bytes  achieved/s     MB/s  timeouts  p50(us)  p99(us) p99.9(us)"
+                             "  max(us) ecu cpu/msg(us) gw cpu/msg(us)\n";
+            }
+            TransportConfig config = write_transport_config(directory, transport, options, tp.segment_length,
+                                                            tp.separation_us);
+            pid_t gateway_pid = spawn([&config]() { return run_gateway(config.gateway); });
+            // The gateway hosts the routing manager of the local transport
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            pid_t ecu_pid = spawn([&]() { return run_ecu(options, transport, tp, config.ecu, gateway_pid); });
+
+            int ecu_status = 0;
+            ::waitpid(ecu_pid, &ecu_status, 0);
+            ::kill(gateway_pid, SIGTERM);
+            ::waitpid(gateway_pid, nullptr, 0);
+            if (!WIFEXITED(ecu_status) || WEXITSTATUS(ecu_status) != 0) status = 1;
+        }
+    }
+
+    std::string command = std::string("rm -rf ") + directory;
+    std::system(command.c_str());
+    return status;
+}
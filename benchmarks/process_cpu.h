@@ -0,0 +1,36 @@
+#ifndef PROCESS_CPU_H
+#define PROCESS_CPU_H
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+// CPU time of benchmark processes, shared by the multi-process benchmarks
+
+// user + system time of the calling process
+inline double process_cpu_s() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+// user + system time of another process, from /proc/<pid>/stat
+inline double other_process_cpu_s(pid_t pid) {
+    std::ifstream in("/proc/" + std::to_string(pid) + "/stat");
+    std::string stat((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t name_end = stat.rfind(')');
+    if (name_end == std::string::npos) return 0.0;
+    std::istringstream fields(stat.substr(name_end + 2));
+    std::string skip;
+    // Fields 3 (state) to 13 precede utime and stime
+    for (int i = 3; i <= 13; ++i) fields >> skip;
+    unsigned long long utime = 0, stime = 0;
+    fields >> utime >> stime;
+    return static_cast<double>(utime + stime) / ::sysconf(_SC_CLK_TCK);
+}
+
+#endif // PROCESS_CPU_H
@@ -0,0 +1,148 @@
+// profile_benchmark.cpp - Gateway handler throughput of one build profile
+//
+// Built twice from the same source, as profile_benchmark_debug and
+// profile_benchmark_perf (common/build_profile.cmake). Dispatches single
+// samples of every sensor through the real handlers as fast as possible for
+// a fixed time, with the console redirected to a file as the entrypoints do,
+// and reports messages/s and CPU time per message. The debug build pays for
+// one formatted line per message; the perf build has them compiled out.
+// The profile_comparison target runs both.
+#include <vsomeip/vsomeip.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+#include "sensor_data.h"
+#include "async_log.h"
+
+namespace {
+
+struct ProfileOptions {
+    double duration_s = 3.0;
+    std::string log_path = "profile_benchmark.log";
+    bool csv = false;
+};
+
+bool parse_options(int argc, char** argv, ProfileOptions& out, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--duration") {
+            char* end = nullptr;
+            out.duration_s = value ? std::strtod(value, &end) : 0.0;
+            if (!value || *end != '\0' || !(out.duration_s > 0)) {
+                error = "--duration expects a positive number of seconds";
+                return false;
+            }
+            ++i;
+        } else if (arg == "--log") {
+            if (!value) {
+                error = "--log expects a file";
+                return false;
+            }
+            out.log_path = value;
+            ++i;
+        } else if (arg == "--csv") {
+            out.csv = true;
+        } else {
+            error = "unknown option " + arg;
+            return false;
+        }
+    }
+    return true;
+}
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --duration S    seconds of dispatching (default 3)\n"
+              << "  --log FILE      where console lines go (default profile_benchmark.log)\n"
+              << "  --csv           print a CSV row instead of a table\n";
+}
+
+double process_cpu_s() {
+    struct rusage usage;
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+// One request per sensor, in the current wire format, reused for every dispatch
+std::vector<std::shared_ptr<vsomeip::message>> make_requests() {
+    std::vector<std::shared_ptr<vsomeip::message>> requests;
+    for_each_sensor(Sensors{}, [&requests](auto tag) {
+        using S = typename decltype(tag)::type;
+        typename S::data_type data = {};
+        data.*S::value = 42.0f;
+        data.timestamp = 1;
+        std::vector<uint8_t> bytes(S::payload_size);
+        encode_sensor_data<S>(data, bytes.data(), kCurrentWireFormat);
+        auto request = vsomeip::runtime::get()->create_request();
+        request->set_service(0x1234);
+        request->set_instance(0x0001);
+        request->set_method(S::method_id);
+        request->set_interface_version(interface_version_of(kCurrentWireFormat));
+        request->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+        requests.push_back(request);
+    });
+    return requests;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ProfileOptions options;
+    std::string error;
+    if (!parse_options(argc, argv, options, error)) {
+        std::cerr << "❌ " << error << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::ofstream log(options.log_path, std::ios::trunc);
+    if (!log) {
+        std::cerr << "❌ Cannot write " << options.log_path << std::endl;
+        return 1;
+    }
+    auto requests = make_requests();
+
+    // The log writer formats into the file, like server.log under the entrypoint
+    std::streambuf* console = std::cout.rdbuf(log.rdbuf());
+    uint64_t messages = 0;
+    double cpu_start = process_cpu_s();
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double>(options.duration_s));
+    do {
+        for (int round = 0; round < 1024; ++round) {
+            for (const auto& request : requests) {
+                dispatch_sensor_message(request);
+            }
+        }
+        messages += 1024 * requests.size();
+    } while (std::chrono::steady_clock::now() < deadline);
+    // Lines still queued are part of the cost
+    console_log().flush();
+    double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double cpu_s = process_cpu_s() - cpu_start;
+    std::cout.rdbuf(console);
+
+    const char* profile = kLogPerMessage ? "debug" : "perf";
+    double rate = messages / elapsed_s;
+    double cpu_us = cpu_s * 1e6 / messages;
+    if (options.csv) {
+        std::printf("profile,messages,seconds,msg_per_s,cpu_us_per_msg,log_lines_dropped\n");
+        std::printf("%s,%llu,%.3f,%.0f,%.3f,%llu\n", profile, static_cast<unsigned long long>(messages), elapsed_s,
+                    rate, cpu_us, static_cast<unsigned long long>(console_log().dropped()));
+    } else {
+        std::printf("%-8s %12s %10s %12s %12s %14s\n", "profile", "messages", "seconds", "msg/s", "cpu us/msg",
+                    "lines dropped");
+        std::printf("%-8s %12llu %10.3f %12.0f %12.3f %14llu\n", profile, static_cast<unsigned long long>(messages),
+                    elapsed_s, rate, cpu_us, static_cast<unsigned long long>(console_log().dropped()));
+    }
+    return 0;
+}
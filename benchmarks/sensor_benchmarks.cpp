@@ -0,0 +1,330 @@
+// sensor_benchmarks.cpp - Encode/decode and handler dispatch micro-benchmarks
+#include <benchmark/benchmark.h>
+#include <vsomeip/vsomeip.hpp>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "sensor_data.h"
+#include "sensor_history.h"
+#include "sensor_batch.h"
+#include "sensor_snapshot.h"
+#include "sensor_batcher.h"
+#include "async_log.h"
+#include "batch_decode.h"
+#include "alert_engine.h"
+
+// Helper function to build the 8-byte payload the client sends per sample
+static std::vector<uint8_t> make_sample_payload(float value, uint32_t timestamp) {
+    std::vector<uint8_t> payload(8);
+    std::memcpy(payload.data(), &value, 4);
+    std::memcpy(payload.data() + 4, &timestamp, 4);
+    return payload;
+}
+
+static std::shared_ptr<vsomeip::message> make_request(vsomeip::method_t method, const std::vector<uint8_t>& bytes) {
+    auto request = vsomeip::runtime::get()->create_request();
+    request->set_service(0x1234);
+    request->set_instance(0x0001);
+    request->set_method(method);
+    request->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    return request;
+}
+
+template <typename S>
+static std::vector<uint8_t> make_batch_payload(size_t count) {
+    std::vector<uint8_t> bytes(batch_payload_size(count));
+    encode_batch_header<S>(static_cast<uint16_t>(count), bytes.data());
+    for (size_t i = 0; i < count; ++i) {
+        typename S::data_type data = {};
+        data.*S::value = static_cast<float>(i % 120);
+        data.timestamp = static_cast<uint32_t>(i);
+        encode_batch_record<S>(data, i, bytes.data());
+    }
+    return bytes;
+}
+
+// ==================== GATEWAY DECODE ====================
+
+static void BM_DeserializeSpeedVector(benchmark::State& state) {
+    auto payload = make_sample_payload(85.5f, 12345);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(deserialize_speed_data(payload));
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_DeserializeSpeedVector);
+
+static void BM_DeserializeEngineTempVector(benchmark::State& state) {
+    auto payload = make_sample_payload(95.0f, 12345);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(deserialize_engine_temp_data(payload));
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_DeserializeEngineTempVector);
+
+static void BM_DeserializeAmbientTempVector(benchmark::State& state) {
+    auto payload = make_sample_payload(21.0f, 12345);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(deserialize_ambient_temp_data(payload));
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_DeserializeAmbientTempVector);
+
+// Receive path as the handlers use it: decode in place from the vsomeip payload
+template <typename S>
+static void BM_DecodeFromPayloadView(benchmark::State& state) {
+    auto bytes = make_sample_payload(42.0f, 1);
+    auto payload = vsomeip::runtime::get()->create_payload(bytes);
+    for (auto _ : state) {
+        typename S::data_type data = {};
+        benchmark::DoNotOptimize(decode_sensor_data<S>(PayloadView(*payload), data));
+        benchmark::DoNotOptimize(data);
+    }
+    state.counters["payload_bytes"] = static_cast<double>(S::payload_size);
+}
+BENCHMARK_TEMPLATE(BM_DecodeFromPayloadView, SpeedSensor);
+BENCHMARK_TEMPLATE(BM_DecodeFromPayloadView, EngineTempSensor);
+BENCHMARK_TEMPLATE(BM_DecodeFromPayloadView, AmbientTempSensor);
+
+// ==================== CLIENT ENCODE ====================
+
+// Client send path: encode one sample into a stack buffer
+template <typename S>
+static void BM_ClientEncode(benchmark::State& state) {
+    typename S::data_type data = {};
+    data.*S::value = 88.8f;
+    data.timestamp = 12345;
+    uint8_t bytes[extended_payload_size<S>()];
+    for (auto _ : state) {
+        encode_sensor_data<S>(data, bytes);
+        benchmark::DoNotOptimize(bytes);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * S::payload_size);
+}
+BENCHMARK_TEMPLATE(BM_ClientEncode, SpeedSensor);
+BENCHMARK_TEMPLATE(BM_ClientEncode, EngineTempSensor);
+BENCHMARK_TEMPLATE(BM_ClientEncode, AmbientTempSensor);
+
+// Encode plus decode of one sample with latency extension, per wire format
+static void BM_WireFormatRoundTrip(benchmark::State& state) {
+    const WireFormat format = static_cast<WireFormat>(state.range(0));
+    SpeedData data = {88.8f, 12345};
+    uint8_t bytes[extended_payload_size<SpeedSensor>()];
+    uint32_t sequence = 0;
+    for (auto _ : state) {
+        encode_sensor_data<SpeedSensor>(data, bytes, format);
+        encode_sample_extension<SpeedSensor>(SampleExtension{sequence++, 42, 0}, bytes, format);
+        SpeedData decoded = {};
+        SampleExtension extension = {};
+        decode_sensor_data<SpeedSensor>(PayloadView(bytes, sizeof(bytes)), decoded, format);
+        decode_sample_extension<SpeedSensor>(PayloadView(bytes, sizeof(bytes)), extension, format);
+        benchmark::DoNotOptimize(decoded);
+        benchmark::DoNotOptimize(extension);
+    }
+    state.SetLabel(format == WireFormat::V1 ? "v1" : "legacy");
+}
+BENCHMARK(BM_WireFormatRoundTrip)->Arg(static_cast<int>(WireFormat::Legacy))->Arg(static_cast<int>(WireFormat::V1));
+
+// Previous client path: a fresh std::vector per sample, kept as a baseline
+static void BM_ClientEncodeToVector(benchmark::State& state) {
+    SpeedData data = {88.8f, 12345};
+    for (auto _ : state) {
+        std::vector<uint8_t> payload(SpeedSensor::payload_size);
+        encode_sensor_data<SpeedSensor>(data, payload.data());
+        benchmark::DoNotOptimize(payload.data());
+    }
+}
+BENCHMARK(BM_ClientEncodeToVector);
+
+// Payload construction the client performs per send (create_payload copy)
+static void BM_ClientCreatePayload(benchmark::State& state) {
+    uint8_t bytes[SpeedSensor::payload_size] = {};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(vsomeip::runtime::get()->create_payload(bytes, sizeof(bytes)));
+    }
+}
+BENCHMARK(BM_ClientCreatePayload);
+
+static void BM_ClientBatchEncode(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    SensorBatcher<SpeedSensor> batcher(count, std::chrono::milliseconds(1000));
+    auto now = std::chrono::steady_clock::now();
+    SpeedData data = {88.8f, 12345};
+    for (auto _ : state) {
+        for (size_t i = 0; i < count; ++i) batcher.add(data, now);
+        size_t length = 0;
+        benchmark::DoNotOptimize(batcher.finish(length));
+        batcher.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["bytes_per_sample"] = static_cast<double>(batch_payload_size(count)) / count;
+}
+BENCHMARK(BM_ClientBatchEncode)->Arg(1)->Arg(16)->Arg(64)->Arg(kMaxUdpBatchSamples);
+
+// ==================== HANDLER DISPATCH ====================
+
+// Full handler invocation through the dispatch table with a real message object
+template <typename S>
+static void BM_HandlerDispatch(benchmark::State& state) {
+    auto request = make_request(S::method_id, make_sample_payload(50.0f, 1));
+    for (auto _ : state) {
+        dispatch_sensor_message(request);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_HandlerDispatch, SpeedSensor);
+BENCHMARK_TEMPLATE(BM_HandlerDispatch, EngineTempSensor);
+BENCHMARK_TEMPLATE(BM_HandlerDispatch, AmbientTempSensor);
+
+// Direct call of the named handler, without the table lookup
+static void BM_HandlerDirect(benchmark::State& state) {
+    auto request = make_request(SpeedSensor::method_id, make_sample_payload(50.0f, 1));
+    for (auto _ : state) {
+        on_speed_message(request);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HandlerDirect);
+
+// ==================== BATCHED DECODE ====================
+
+static void BM_BatchHandler(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    auto request = make_request(kSensorBatchMethod, make_batch_payload<EngineTempSensor>(count));
+    for (auto _ : state) {
+        on_sensor_batch_message(request);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BatchHandler)->Arg(1)->Arg(16)->Arg(64)->Arg(kMaxUdpBatchSamples);
+
+static void BM_BatchDecodeRecords(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    auto bytes = make_batch_payload<SpeedSensor>(count);
+    for (auto _ : state) {
+        SensorBatchView batch;
+        decode_batch_header(PayloadView(bytes), batch);
+        float sum = 0.0f;
+        for (size_t i = 0; i < batch.count; ++i) {
+            sum += decode_batch_record<SpeedSensor>(batch, i).speed_kmh;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BatchDecodeRecords)->Arg(1)->Arg(16)->Arg(64)->Arg(kMaxUdpBatchSamples);
+
+// Column-wise decode with alarm bits and min/max/sum, one run per kernel and wire format
+static void BM_BatchDecodeColumns(benchmark::State& state) {
+    const BatchKernel kernel = static_cast<BatchKernel>(state.range(0));
+    const size_t count = static_cast<size_t>(state.range(1));
+    const WireFormat format = static_cast<WireFormat>(state.range(2));
+    if (!batch_kernel_supported(kernel)) {
+        state.SkipWithError("kernel not supported on this CPU");
+        return;
+    }
+    auto bytes = make_batch_payload<SpeedSensor>(count);
+    std::vector<float> values(count);
+    std::vector<uint32_t> timestamps(count);
+    std::vector<uint8_t> alarm_bits((count + 7) / 8);
+    const BatchColumns columns = {values.data(), timestamps.data(), alarm_bits.data()};
+    for (auto _ : state) {
+        BatchSummary summary;
+        decode_batch_columns_with(kernel, bytes.data() + kBatchHeaderSize, count, format,
+                                  SpeedSensor::alarm, SpeedSensor::alarm_limit, columns, summary);
+        benchmark::DoNotOptimize(summary);
+    }
+    state.SetLabel(std::string(batch_kernel_name(kernel)) + (format == WireFormat::V1 ? " v1" : " legacy"));
+    state.SetItemsProcessed(state.iterations() * count);
+}
+static void batch_decode_column_args(benchmark::internal::Benchmark* benchmark) {
+    for (BatchKernel kernel : {BatchKernel::Scalar, BatchKernel::Sse2, BatchKernel::Avx2}) {
+        for (int64_t count : {int64_t(16), int64_t(64), int64_t(kMaxUdpBatchSamples), int64_t(4096)}) {
+            for (WireFormat format : {WireFormat::Legacy, WireFormat::V1}) {
+                benchmark->Args({static_cast<int64_t>(kernel), count, static_cast<int64_t>(format)});
+            }
+        }
+    }
+}
+BENCHMARK(BM_BatchDecodeColumns)->Apply(batch_decode_column_args);
+
+// ==================== BULK SNAPSHOTS ====================
+
+// Gateway cost of a reassembled snapshot: one section per sensor, decoded in place
+static void BM_SnapshotHandler(benchmark::State& state) {
+    const size_t samples = static_cast<size_t>(state.range(0));
+    std::vector<uint8_t> bytes(kSnapshotHeaderSize + Sensors::size * snapshot_section_size(samples));
+    encode_snapshot_header(1, static_cast<uint16_t>(Sensors::size), bytes.data(), kCurrentWireFormat);
+    size_t offset = kSnapshotHeaderSize;
+    for_each_sensor(Sensors{}, [&](auto tag) {
+        using S = typename decltype(tag)::type;
+        encode_batch_header<S>(static_cast<uint16_t>(samples), bytes.data() + offset, kCurrentWireFormat);
+        for (size_t i = 0; i < samples; ++i) {
+            typename S::data_type data = {};
+            data.*S::value = static_cast<float>(i % 120);
+            data.timestamp = static_cast<uint32_t>(i);
+            encode_batch_record<S>(data, i, bytes.data() + offset, kCurrentWireFormat);
+        }
+        offset += snapshot_section_size(samples);
+    });
+    auto request = make_request(kSensorSnapshotMethod, bytes);
+    request->set_interface_version(interface_version_of(kCurrentWireFormat));
+    for (auto _ : state) {
+        on_sensor_snapshot_message(request);
+    }
+    state.SetItemsProcessed(state.iterations() * samples * Sensors::size);
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+BENCHMARK(BM_SnapshotHandler)->Arg(100)->Arg(1000)->Arg(10000);
+
+// ==================== ALERT RULES ====================
+
+// Cost per sample of the shipped rules; the value stays inside the bands, as
+// almost every sample does, so no edge is queued
+static void BM_AlertEvaluate(benchmark::State& state) {
+    AlertEngine engine;
+    std::string error;
+    engine.configure({AlertRule{EngineTempSensor::method_id, AlertCondition::Above, 100.0f, 2.0f, 0},
+                      AlertRule{EngineTempSensor::method_id, AlertCondition::RiseRate, 1.0f, 0.5f, 0}},
+                     error);
+    float value = 80.0f;
+    uint64_t now = 0;
+    for (auto _ : state) {
+        value = value > 90.0f ? 80.0f : value + 0.1f;
+        now += 1000000;
+        engine.evaluate(EngineTempSensor::method_id, 0x1234, 0x0001, value, now);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AlertEvaluate);
+
+// ==================== WINDOW STATISTICS ====================
+
+// Cost per sample must not grow with the history or window size
+static void BM_SensorHistoryAdd(benchmark::State& state) {
+    SensorHistory history(static_cast<size_t>(state.range(0)), {1000, 10000, 60000});
+    float value = 50.0f;
+    uint64_t now = 0;
+    for (auto _ : state) {
+        value = value > 100.0f ? 0.0f : value + 0.7f;
+        now += 1000000;
+        history.add(value, now);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SensorHistoryAdd)->Arg(1024)->Arg(16384)->Arg(65536);
+
+int main(int argc, char** argv) {
+    // Handler log lines would interleave with the benchmark report
+    console_log().set_enabled(false);
+    
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
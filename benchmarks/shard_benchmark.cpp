@@ -0,0 +1,456 @@
+// shard_benchmark.cpp - Gateway throughput versus number of shards on one host
+//
+// For every shard count, forks one central_gateway process hosting that many
+// gateway shards (one vsomeip application and dispatcher per instance, as
+// server --shards does) and a fixed set of vehicle_ecu processes. Each ECU
+// talks to the instance the consistent hash ring assigns it (with bounded
+// loads, as the client does) and sends acknowledged speed samples as fast as
+// its in-flight window allows, so the gateway, not the pacing, limits
+// throughput. Transports:
+//   local: the gateway hosts routing, ECUs reach their shard over UDS
+//   udp:   every process is its own routing manager, SD disabled, ECU k on
+//          127.0.0.(k+2) sends to its shard's port on 127.0.0.1
+// Reports completed messages/s, the speedup over the first shard count, how
+// evenly the shards were loaded, and gateway CPU time per message.
+#include <vsomeip/vsomeip.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "sensor_data.h"
+#include "async_log.h"
+#include "inflight_window.h"
+#include "process_cpu.h"
+#include "request_pool.h"
+#include "shard_ring.h"
+
+namespace {
+
+const vsomeip::service_t kService = 0x1234;
+const uint16_t kFirstPort = 30601;
+const size_t kMaxEcus = 64;
+
+struct ShardOptions {
+    std::vector<size_t> shards = {1, 2, 4};
+    size_t ecus = 16;
+    double duration_s = 3.0;
+    size_t window = 64;
+    std::string transport = "local";
+    bool csv = false;
+};
+
+bool parse_options(int argc, char** argv, ShardOptions& out, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        char* end = nullptr;
+        if (arg == "--shards") {
+            std::vector<size_t> shards;
+            std::stringstream in(value ? value : "");
+            std::string item;
+            while (std::getline(in, item, ',')) {
+                unsigned long count = std::strtoul(item.c_str(), &end, 10);
+                if (item.empty() || *end != '\0' || count == 0 || count > kMaxShards) {
+                    shards.clear();
+                    break;
+                }
+                shards.push_back(count);
+            }
+            if (shards.empty()) {
+                error = "--shards expects N[,N...] with 1 <= N <= " + std::to_string(kMaxShards);
+                return false;
+            }
+            out.shards = shards;
+            ++i;
+        } else if (arg == "--ecus") {
+            unsigned long ecus = value ? std::strtoul(value, &end, 10) : 0;
+            if (!value || *end != '\0' || ecus == 0 || ecus > kMaxEcus) {
+                error = "--ecus expects 1.." + std::to_string(kMaxEcus) + " ECU processes";
+                return false;
+            }
+            out.ecus = ecus;
+            ++i;
+        } else if (arg == "--duration") {
+            out.duration_s = value ? std::strtod(value, &end) : 0.0;
+            if (!value || *end != '\0' || !(out.duration_s > 0)) {
+                error = "--duration expects a positive number of seconds";
+                return false;
+            }
+            ++i;
+        } else if (arg == "--window") {
+            unsigned long window = value ? std::strtoul(value, &end, 10) : 0;
+            if (!value || *end != '\0' || window == 0) {
+                error = "--window expects a number of requests";
+                return false;
+            }
+            out.window = window;
+            ++i;
+        } else if (arg == "--transport") {
+            out.transport = value ? value : "";
+            if (out.transport != "local" && out.transport != "udp") {
+                error = "--transport expects local or udp";
+                return false;
+            }
+            ++i;
+        } else if (arg == "--csv") {
+            out.csv = true;
+        } else {
+            error = "unknown option " + arg;
+            return false;
+        }
+    }
+    return true;
+}
+
+void print_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --shards LIST   gateway shard counts to compare (default 1,2,4, max " << kMaxShards << ")\n"
+              << "  --ecus N        ECU processes, spread over the shards by consistent hashing (default 16)\n"
+              << "  --duration S    seconds of sending per shard count (default 3)\n"
+              << "  --window N      unanswered requests per ECU before it waits (default 64)\n"
+              << "  --transport T   local (UDS via the gateway's routing manager, default) or udp (loopback)\n"
+              << "  --csv           print CSV rows instead of a table\n";
+}
+
+// ==================== SHARED STATE ====================
+
+struct EcuResult {
+    uint16_t instance;
+    uint64_t completed;
+    uint64_t timeouts;
+    double elapsed_s;
+};
+
+// Lives in an anonymous shared mapping created before the processes fork
+struct SharedState {
+    std::atomic<unsigned> ready;   // ECUs that see their shard
+    std::atomic<bool> go;          // set by the parent once all are ready
+    EcuResult ecus[kMaxEcus];
+};
+
+SharedState* create_shared_state() {
+    void* memory = ::mmap(nullptr, sizeof(SharedState), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    return memory == MAP_FAILED ? nullptr : new (memory) SharedState();
+}
+
+// ==================== CONFIGURATION ====================
+
+std::string ecu_name(size_t ecu) {
+    return "vehicle_ecu_" + std::to_string(ecu);
+}
+
+std::string instance_hex(size_t shard) {
+    char text[8];
+    std::snprintf(text, sizeof(text), "0x%04X", shard_instance(shard));
+    return text;
+}
+
+// Service entries of all shards, each on its own pair of ports; remote ones name the gateway's address
+std::string shard_services(size_t shards, bool remote) {
+    std::string services;
+    for (size_t shard = 0; shard < shards; ++shard) {
+        const uint16_t port = static_cast<uint16_t>(kFirstPort + 2 * shard);
+        if (shard > 0) services += ", ";
+        services += "{ \"service\": \"0x1234\", \"instance\": \"" + instance_hex(shard) + "\", " +
+                    (remote ? "\"unicast\": \"127.0.0.1\", " : "") + "\"unreliable\": \"" + std::to_string(port) +
+                    "\", \"reliable\": { \"port\": \"" + std::to_string(port + 1) +
+                    "\", \"enable-magic-cookies\": \"false\" } }";
+    }
+    return services;
+}
+
+std::string write_config(const std::string& path, const std::string& unicast, const std::string& routing,
+                         const std::string& network, const std::string& services, size_t shards, size_t ecus) {
+    std::ofstream out(path);
+    out << "{\n"
+        << "  \"unicast\": \"" << unicast << "\",\n"
+        << "  \"network\": \"" << network << "\",\n"
+        << "  \"logging\": { \"level\": \"warning\", \"console\": \"true\" },\n"
+        << "  \"applications\": [ ";
+    for (size_t shard = 0; shard < shards; ++shard) {
+        char id[8];
+        std::snprintf(id, sizeof(id), "0x%04zX", 0x0127 + shard);
+        out << "{ \"name\": \"" << shard_application_name(shard) << "\", \"id\": \"" << id << "\" }, ";
+    }
+    for (size_t ecu = 0; ecu < ecus; ++ecu) {
+        char id[8];
+        std::snprintf(id, sizeof(id), "0x%04zX", 0x0200 + ecu);
+        out << (ecu > 0 ? ", " : "") << "{ \"name\": \"" << ecu_name(ecu) << "\", \"id\": \"" << id << "\" }";
+    }
+    out << " ],\n"
+        << "  \"services\": [ " << services << " ],\n"
+        << "  \"routing\": \"" << routing << "\",\n"
+        << "  \"service-discovery\": { \"enable\": \"false\" }\n"
+        << "}\n";
+    return path;
+}
+
+struct ShardConfig {
+    std::string gateway;
+    std::vector<std::string> ecus;
+};
+
+ShardConfig write_shard_config(const std::string& directory, const ShardOptions& options, size_t shards) {
+    const std::string network = "vsomeip-shards-" + std::to_string(::getpid());
+    const std::string prefix = directory + "/" + options.transport + "-" + std::to_string(shards);
+    ShardConfig config;
+    if (options.transport == "local") {
+        config.gateway = write_config(prefix + ".json", "127.0.0.1", shard_application_name(0), network,
+                                      shard_services(shards, false), shards, options.ecus);
+        config.ecus.assign(options.ecus, config.gateway);
+        return config;
+    }
+    config.gateway = write_config(prefix + "-gateway.json", "127.0.0.1", shard_application_name(0), network + "-gw",
+                                  shard_services(shards, false), shards, options.ecus);
+    for (size_t ecu = 0; ecu < options.ecus; ++ecu) {
+        config.ecus.push_back(write_config(prefix + "-ecu" + std::to_string(ecu) + ".json",
+                                           "127.0.0." + std::to_string(ecu + 2), ecu_name(ecu),
+                                           network + "-ecu" + std::to_string(ecu), shard_services(shards, true),
+                                           shards, options.ecus));
+    }
+    return config;
+}
+
+// ==================== GATEWAY PROCESS ====================
+
+std::vector<std::shared_ptr<vsomeip::application>> gateways;
+
+// The real gateway handlers on every shard, answering through the shard that received the request
+int run_gateway(const std::string& config, size_t shards) {
+    ::setenv("VSOMEIP_CONFIGURATION", config.c_str(), 1);
+    console_log().set_enabled(false);
+    for (size_t shard = 0; shard < shards; ++shard) {
+        gateways.push_back(vsomeip::runtime::get()->create_application(shard_application_name(shard)));
+        if (!gateways.back()->init()) return 1;
+    }
+    set_response_sink([](const std::shared_ptr<vsomeip::message> &response) {
+        gateways[response->get_instance() - kFirstShardInstance]->send(response);
+    });
+    for (size_t shard = 0; shard < shards; ++shard) {
+        for (auto method : Sensors::method_ids) {
+            gateways[shard]->register_message_handler(kService, shard_instance(shard), method,
+                                                      dispatch_sensor_message);
+        }
+        gateways[shard]->offer_service(kService, shard_instance(shard));
+    }
+    std::vector<std::thread> threads;
+    for (size_t shard = 1; shard < shards; ++shard) {
+        threads.emplace_back([shard]() { gateways[shard]->start(); });
+    }
+    gateways.front()->start();
+    for (size_t shard = 1; shard < shards; ++shard) gateways[shard]->stop();
+    for (auto& thread : threads) thread.join();
+    return 0;
+}
+
+// ==================== ECU PROCESS ====================
+
+std::shared_ptr<vsomeip::application> ecu_app;
+std::atomic<bool> service_available(false);
+std::atomic<bool> running(true);
+InFlightWindow* window = nullptr;
+
+// Closed loop of acknowledged speed samples to one shard, started by the parent's go
+int run_ecu(const ShardOptions& options, size_t ecu, uint16_t instance, const std::string& config,
+            SharedState* shared) {
+    ::setenv("VSOMEIP_CONFIGURATION", config.c_str(), 1);
+    console_log().set_enabled(false);
+    ecu_app = vsomeip::runtime::get()->create_application(ecu_name(ecu));
+    if (!ecu_app->init()) return 1;
+    InFlightWindow ecu_window(options.window, std::chrono::milliseconds(1000));
+    window = &ecu_window;
+    ecu_app->register_availability_handler(kService, instance,
+        [](vsomeip::service_t, vsomeip::instance_t, bool available) { service_available = available; });
+    ecu_app->register_message_handler(kService, instance, SpeedSensor::method_id,
+        [](const std::shared_ptr<vsomeip::message>& response) {
+            window->complete(response->get_session(), response->get_return_code() == vsomeip::return_code_e::E_OK);
+        });
+    ecu_app->request_service(kService, instance);
+    std::thread vsomeip_thread([]() { ecu_app->start(); });
+
+    typedef std::chrono::steady_clock clock;
+    auto wait_deadline = clock::now() + std::chrono::seconds(15);
+    while (!service_available && clock::now() < wait_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    int status = 1;
+    if (service_available) {
+        shared->ready.fetch_add(1);
+        while (!shared->go.load() && clock::now() < wait_deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    if (service_available && shared->go.load()) {
+        RequestPool pool(kService, instance, SpeedSensor::method_id, vsomeip::message_type_e::MT_REQUEST,
+                         interface_version_of(kCurrentWireFormat), false, options.window + 16,
+                         SpeedSensor::payload_size);
+        uint8_t bytes[SpeedSensor::payload_size];
+        SpeedData data = {88.0f, 0};
+        const auto start = clock::now();
+        const auto end = start + std::chrono::nanoseconds(static_cast<int64_t>(options.duration_s * 1e9));
+        while (clock::now() < end) {
+            ++data.timestamp;
+            encode_sensor_data<SpeedSensor>(data, bytes, kCurrentWireFormat);
+            auto request = pool.acquire(bytes, sizeof(bytes));
+            ecu_window.send(running, [&request]() {
+                ecu_app->send(request);
+                return request->get_session();
+            });
+        }
+        // Let the last responses arrive before the window goes away
+        auto drain_deadline = clock::now() + std::chrono::seconds(1);
+        while (ecu_window.in_flight() > 0 && clock::now() < drain_deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        shared->ecus[ecu] = EcuResult{instance, ecu_window.rtt().count(), ecu_window.timeouts(),
+                                      std::chrono::duration<double>(clock::now() - start).count()};
+        status = 0;
+    }
+    ecu_app->stop();
+    vsomeip_thread.join();
+    window = nullptr;
+    return status;
+}
+
+// Runs fn in a child process; the child never returns into the caller
+template <typename Function>
+pid_t spawn(Function fn) {
+    std::cout.flush();
+    pid_t pid = ::fork();
+    if (pid == 0) ::_exit(fn());
+    return pid;
+}
+
+struct ShardResult {
+    size_t shards;
+    double achieved_hz;
+    double min_shard_hz;   // least and most loaded shard
+    double max_shard_hz;
+    uint64_t timeouts;
+    double gateway_cpu_us;  // per completed message
+    double gateway_cores;   // gateway CPU seconds per wall second
+};
+
+void print_result(const ShardResult& r, double baseline_hz, size_t ecus, bool csv) {
+    char line[192];
+    const double speedup = baseline_hz > 0 ? r.achieved_hz / baseline_hz : 0.0;
+    if (csv) {
+        std::snprintf(line, sizeof(line), "%zu,%zu,%.0f,%.2f,%.0f,%.0f,%llu,%.2f,%.2f\n", r.shards, ecus,
+                      r.achieved_hz, speedup, r.min_shard_hz, r.max_shard_hz,
+                      static_cast<unsigned long long>(r.timeouts), r.gateway_cpu_us, r.gateway_cores);
+    } else {
+        std::snprintf(line, sizeof(line), "%6zu %5zu %12.0f %8.2fx %12.0f %12.0f %9llu %14.2f %9.2f\n", r.shards, ecus,
+                      r.achieved_hz, speedup, r.min_shard_hz, r.max_shard_hz,
+                      static_cast<unsigned long long>(r.timeouts), r.gateway_cpu_us, r.gateway_cores);
+    }
+    std::cout << line << std::flush;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ShardOptions options;
+    std::string error;
+    if (!parse_options(argc, argv, options, error)) {
+        std::cerr << "❌ " << error << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    char directory[] = "/tmp/vsomeip-shards-XXXXXX";
+    SharedState* shared = create_shared_state();
+    if (::mkdtemp(directory) == nullptr || shared == nullptr) {
+        std::cerr << "❌ cannot create a configuration directory or shared state" << std::endl;
+        return 1;
+    }
+
+    if (options.csv) {
+        std::cout << "shards,ecus,achieved_hz,speedup,min_shard_hz,max_shard_hz,timeouts,"
+                     "gateway_cpu_us_per_msg,gateway_cores\n";
+    } else {
+        std::cout << "Transport " << options.transport << ", " << options.ecus << " ECU processes, window "
+                  << options.window << ", " << std::thread::hardware_concurrency() << " CPUs\n"
+                  << "shards  ecus   achieved/s  speedup  min shard/s  max shard/s  timeouts gw cpu/msg(us)  gw cores\n";
+    }
+
+    int status = 0;
+    double baseline_hz = 0.0;
+    for (size_t shards : options.shards) {
+        ShardConfig config = write_shard_config(directory, options, shards);
+        std::vector<uint16_t> ecu_instance = ShardRing::of_shards(shards).assign(static_cast<uint32_t>(options.ecus));
+        shared->ready.store(0);
+        shared->go.store(false);
+        std::fill(std::begin(shared->ecus), std::end(shared->ecus), EcuResult{0, 0, 0, 0.0});
+
+        pid_t gateway_pid = spawn([&config, shards]() { return run_gateway(config.gateway, shards); });
+        // The gateway hosts the routing manager of the local transport
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::vector<pid_t> ecu_pids;
+        for (size_t ecu = 0; ecu < options.ecus; ++ecu) {
+            uint16_t instance = ecu_instance[ecu];
+            ecu_pids.push_back(spawn([&, ecu, instance]() {
+                return run_ecu(options, ecu, instance, config.ecus[ecu], shared);
+            }));
+        }
+
+        // All ECUs start together, so every shard is loaded for the whole run
+        auto ready_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(15);
+        while (shared->ready.load() < options.ecus && std::chrono::steady_clock::now() < ready_deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (shared->ready.load() < options.ecus) {
+            std::cerr << "❌ " << shards << " shard(s): only " << shared->ready.load() << " of " << options.ecus
+                      << " ECUs reached their gateway instance" << std::endl;
+            status = 1;
+        }
+        const double gateway_cpu_before = other_process_cpu_s(gateway_pid);
+        const auto start = std::chrono::steady_clock::now();
+        shared->go.store(true);
+        for (pid_t pid : ecu_pids) {
+            int ecu_status = 0;
+            ::waitpid(pid, &ecu_status, 0);
+            if (!WIFEXITED(ecu_status) || WEXITSTATUS(ecu_status) != 0) status = 1;
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double gateway_cpu = other_process_cpu_s(gateway_pid) - gateway_cpu_before;
+        ::kill(gateway_pid, SIGTERM);
+        ::waitpid(gateway_pid, nullptr, 0);
+
+        ShardResult result = {shards, 0.0, 0.0, 0.0, 0, 0.0, elapsed > 0 ? gateway_cpu / elapsed : 0.0};
+        std::vector<double> shard_hz(shards, 0.0);
+        uint64_t completed = 0;
+        for (size_t ecu = 0; ecu < options.ecus; ++ecu) {
+            const EcuResult& r = shared->ecus[ecu];
+            if (r.elapsed_s <= 0) continue;
+            result.achieved_hz += r.completed / r.elapsed_s;
+            shard_hz[r.instance - kFirstShardInstance] += r.completed / r.elapsed_s;
+            result.timeouts += r.timeouts;
+            completed += r.completed;
+        }
+        result.min_shard_hz = *std::min_element(shard_hz.begin(), shard_hz.end());
+        result.max_shard_hz = *std::max_element(shard_hz.begin(), shard_hz.end());
+        result.gateway_cpu_us = completed > 0 ? gateway_cpu * 1e6 / completed : 0.0;
+        if (baseline_hz == 0.0) baseline_hz = result.achieved_hz;
+        print_result(result, baseline_hz, options.ecus, options.csv);
+    }
+
+    ::munmap(shared, sizeof(SharedState));
+    std::string command = std::string("rm -rf ") + directory;
+    std::system(command.c_str());
+    return status;
+}
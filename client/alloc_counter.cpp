@@ -0,0 +1,51 @@
+#include "alloc_counter.h"
+#include <cstdlib>
+#include <new>
+
+#ifdef CLIENT_COUNT_ALLOCATIONS
+
+static thread_local uint64_t thread_allocations = 0;
+
+static void* counted_alloc(std::size_t size) {
+    ++thread_allocations;
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+// Over-aligned types (alignas above __STDCPP_DEFAULT_NEW_ALIGNMENT__) come through here
+static void* counted_aligned_alloc(std::size_t size, std::align_val_t alignment) {
+    ++thread_allocations;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    // aligned_alloc needs a size that is a multiple of the alignment
+    std::size_t rounded = ((size ? size : 1) + align - 1) / align * align;
+    if (void* ptr = std::aligned_alloc(align, rounded)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return counted_aligned_alloc(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return counted_aligned_alloc(size, alignment);
+}
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+uint64_t thread_allocation_count() { return thread_allocations; }
+bool allocation_counting_enabled() { return true; }
+
+#else
+
+uint64_t thread_allocation_count() { return 0; }
+bool allocation_counting_enabled() { return false; }
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstdint>
+
+// Heap allocations made by the calling thread so far. Counting is done by
+// replacing global operator new (aligned forms included) and is compiled in
+// with CLIENT_COUNT_ALLOCATIONS, on by default in the debug profile only;
+// otherwise this always returns 0.
+uint64_t thread_allocation_count();
+
+bool allocation_counting_enabled();
+
+#endif // ALLOC_COUNTER_H
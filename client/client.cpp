@@ -9,254 +9,651 @@
 #include <iomanip>
 #include <memory>
 #include <vector>
+#include <cstdio>
+#include <functional>
+#include <array>
+#include <csignal>
+#include <string>
+#include <tuple>
+#include "async_log.h"
+#include "sensor_registry.h"
+#include "sensor_batcher.h"
+#include "sensor_snapshot.h"
+#include "client_options.h"
+#include "request_pool.h"
+#include "alloc_counter.h"
+#include "latency_histogram.h"
+#include "inflight_window.h"
+#include "sensor_scheduler.h"
+#include "shard_ring.h"
 
 std::shared_ptr<vsomeip::application> app;
-std::atomic<bool> service_available(false);
+// Availability of every gateway shard; each sender waits for its own instance only
+std::atomic<bool> shard_available[kMaxShards];
 std::atomic<bool> running(true);
-std::mutex cout_mutex;
+ClientOptions options;
 
-// Optimized sensor data structures - one per sensor type
-struct SpeedData {
-    float speed_kmh;
-    uint32_t timestamp;
+// Random-walk simulator of one sensor signal. Every simulated signal owns
+// its own generator and value, so signals never share mutable state.
+template <typename S>
+class SensorSimulator {
+public:
+    SensorSimulator() : gen_(std::random_device{}()), value_(S::sim_initial) {}
+    
+    // Generate the next sample, simulating a realistic trend
+    typename S::data_type next() {
+        std::uniform_real_distribution<float> step(-S::sim_step, S::sim_step);
+        value_ += step(gen_);
+        value_ = std::max(S::sim_min, std::min(S::sim_max, value_));
+        
+        typename S::data_type data = {};
+        data.*S::value = value_;
+        data.timestamp = static_cast<uint32_t>(std::time(nullptr));
+        return data;
+    }
+    
+private:
+    std::mt19937 gen_;
+    float value_;
 };
 
-struct EngineTemperatureData {
-    float temperature_celsius;
-    uint32_t timestamp;
+bool instance_available(uint16_t instance) {
+    size_t shard = static_cast<size_t>(instance - kFirstShardInstance);
+    return shard < options.shards && shard_available[shard];
+}
+
+bool all_shards_available() {
+    for (size_t shard = 0; shard < options.shards; ++shard) {
+        if (!shard_available[shard]) return false;
+    }
+    return true;
+}
+
+// Service availability callback, per gateway shard
+void on_availability(vsomeip::service_t service, vsomeip::instance_t instance, bool available) {
+    size_t shard = static_cast<size_t>(instance - kFirstShardInstance);
+    if (service != 0x1234 || shard >= options.shards) return;
+    shard_available[shard] = available;
+    bool all_available = all_shards_available();
+    
+    if (options.shards > 1) {
+        char line[96];
+        std::snprintf(line, sizeof(line), "%s ECU Client: Central Gateway instance 0x%04X %s", available ? "🚗" : "⚠️ ",
+                      instance, available ? "ONLINE" : "OFFLINE");
+        console_log().write(line);
+    }
+    if (available && all_available) {
+        console_log().write("🚗 ECU Client: Central Gateway ONLINE. Starting sensors...");
+    } else if (!available && options.shards == 1) {
+        console_log().write("⚠️  ECU Client: Central Gateway OFFLINE.");
+    }
+}
+
+// Deferred formatter for the send log; runs on the log writer thread
+template <typename S>
+void format_sensor_sent(std::string& out, const void* args) {
+    char line[64];
+    std::snprintf(line, sizeof(line), "%s: %.1f%s [Method 0x%04X]",
+                  S::label, *static_cast<const float*>(args), S::unit, S::method_id);
+    out.append(line);
+}
+
+// Requests kept per pool; more than vsomeip ever holds in flight for one sensor
+const size_t kRequestPoolSize = 4;
+// Send statistics are logged every kStatsInterval sends per pool
+const uint64_t kStatsInterval = 100;
+
+struct SendStatsArgs {
+    uint64_t sends;
+    uint64_t allocations;
+    uint64_t overflows;
+    uint16_t method;
 };
 
-struct AmbientTemperatureData {
-    float temperature_celsius;
-    uint32_t timestamp;
+template <typename S>
+void format_send_stats(std::string& out, const void* raw) {
+    const SendStatsArgs& args = *static_cast<const SendStatsArgs*>(raw);
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "📈 %s [Method 0x%04X]: %llu sends, %.2f heap allocations/send, %llu pool overflows",
+                  S::label, args.method, static_cast<unsigned long long>(args.sends),
+                  args.sends ? static_cast<double>(args.allocations) / args.sends : 0.0,
+                  static_cast<unsigned long long>(args.overflows));
+    out.append(line);
+}
+
+// Message type of every sensor request, from --mode
+vsomeip::message_type_e request_type() {
+    return options.acknowledged ? vsomeip::message_type_e::MT_REQUEST
+                                : vsomeip::message_type_e::MT_REQUEST_NO_RETURN;
+}
+
+// In-flight windows of acknowledged mode: one per sensor method, then batches and snapshots
+const size_t kInflightWindows = Sensors::max_method - Sensors::min_method + 3;
+
+InFlightWindow* inflight_window(vsomeip::method_t method) {
+    static std::array<std::unique_ptr<InFlightWindow>, kInflightWindows> windows = []() {
+        std::array<std::unique_ptr<InFlightWindow>, kInflightWindows> created;
+        for (auto& window : created) window.reset(new InFlightWindow(options.window, options.ack_timeout));
+        return created;
+    }();
+    if (method == kSensorBatchMethod) return windows[kInflightWindows - 2].get();
+    if (method == kSensorSnapshotMethod) return windows[kInflightWindows - 1].get();
+    // Responses for any other method (e.g. below min_method) have no window
+    if (method < Sensors::min_method || method > Sensors::max_method) return nullptr;
+    return windows[method - Sensors::min_method].get();
+}
+
+// Response of an acknowledged request: completes its in-flight entry
+void on_response(const std::shared_ptr<vsomeip::message>& response) {
+    InFlightWindow* window = inflight_window(response->get_method());
+    if (window) {
+        window->complete(response->get_session(), response->get_return_code() == vsomeip::return_code_e::E_OK);
+    }
+}
+
+struct RttStatsArgs {
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t max;
+    uint64_t in_flight;
+    uint64_t timeouts;
+    uint64_t errors;
+    uint64_t stalls;
+    uint16_t method;
 };
 
-// Vehicle sensor simulator class with method-specific data
-class VehicleSensors {
-private:
-    std::random_device rd;
-    std::mt19937 gen;
-    std::uniform_real_distribution<> speed_dist;
-    std::uniform_real_distribution<> engine_temp_dist;
-    std::uniform_real_distribution<> ambient_temp_dist;
-    
-    // Variables to simulate realistic trends
-    float current_speed = 0.0f;
-    float current_engine_temp = 80.0f;
-    float current_ambient_temp = 20.0f;
-    
-public:
-    VehicleSensors() : gen(rd()), 
-                       speed_dist(-5.0, 5.0),      // Gradual speed variation
-                       engine_temp_dist(-2.0, 2.0), // Gradual temp variation
-                       ambient_temp_dist(-1.0, 1.0) {} // Slow ambient change
-    
-    // Generate speed sensor data only
-    SpeedData get_speed_data() {
-        current_speed += speed_dist(gen);
-        current_speed = std::max(0.0f, std::min(120.0f, current_speed));
-        
-        return {
-            current_speed,
-            static_cast<uint32_t>(std::time(nullptr))
-        };
+template <typename S>
+void format_rtt_stats(std::string& out, const void* raw) {
+    const RttStatsArgs& args = *static_cast<const RttStatsArgs*>(raw);
+    char line[192];
+    std::snprintf(line, sizeof(line),
+                  "⏱️ RTT %s [Method 0x%04X]: p50 %.1fus p99 %.1fus max %.1fus, in flight %llu, "
+                  "timeouts %llu, errors %llu, window full %llu",
+                  S::label, args.method, args.p50 / 1e3, args.p99 / 1e3, args.max / 1e3,
+                  static_cast<unsigned long long>(args.in_flight), static_cast<unsigned long long>(args.timeouts),
+                  static_cast<unsigned long long>(args.errors), static_cast<unsigned long long>(args.stalls));
+    out.append(line);
+}
+
+RttStatsArgs rtt_stats(vsomeip::method_t method) {
+    const InFlightWindow* window = inflight_window(method);
+    return RttStatsArgs{window->rtt().percentile(0.50), window->rtt().percentile(0.99), window->rtt().max(),
+                        window->in_flight(), window->timeouts(), window->errors(), window->stalls(), method};
+}
+
+// Sends bytes through a pooled request and accounts the allocations it cost.
+// In acknowledged mode the send waits for room in the method's in-flight window.
+template <typename S>
+void send_pooled(RequestPool& pool, const uint8_t* bytes, size_t length) {
+    uint64_t allocations_before = thread_allocation_count();
+    auto request = pool.acquire(bytes, length);
+    if (!options.acknowledged) {
+        app->send(request);
+    } else if (!inflight_window(pool.method())->send(running, [&request]() {
+                   app->send(request);
+                   return request->get_session();
+               })) {
+        return;
     }
+    pool.record_send(thread_allocation_count() - allocations_before);
     
-    // Generate engine temperature sensor data only
-    EngineTemperatureData get_engine_temp_data() {
-        current_engine_temp += engine_temp_dist(gen);
-        current_engine_temp = std::max(60.0f, std::min(110.0f, current_engine_temp));
-        
-        return {
-            current_engine_temp,
-            static_cast<uint32_t>(std::time(nullptr))
-        };
+    if (pool.sends() % kStatsInterval != 0) return;
+    if (allocation_counting_enabled()) {
+        console_log().post(format_send_stats<S>, SendStatsArgs{
+            pool.sends(), pool.allocations(), pool.overflows(), pool.method()});
     }
-    
-    // Generate ambient temperature sensor data only
-    AmbientTemperatureData get_ambient_temp_data() {
-        current_ambient_temp += ambient_temp_dist(gen);
-        current_ambient_temp = std::max(-20.0f, std::min(50.0f, current_ambient_temp));
-        
-        return {
-            current_ambient_temp,
-            static_cast<uint32_t>(std::time(nullptr))
-        };
+    if (options.acknowledged) {
+        console_log().post(format_rtt_stats<S>, rtt_stats(pool.method()));
     }
-};
+}
 
-// Specialized serialization functions for each sensor type
-std::vector<uint8_t> serialize_speed_data(const SpeedData& data) {
-    std::vector<uint8_t> payload;
-    payload.reserve(8); // 4 + 4 bytes
-    
-    // Speed (4 bytes)
-    auto speed_bytes = reinterpret_cast<const uint8_t*>(&data.speed_kmh);
-    payload.insert(payload.end(), speed_bytes, speed_bytes + 4);
-    
-    // Timestamp (4 bytes)
-    auto time_bytes = reinterpret_cast<const uint8_t*>(&data.timestamp);
-    payload.insert(payload.end(), time_bytes, time_bytes + 4);
+// Send function generated per sensor method; encodes straight into a stack buffer
+template <typename S>
+void send_sensor_data(RequestPool& pool, const typename S::data_type& data, uint32_t sequence, uint16_t stream) {
+    uint8_t bytes[extended_payload_size<S>()];
+    size_t length = S::payload_size;
+    encode_sensor_data<S>(data, bytes, options.wire_format);
+    if (options.latency) {
+        encode_sample_extension<S>(SampleExtension{sequence, monotonic_ns(), stream}, bytes, options.wire_format);
+        length = extended_payload_size<S>();
+    }
+    send_pooled<S>(pool, bytes, length);
     
-    return payload;
+    // Per-message lines would only overflow the log at load-generator rates
+    if (kLogPerMessage && !options.load) {
+        console_log().post(format_sensor_sent<S>, data.*S::value);
+    }
 }
 
-std::vector<uint8_t> serialize_engine_temp_data(const EngineTemperatureData& data) {
-    std::vector<uint8_t> payload;
-    payload.reserve(8); // 4 + 4 bytes
-    
-    // Temperature (4 bytes)
-    auto temp_bytes = reinterpret_cast<const uint8_t*>(&data.temperature_celsius);
-    payload.insert(payload.end(), temp_bytes, temp_bytes + 4);
-    
-    // Timestamp (4 bytes)
-    auto time_bytes = reinterpret_cast<const uint8_t*>(&data.timestamp);
-    payload.insert(payload.end(), time_bytes, time_bytes + 4);
-    
-    return payload;
+template <typename S>
+void format_batch_sent(std::string& out, const void* args) {
+    char line[80];
+    std::snprintf(line, sizeof(line), "📦 BATCH %s x%u [Method 0x%04X]",
+                  S::label, *static_cast<const unsigned*>(args), kSensorBatchMethod);
+    out.append(line);
 }
 
-std::vector<uint8_t> serialize_ambient_temp_data(const AmbientTemperatureData& data) {
-    std::vector<uint8_t> payload;
-    payload.reserve(8); // 4 + 4 bytes
+// Sends the accumulated samples as one batch request and starts a new batch
+template <typename S>
+void send_sensor_batch(RequestPool& pool, SensorBatcher<S>& batcher) {
+    if (batcher.size() == 0) return;
     
-    // Temperature (4 bytes)
-    auto temp_bytes = reinterpret_cast<const uint8_t*>(&data.temperature_celsius);
-    payload.insert(payload.end(), temp_bytes, temp_bytes + 4);
+    size_t length = 0;
+    const uint8_t* bytes = batcher.finish(length);
+    unsigned samples = static_cast<unsigned>(batcher.size());
     
-    // Timestamp (4 bytes)
-    auto time_bytes = reinterpret_cast<const uint8_t*>(&data.timestamp);
-    payload.insert(payload.end(), time_bytes, time_bytes + 4);
+    send_pooled<S>(pool, bytes, length);
+    batcher.reset();
     
-    return payload;
+    if (kLogPerMessage && !options.load) {
+        console_log().post(format_batch_sent<S>, samples);
+    }
 }
 
-// Service availability callback
-void on_availability(vsomeip::service_t service, vsomeip::instance_t instance, bool available) {
-    if (service == 0x1234 && instance == 0x0001) {
-        service_available = available;
-        std::lock_guard<std::mutex> lock(cout_mutex);
-        if (available) {
-            std::cout << "🚗 ECU Client: Central Gateway ONLINE. Starting sensors..." << std::endl;
-        } else {
-            std::cout << "⚠️  ECU Client: Central Gateway OFFLINE." << std::endl;
-        }
-    }
+// Latency sequence stream of a new sender: senders of one sensor are numbered in creation order
+template <typename S>
+uint16_t next_sequence_stream() {
+    static std::atomic<uint16_t> stream(0);
+    return stream.fetch_add(1, std::memory_order_relaxed);
 }
 
-// Specialized send functions for each sensor method
-void send_speed_data(const SpeedData& data) {
-    if (!service_available) return;
+// Per-signal send state: simulator, request pools and the batcher, all
+// addressed to the gateway instance serving the signal's ECU. Nothing is
+// sent while that instance is unavailable. send() never runs on two threads
+// at once; flush() comes from a timer task, so the batch is behind a mutex.
+template <typename S>
+class SensorSender {
+public:
+    explicit SensorSender(uint16_t instance)
+        : instance_(instance),
+          stream_(next_sequence_stream<S>()),
+          sequence_(0),
+          pool_(0x1234, instance, S::method_id, request_type(), interface_version_of(options.wire_format),
+                options.reliable_for(S::transport), kRequestPoolSize, extended_payload_size<S>()),
+          batch_pool_(0x1234, instance, kSensorBatchMethod, request_type(), interface_version_of(options.wire_format),
+                      options.reliable_for(S::transport), options.batch_samples ? kRequestPoolSize : 0,
+                      batch_payload_size(options.batch_samples)),
+          batcher_(options.batch_samples, std::chrono::milliseconds(options.batch_ms), options.wire_format) {}
+    
+    // Generates the next sample and sends it, directly or as part of a batch
+    void send() {
+        if (!instance_available(instance_)) return;
+        auto data = simulator_.next();
+        if (options.batch_samples == 0) {
+            send_sensor_data<S>(pool_, data, sequence_++, stream_);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        if (batcher_.add(data, std::chrono::steady_clock::now())) {
+            send_sensor_batch<S>(batch_pool_, batcher_);
+        }
+    }
     
-    auto payload_data = serialize_speed_data(data);
+    // Sends the batch once its oldest sample is batch_ms old, even if no
+    // further sample arrives; with force, sends whatever it holds
+    void flush(std::chrono::steady_clock::time_point now, bool force = false) {
+        if (options.batch_samples == 0 || !instance_available(instance_)) return;
+        std::lock_guard<std::mutex> lock(batch_mutex_);
+        if (force || batcher_.due(now)) {
+            send_sensor_batch<S>(batch_pool_, batcher_);
+        }
+    }
     
-    auto request = vsomeip::runtime::get()->create_request();
-    request->set_service(0x1234);
-    request->set_instance(0x0001);
-    request->set_method(0x0001);  // Speed method
-    request->set_payload(vsomeip::runtime::get()->create_payload(payload_data));
+private:
+    const uint16_t instance_;
+    // Latency sequence of this sender; send() is never concurrent, so no atomic
+    const uint16_t stream_;
+    uint32_t sequence_;
+    SensorSimulator<S> simulator_;
+    RequestPool pool_;
+    RequestPool batch_pool_;
+    std::mutex batch_mutex_;
+    SensorBatcher<S> batcher_;
+};
+
+// Flushes every sender's batch on a batch_ms timer, and once more at the end
+class BatchFlusher {
+public:
+    explicit BatchFlusher(SensorScheduler& scheduler) : scheduler_(scheduler) {}
+    
+    template <typename S>
+    void add(const std::string& name, const std::shared_ptr<SensorSender<S>>& sender) {
+        if (options.batch_samples == 0) return;
+        scheduler_.add(name + " ⏱", std::chrono::milliseconds(options.batch_ms),
+                       [sender]() { sender->flush(std::chrono::steady_clock::now()); });
+        finals_.push_back([sender]() { sender->flush(std::chrono::steady_clock::now(), true); });
+    }
     
-    app->send(request);
+    // Sends the partial batches left once the senders have stopped
+    void flush_all() {
+        for (auto& flush : finals_) flush();
+    }
     
-    std::lock_guard<std::mutex> lock(cout_mutex);
-    std::cout << std::fixed << std::setprecision(1);
-    std::cout << "🏃 SPEED: " << data.speed_kmh << " km/h [Method 0x0001]" << std::endl;
+private:
+    SensorScheduler& scheduler_;
+    std::vector<std::function<void()>> finals_;
+};
+
+// Label of the snapshot pool in the send and RTT statistics
+struct SnapshotStatsLabel {
+    static constexpr const char* label = "📸 SNAPSHOT";
+};
+
+struct SnapshotLogArgs {
+    uint32_t id;
+    uint32_t samples;
+    uint32_t bytes;
+};
+
+void format_snapshot_sent(std::string& out, const void* raw) {
+    const SnapshotLogArgs& args = *static_cast<const SnapshotLogArgs*>(raw);
+    char line[112];
+    std::snprintf(line, sizeof(line), "📸 SNAPSHOT #%u: %u samples x %zu sensors, %u bytes [Method 0x%04X]",
+                  args.id, args.samples, Sensors::size, args.bytes, kSensorSnapshotMethod);
+    out.append(line);
 }
 
-void send_engine_temp_data(const EngineTemperatureData& data) {
-    if (!service_available) return;
-    
-    auto payload_data = serialize_engine_temp_data(data);
-    
-    auto request = vsomeip::runtime::get()->create_request();
-    request->set_service(0x1234);
-    request->set_instance(0x0001);
-    request->set_method(0x0002);  // Engine temperature method
-    request->set_payload(vsomeip::runtime::get()->create_payload(payload_data));
+// Bulk snapshot of every sensor: options.snapshot_samples fresh samples per
+// sensor, one section each, sent as a single request that vsomeip splits
+// into SOME/IP-TP segments. Never used by two threads at once.
+template <typename List>
+class SnapshotSender;
+
+template <typename... S>
+class SnapshotSender<SensorList<S...>> {
+public:
+    explicit SnapshotSender(uint16_t instance)
+        : instance_(instance),
+          bytes_(kSnapshotHeaderSize + sizeof...(S) * snapshot_section_size(options.snapshot_samples)),
+          pool_(0x1234, instance, kSensorSnapshotMethod, request_type(), interface_version_of(options.wire_format),
+                false, kRequestPoolSize, bytes_.size()),
+          id_(0) {}
+    
+    size_t size() const { return bytes_.size(); }
+    
+    void send() {
+        if (!instance_available(instance_)) return;
+        encode_snapshot_header(id_, static_cast<uint16_t>(sizeof...(S)), bytes_.data(), options.wire_format);
+        size_t offset = kSnapshotHeaderSize;
+        (encode_section<S>(offset), ...);
+        send_pooled<SnapshotStatsLabel>(pool_, bytes_.data(), bytes_.size());
+        if (kLogPerMessage) {
+            console_log().post(format_snapshot_sent, SnapshotLogArgs{
+                id_, static_cast<uint32_t>(options.snapshot_samples), static_cast<uint32_t>(bytes_.size())});
+        }
+        ++id_;
+    }
     
-    app->send(request);
+private:
+    template <typename T>
+    void encode_section(size_t& offset) {
+        uint8_t* section = bytes_.data() + offset;
+        const uint16_t count = static_cast<uint16_t>(options.snapshot_samples);
+        encode_batch_header<T>(count, section, options.wire_format);
+        SensorSimulator<T>& simulator = std::get<SensorSimulator<T>>(simulators_);
+        for (uint16_t i = 0; i < count; ++i) {
+            encode_batch_record<T>(simulator.next(), i, section, options.wire_format);
+        }
+        offset += snapshot_section_size(count);
+    }
     
-    std::lock_guard<std::mutex> lock(cout_mutex);
-    std::cout << std::fixed << std::setprecision(1);
-    std::cout << "🔥 ENGINE: " << data.temperature_celsius << "°C [Method 0x0002]" << std::endl;
+    const uint16_t instance_;
+    std::vector<uint8_t> bytes_;
+    RequestPool pool_;
+    std::tuple<SensorSimulator<S>...> simulators_;
+    uint32_t id_;
+};
+
+// SIGUSR1 doubles and SIGUSR2 halves every sensor rate; applied by the control thread
+volatile std::sig_atomic_t rate_up_requests = 0;
+volatile std::sig_atomic_t rate_down_requests = 0;
+
+void on_rate_signal(int signal) {
+    if (signal == SIGUSR1) rate_up_requests = rate_up_requests + 1;
+    if (signal == SIGUSR2) rate_down_requests = rate_down_requests + 1;
 }
 
-void send_ambient_temp_data(const AmbientTemperatureData& data) {
-    if (!service_available) return;
-    
-    auto payload_data = serialize_ambient_temp_data(data);
-    
-    auto request = vsomeip::runtime::get()->create_request();
-    request->set_service(0x1234);
-    request->set_instance(0x0001);
-    request->set_method(0x0003);  // Ambient temperature method
-    request->set_payload(vsomeip::runtime::get()->create_payload(payload_data));
-    
-    app->send(request);
-    
-    std::lock_guard<std::mutex> lock(cout_mutex);
-    std::cout << std::fixed << std::setprecision(1);
-    std::cout << "🌡️ AMBIENT: " << data.temperature_celsius << "°C [Method 0x0003]" << std::endl;
+// Logs period, run count, skipped deadlines and start jitter of every scheduled signal
+void log_scheduler_stats(const SensorScheduler& scheduler) {
+    for (const auto& stats : scheduler.all_stats()) {
+        char line[192];
+        std::snprintf(line, sizeof(line),
+                      "⏲️ %s: period %.1fms, %llu runs, %llu skipped, jitter p50 %.1fus p99 %.1fus max %.1fus",
+                      stats.name.c_str(), stats.period.count() / 1e6, static_cast<unsigned long long>(stats.runs),
+                      static_cast<unsigned long long>(stats.skipped), stats.jitter_p50_ns / 1e3,
+                      stats.jitter_p99_ns / 1e3, stats.jitter_max_ns / 1e3);
+        console_log().write(line);
+    }
 }
 
-// Updated sensor threads using method-specific functions
-void speed_sensor_thread(VehicleSensors& sensors) {
+// Applies rate-change signals and logs scheduler statistics until running turns false
+void scheduler_control(SensorScheduler& scheduler) {
+    sig_atomic_t rate_up_seen = 0;
+    sig_atomic_t rate_down_seen = 0;
+    auto next_stats = std::chrono::steady_clock::now() + std::chrono::seconds(options.scheduler_stats_s);
     while (running) {
-        if (service_available) {
-            auto data = sensors.get_speed_data();
-            send_speed_data(data);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        for (; rate_up_seen != rate_up_requests; ++rate_up_seen) {
+            scheduler.scale_periods(0.5);
+            console_log().write("⏩ Sensor rates doubled");
+        }
+        for (; rate_down_seen != rate_down_requests; ++rate_down_seen) {
+            scheduler.scale_periods(2.0);
+            console_log().write("⏪ Sensor rates halved");
+        }
+        if (options.scheduler_stats_s > 0 && std::chrono::steady_clock::now() >= next_stats) {
+            log_scheduler_stats(scheduler);
+            next_stats += std::chrono::seconds(options.scheduler_stats_s);
         }
-        std::this_thread::sleep_for(std::chrono::seconds(2));  // 2 segundos - velocidade
     }
 }
 
-void engine_temp_sensor_thread(VehicleSensors& sensors) {
-    while (running) {
-        if (service_available) {
-            auto data = sensors.get_engine_temp_data();
-            send_engine_temp_data(data);
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(3));  // 3 segundos - temp motor
+// Deferred formatter for received events
+template <typename S>
+void format_sensor_event(std::string& out, const void* args) {
+    char line[96];
+    float value = *static_cast<const float*>(args);
+    std::snprintf(line, sizeof(line), "📡 EVENT %s: %.1f%s%s [Event 0x%04X]",
+                  S::label, value, S::unit, is_alarm<S>(value) ? S::alarm_text : "", sensor_event_id<S>());
+    out.append(line);
+}
+
+// Events carry the gateway's wire format in their interface version; unknown versions are skipped
+template <typename S>
+void on_sensor_event(const std::shared_ptr<vsomeip::message>& event) {
+    WireFormat format;
+    if (!wire_format_from_interface_version(event->get_interface_version(), format)) return;
+    typename S::data_type data = {};
+    if (decode_sensor_data<S>(PayloadView(*event->get_payload()), data, format)) {
+        console_log().post(format_sensor_event<S>, data.*S::value);
     }
 }
 
-void ambient_temp_sensor_thread(VehicleSensors& sensors) {
-    while (running) {
-        if (service_available) {
-            auto data = sensors.get_ambient_temp_data();
-            send_ambient_temp_data(data);
+// Monitor mode: one subscription per sensor eventgroup, no samples sent
+void subscribe_sensor_events() {
+    for_each_sensor(Sensors{}, [](auto tag) {
+        using S = typename decltype(tag)::type;
+        app->register_message_handler(0x1234, 0x0001, sensor_event_id<S>(), on_sensor_event<S>);
+        app->request_event(0x1234, 0x0001, sensor_event_id<S>(), {sensor_eventgroup<S>()},
+                           vsomeip::event_type_e::ET_FIELD, vsomeip::reliability_type_e::RT_UNRELIABLE);
+        app->subscribe(0x1234, 0x0001, sensor_eventgroup<S>());
+    });
+}
+
+// Gateway instance of every ECU: consistent hashing with bounded loads
+std::vector<uint16_t> assign_ecus(unsigned ecus) {
+    return ShardRing::of_shards(options.shards).assign(ecus);
+}
+
+// Logs how many ECUs were assigned to every gateway instance
+void log_shard_assignment(const std::vector<uint16_t>& ecu_instance) {
+    std::vector<unsigned> ecus_per_shard(options.shards, 0);
+    for (uint16_t instance : ecu_instance) ++ecus_per_shard[instance - kFirstShardInstance];
+    std::cout << "🧩 Shards: " << ecu_instance.size() << " ECU(s) over " << options.shards
+              << " gateway instances by consistent hash:";
+    for (size_t shard = 0; shard < options.shards; ++shard) {
+        char entry[32];
+        std::snprintf(entry, sizeof(entry), " 0x%04X×%u", shard_instance(shard), ecus_per_shard[shard]);
+        std::cout << entry;
+    }
+    std::cout << std::endl;
+}
+
+// Load-generator mode: paced streams per method, then a rate report
+int run_load_generator(const std::vector<uint16_t>& ecu_instance) {
+    std::thread vsomeip_thread([]() { app->start(); });
+    
+    auto wait_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (!all_shards_available() && std::chrono::steady_clock::now() < wait_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!all_shards_available()) {
+        std::cerr << "❌ Central Gateway not available, load test aborted" << std::endl;
+        app->stop();
+        vsomeip_thread.join();
+        return 1;
+    }
+    
+    // Shard of every ECU, looked up once instead of per message
+    std::vector<uint8_t> ecu_shard(ecu_instance.size());
+    for (size_t ecu = 0; ecu < ecu_shard.size(); ++ecu) {
+        ecu_shard[ecu] = static_cast<uint8_t>(ecu_instance[ecu] - kFirstShardInstance);
+    }
+    
+    LoadGenerator generator(options.load_profile);
+    SensorScheduler flush_scheduler(1);
+    BatchFlusher flusher(flush_scheduler);
+    for_each_sensor(Sensors{}, [&](auto tag) {
+        using S = typename decltype(tag)::type;
+        // Each stream runs on its own thread and owns its senders (one per shard) and simulators
+        std::vector<std::shared_ptr<SensorSender<S>>> senders;
+        for (size_t shard = 0; shard < options.shards; ++shard) {
+            senders.push_back(std::make_shared<SensorSender<S>>(shard_instance(shard)));
+            flusher.add(S::label, senders.back());
         }
-        std::this_thread::sleep_for(std::chrono::seconds(5));  // 5 segundos - temp ambiente
+        generator.add_stream({S::label, S::method_id, options.rate_for(S::method_id),
+                              [senders, ecu_shard](unsigned ecu) { senders[ecu_shard[ecu]]->send(); }});
+    });
+    
+    flush_scheduler.start();
+    auto results = generator.run(running);
+    flush_scheduler.stop();
+    flusher.flush_all();
+    console_log().flush();
+    LoadGenerator::report(results, std::cout);
+    if (options.acknowledged) {
+        for_each_sensor(Sensors{}, [](auto tag) {
+            using S = typename decltype(tag)::type;
+            std::string line;
+            RttStatsArgs args = rtt_stats(S::method_id);
+            format_rtt_stats<S>(line, &args);
+            std::cout << "   " << line << std::endl;
+        });
     }
+    
+    app->stop();
+    vsomeip_thread.join();
+    return 0;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    std::string error;
+    if (!parse_client_options(argc, argv, options, error)) {
+        std::cerr << "❌ " << error << std::endl;
+        print_client_usage(argv[0]);
+        return 1;
+    }
+    
     // Initialize vehicle ECU application
     app = vsomeip::runtime::get()->create_application("vehicle_ecu");
     app->init();
     
     std::cout << "🚗 Vehicle ECU: Multi-Method Sensor System..." << std::endl;
     std::cout << "📊 Methods: 0x0001(Speed), 0x0002(Engine), 0x0003(Ambient)" << std::endl;
+    if (!kLogPerMessage) {
+        std::cout << "🏎️  Perf build: per-message log lines compiled out" << std::endl;
+    }
+    if (options.batch_samples > 0) {
+        std::cout << "📦 Batching: " << options.batch_samples << " samples or " << options.batch_ms
+                  << "ms per request → Method 0x0010" << std::endl;
+    }
     
-    // Register service availability handler
-    app->register_availability_handler(0x1234, 0x0001, on_availability);
-    app->request_service(0x1234, 0x0001);
+    // Register service availability handlers, one per gateway shard
+    for (size_t shard = 0; shard < options.shards; ++shard) {
+        app->register_availability_handler(0x1234, shard_instance(shard), on_availability);
+        app->request_service(0x1234, shard_instance(shard));
+    }
     
-    VehicleSensors sensors;
+    if (options.acknowledged) {
+        for (size_t shard = 0; shard < options.shards; ++shard) {
+            for (auto method : Sensors::method_ids) {
+                app->register_message_handler(0x1234, shard_instance(shard), method, on_response);
+            }
+            app->register_message_handler(0x1234, shard_instance(shard), kSensorBatchMethod, on_response);
+            app->register_message_handler(0x1234, shard_instance(shard), kSensorSnapshotMethod, on_response);
+        }
+        std::cout << "✅ Acknowledged requests: window " << options.window << " per method, timeout "
+                  << options.ack_timeout.count() << "ms" << std::endl;
+    }
     
-    // Create threads for each sensor with different frequencies BEFORE app->start()
-    std::thread speed_thread(speed_sensor_thread, std::ref(sensors));
-    std::thread engine_temp_thread(engine_temp_sensor_thread, std::ref(sensors));
-    std::thread ambient_temp_thread(ambient_temp_sensor_thread, std::ref(sensors));
+    if (options.monitor) {
+        std::cout << "📡 Monitor: subscribing to sensor events" << std::endl;
+        subscribe_sensor_events();
+        app->start();
+        return 0;
+    }
     
-    // Main control thread
-    std::cout << "🔄 All sensor threads started with dedicated methods!" << std::endl;
-    std::cout << "   • Speed: 2s cycle → Method 0x0001" << std::endl;
-    std::cout << "   • Engine Temp: 3s cycle → Method 0x0002" << std::endl;
-    std::cout << "   • Ambient Temp: 5s cycle → Method 0x0003" << std::endl;
+    if (options.load) {
+        std::cout << "⚡ Load generator: " << options.load_profile.ecus << " ECU(s), burst "
+                  << options.load_profile.burst << ", " << options.load_profile.duration_s << "s" << std::endl;
+        std::vector<uint16_t> ecu_instance = assign_ecus(std::max(1u, options.load_profile.ecus));
+        if (options.shards > 1) log_shard_assignment(ecu_instance);
+        return run_load_generator(ecu_instance);
+    }
+    
+    // All signals run on the scheduler's threads, spread evenly over their period
+    SensorScheduler scheduler(options.scheduler_threads);
+    std::cout << "🔄 Sensor scheduler: " << options.signals << " signal(s) per sensor on "
+              << options.scheduler_threads << " thread(s)" << std::endl;
+    // Signal n of every sensor belongs to ECU n, which talks to one gateway shard
+    std::vector<uint16_t> ecu_instance = assign_ecus(options.signals);
+    if (options.shards > 1) log_shard_assignment(ecu_instance);
+    BatchFlusher flusher(scheduler);
+    for_each_sensor(Sensors{}, [&](auto tag) {
+        using S = typename decltype(tag)::type;
+        const std::chrono::nanoseconds period = std::chrono::milliseconds(S::period_ms);
+        for (unsigned signal = 0; signal < options.signals; ++signal) {
+            auto sender = std::make_shared<SensorSender<S>>(ecu_instance[signal]);
+            std::string name = S::label;
+            if (options.signals > 1) name += " #" + std::to_string(signal);
+            scheduler.add(name, period, [sender]() { sender->send(); }, period * signal / options.signals);
+            flusher.add(name, sender);
+        }
+        std::cout << "   • " << S::label << ": " << S::period_ms << "ms cycle → Method 0x"
+                  << std::hex << std::setw(4) << std::setfill('0') << S::method_id
+                  << std::dec << std::setfill(' ') << (options.reliable_for(S::transport) ? " (TCP)" : " (UDP)")
+                  << std::endl;
+    });
+    if (options.snapshot_ms > 0) {
+        auto snapshots = std::make_shared<SnapshotSender<Sensors>>(ecu_instance[0]);
+        scheduler.add("📸 SNAPSHOT", std::chrono::milliseconds(options.snapshot_ms), [snapshots]() {
+            snapshots->send();
+        });
+        std::cout << "   • 📸 SNAPSHOT: " << options.snapshot_samples << " samples per sensor ("
+                  << snapshots->size() << " bytes) every " << options.snapshot_ms
+                  << "ms → Method 0x0011 (SOME/IP-TP)" << std::endl;
+    }
+    std::signal(SIGUSR1, on_rate_signal);
+    std::signal(SIGUSR2, on_rate_signal);
+    scheduler.start();
+    std::thread control_thread(scheduler_control, std::ref(scheduler));
     
-    // Start vSomeIP (this blocks forever - threads run independently)
+    // Start vSomeIP (blocks until the application is stopped)
     app->start();
     
+    running = false;
+    control_thread.join();
+    scheduler.stop();
     return 0;
 }
@@ -0,0 +1,235 @@
+#include "client_options.h"
+#include "sensor_batch.h"
+#include "sensor_snapshot.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// Parses a non-negative integer option value
+static bool parse_count(const char* text, unsigned long& out) {
+    if (text == nullptr || *text == '\0' || *text == '-') return false;
+    char* end = nullptr;
+    out = std::strtoul(text, &end, 10);
+    return *end == '\0';
+}
+
+// Parses a strictly positive rate in messages per second
+static bool parse_rate(const char* text, double& out) {
+    if (text == nullptr || *text == '\0') return false;
+    char* end = nullptr;
+    out = std::strtod(text, &end);
+    return *end == '\0' && out > 0.0;
+}
+
+// Parses "HZ" (all methods) or "METHOD=HZ", METHOD in decimal or 0x hex
+static bool parse_rate_option(const char* text, ClientOptions& out) {
+    if (text == nullptr) return false;
+    const char* equals = std::strchr(text, '=');
+    if (equals == nullptr) return parse_rate(text, out.default_rate_hz);
+    
+    std::string method_text(text, equals);
+    char* end = nullptr;
+    unsigned long method = std::strtoul(method_text.c_str(), &end, 0);
+    double rate = 0.0;
+    if (method_text.empty() || *end != '\0' || method > 0xFFFF || !parse_rate(equals + 1, rate)) {
+        return false;
+    }
+    out.method_rate_hz[static_cast<uint16_t>(method)] = rate;
+    return true;
+}
+
+bool parse_client_options(int argc, char** argv, ClientOptions& out, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        unsigned long number = 0;
+        
+        if (arg == "--batch") {
+            if (!parse_count(value, number) || number > kMaxUdpBatchSamples) {
+                error = "--batch expects 0.." + std::to_string(kMaxUdpBatchSamples) + " samples";
+                return false;
+            }
+            out.batch_samples = number;
+            ++i;
+        } else if (arg == "--batch-ms") {
+            if (!parse_count(value, number) || number == 0) {
+                error = "--batch-ms expects a positive number of milliseconds";
+                return false;
+            }
+            out.batch_ms = static_cast<unsigned>(number);
+            ++i;
+        } else if (arg == "--latency") {
+            out.latency = true;
+        } else if (arg == "--wire-format") {
+            std::string format = value ? value : "";
+            if (format != "v1" && format != "legacy") {
+                error = "--wire-format expects v1 or legacy";
+                return false;
+            }
+            if (format == "v1") {
+                out.wire_format = WireFormat::V1;
+            } else {
+                out.wire_format = WireFormat::Legacy;
+            }
+            ++i;
+        } else if (arg == "--transport") {
+            std::string transport = value ? value : "";
+            if (transport == "mixed") {
+                out.transport = TransportProfile::Mixed;
+            } else if (transport == "udp") {
+                out.transport = TransportProfile::Udp;
+            } else if (transport == "tcp") {
+                out.transport = TransportProfile::Tcp;
+            } else {
+                error = "--transport expects mixed, udp or tcp";
+                return false;
+            }
+            ++i;
+        } else if (arg == "--mode") {
+            std::string mode = value ? value : "";
+            if (mode != "fire" && mode != "ack") {
+                error = "--mode expects fire or ack";
+                return false;
+            }
+            out.acknowledged = (mode == "ack");
+            ++i;
+        } else if (arg == "--window") {
+            if (!parse_count(value, number) || number == 0) {
+                error = "--window expects a positive number of requests";
+                return false;
+            }
+            out.window = number;
+            ++i;
+        } else if (arg == "--ack-timeout") {
+            if (!parse_count(value, number) || number == 0) {
+                error = "--ack-timeout expects a positive number of milliseconds";
+                return false;
+            }
+            out.ack_timeout = std::chrono::milliseconds(number);
+            ++i;
+        } else if (arg == "--signals") {
+            if (!parse_count(value, number) || number == 0 || number > 10000) {
+                error = "--signals expects 1..10000 signals per sensor";
+                return false;
+            }
+            out.signals = static_cast<unsigned>(number);
+            ++i;
+        } else if (arg == "--scheduler-threads") {
+            if (!parse_count(value, number) || number == 0 || number > 64) {
+                error = "--scheduler-threads expects 1..64 threads";
+                return false;
+            }
+            out.scheduler_threads = number;
+            ++i;
+        } else if (arg == "--scheduler-stats") {
+            if (!parse_count(value, number)) {
+                error = "--scheduler-stats expects a number of seconds (0 = off)";
+                return false;
+            }
+            out.scheduler_stats_s = static_cast<unsigned>(number);
+            ++i;
+        } else if (arg == "--snapshot-ms") {
+            if (!parse_count(value, number)) {
+                error = "--snapshot-ms expects a number of milliseconds (0 = off)";
+                return false;
+            }
+            out.snapshot_ms = static_cast<unsigned>(number);
+            ++i;
+        } else if (arg == "--snapshot-samples") {
+            const size_t max_samples = ((kMaxSnapshotSize - kSnapshotHeaderSize) / Sensors::size - kBatchHeaderSize) /
+                                       kBatchRecordSize;
+            if (!parse_count(value, number) || number == 0 || number > max_samples) {
+                error = "--snapshot-samples expects 1.." + std::to_string(max_samples) + " samples per sensor";
+                return false;
+            }
+            out.snapshot_samples = number;
+            ++i;
+        } else if (arg == "--shards") {
+            if (!parse_count(value, number) || number == 0 || number > kMaxShards) {
+                error = "--shards expects 1 to " + std::to_string(kMaxShards) + " gateway instances";
+                return false;
+            }
+            out.shards = number;
+            ++i;
+        } else if (arg == "--monitor") {
+            out.monitor = true;
+        } else if (arg == "--load") {
+            out.load = true;
+        } else if (arg == "--rate") {
+            if (!parse_rate_option(value, out)) {
+                error = "--rate expects HZ or METHOD=HZ";
+                return false;
+            }
+            ++i;
+        } else if (arg == "--ecus") {
+            if (!parse_count(value, number) || number == 0) {
+                error = "--ecus expects a positive number of ECUs";
+                return false;
+            }
+            out.load_profile.ecus = static_cast<unsigned>(number);
+            ++i;
+        } else if (arg == "--burst") {
+            if (!parse_count(value, number) || number == 0) {
+                error = "--burst expects a positive number of messages";
+                return false;
+            }
+            out.load_profile.burst = static_cast<unsigned>(number);
+            ++i;
+        } else if (arg == "--pattern") {
+            unsigned on_ms = 0, off_ms = 0;
+            if (value == nullptr || std::sscanf(value, "%u:%u", &on_ms, &off_ms) != 2 || on_ms == 0) {
+                error = "--pattern expects ON_MS:OFF_MS";
+                return false;
+            }
+            out.load_profile.on_ms = on_ms;
+            out.load_profile.off_ms = off_ms;
+            ++i;
+        } else if (arg == "--duration") {
+            double seconds = 0.0;
+            if (!parse_rate(value, seconds)) {
+                error = "--duration expects a positive number of seconds";
+                return false;
+            }
+            out.load_profile.duration_s = seconds;
+            ++i;
+        } else {
+            error = "unknown option " + arg;
+            return false;
+        }
+    }
+    return true;
+}
+
+void print_client_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --batch N       pack N samples per request on method 0x0010 (0 = off, max "
+              << kMaxUdpBatchSamples << ")\n"
+              << "  --batch-ms T    send a partial batch after T ms (default 1000)\n"
+              << "  --latency       add sequence number and send time for gateway latency stats\n"
+              << "  --wire-format v1|legacy  v1: big-endian payloads, version in the SOME/IP header (default)\n"
+              << "                  legacy: host byte order, for gateways that predate the versioned format\n"
+              << "  --transport mixed|udp|tcp  mixed: per sensor, TCP for critical ones (default)\n"
+              << "                  udp / tcp: every method over one transport\n"
+              << "  --mode fire|ack fire: MT_REQUEST_NO_RETURN, no response (default)\n"
+              << "                  ack: MT_REQUEST, gateway responds; RTT and in-flight tracking\n"
+              << "  --window N      ack mode: unanswered requests per method before sending blocks (default 32)\n"
+              << "  --ack-timeout T ack mode: a request unanswered after T ms is counted lost (default 1000)\n"
+              << "  --signals N     simulated signals per sensor type, spread over its period (default 1)\n"
+              << "  --scheduler-threads N  threads driving all signals (default 1)\n"
+              << "  --scheduler-stats S    log per-signal runs, skips and jitter every S s (default 10, 0 = off)\n"
+              << "                  kill -USR1 doubles and kill -USR2 halves every sensor rate at runtime\n"
+              << "  --snapshot-ms T send a bulk snapshot of all sensors every T ms on method 0x0011\n"
+              << "                  (SOME/IP-TP segmented; 0 = off, default)\n"
+              << "  --snapshot-samples N  samples per sensor in each snapshot (default 1000)\n"
+              << "  --shards N      spread ECUs over gateway instances 0x0001..N by consistent hashing (default 1);\n"
+              << "                  an ECU is one --signals index, or one --ecus ECU of the load generator\n"
+              << "  --monitor       subscribe to the gateway's sensor events and log them (sends nothing)\n"
+              << "Load generator:\n"
+              << "  --load                 paced high-rate traffic instead of the sensor scheduler\n"
+              << "  --rate [METHOD=]HZ     messages/s per ECU, for all or one method (default 1000)\n"
+              << "  --ecus N               simulated ECUs, each sending at the rate (default 1)\n"
+              << "  --burst N              messages sent back-to-back per deadline (default 1)\n"
+              << "  --pattern ON:OFF       send for ON ms then pause OFF ms (default continuous)\n"
+              << "  --duration S           run time in seconds, then report (default 10)\n";
+}
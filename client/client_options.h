@@ -0,0 +1,77 @@
+#ifndef CLIENT_OPTIONS_H
+#define CLIENT_OPTIONS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include "load_generator.h"
+#include "sensor_registry.h"
+#include "shard_ring.h"
+#include "wire_codec.h"
+
+// Transport of the sensor requests: per sensor descriptor (Mixed), or all
+// methods over one transport, to measure both profiles
+enum class TransportProfile { Mixed, Udp, Tcp };
+
+// Command-line options of the ECU client
+struct ClientOptions {
+    // Samples packed into one batch request; 0 sends one request per sample
+    size_t batch_samples = 0;
+    // A partial batch is sent once its oldest sample is this old
+    unsigned batch_ms = 1000;
+    // Append sequence number and steady_clock send time to single-sample payloads
+    bool latency = false;
+    // Payload byte order; legacy (host order) only for gateways that predate versioning
+    WireFormat wire_format = kCurrentWireFormat;
+    TransportProfile transport = TransportProfile::Mixed;
+
+    // Acknowledged requests (MT_REQUEST, gateway responds) instead of
+    // fire-and-forget MT_REQUEST_NO_RETURN; in-flight window per method
+    bool acknowledged = false;
+    size_t window = 32;
+    std::chrono::milliseconds ack_timeout{1000};
+
+    // Sensor scheduler: simulated signals per sensor type, threads driving
+    // them, and seconds between jitter statistics (0 = off)
+    unsigned signals = 1;
+    size_t scheduler_threads = 1;
+    unsigned scheduler_stats_s = 10;
+
+    // Bulk snapshots on method 0x0011: every snapshot_ms (0 = off), samples
+    // per sensor in each, sent as SOME/IP-TP segments
+    unsigned snapshot_ms = 0;
+    size_t snapshot_samples = 1000;
+
+    // Gateway instances (shards) to spread the ECUs over by consistent hashing.
+    // An ECU is a load-generator ECU, or one signal index across all sensors.
+    size_t shards = 1;
+
+    // Subscribe to the gateway's sensor events instead of sending samples
+    bool monitor = false;
+
+    // Load-generator mode: paced high-rate traffic instead of the sensor scheduler
+    bool load = false;
+    double default_rate_hz = 1000.0;           // per method and ECU
+    std::map<uint16_t, double> method_rate_hz; // per-method overrides
+    LoadProfile load_profile;
+
+    double rate_for(uint16_t method) const {
+        auto it = method_rate_hz.find(method);
+        return it != method_rate_hz.end() ? it->second : default_rate_hz;
+    }
+
+    // Whether requests of a sensor with the given descriptor transport go over TCP
+    bool reliable_for(Transport descriptor) const {
+        if (transport == TransportProfile::Mixed) return descriptor == Transport::Reliable;
+        return transport == TransportProfile::Tcp;
+    }
+};
+
+// Parses argv into out; on failure returns false and describes the problem in error
+bool parse_client_options(int argc, char** argv, ClientOptions& out, std::string& error);
+
+void print_client_usage(const char* program);
+
+#endif // CLIENT_OPTIONS_H
@@ -4,11 +4,30 @@ set -e
 # Ensure LD_LIBRARY_PATH includes the vSomeIP library location
 export LD_LIBRARY_PATH="/usr/local/lib:${LD_LIBRARY_PATH:-}"
 
-# Export VSOMEIP_LOG_LEVEL and configuration file
-export VSOMEIP_LOG_LEVEL=${VSOMEIP_LOG_LEVEL:-trace}
-export VSOMEIP_CONFIGURATION=/app/client-config.json
+# BUILD_PROFILE selects the build and the vsomeip logging that goes with it:
+#   debug: unoptimized, one line per message, trace logging to console and file
+#   perf:  -O3/LTO, per-message lines compiled out, vsomeip warnings only
+BUILD_PROFILE=${BUILD_PROFILE:-debug}
+mkdir -p build logs
+case "$BUILD_PROFILE" in
+    debug)
+        export VSOMEIP_LOG_LEVEL=${VSOMEIP_LOG_LEVEL:-trace}
+        export VSOMEIP_CONFIGURATION=/app/client-config.json
+        ;;
+    perf)
+        # Same configuration with the logging section of the perf profile
+        export VSOMEIP_LOG_LEVEL=${VSOMEIP_LOG_LEVEL:-warning}
+        export VSOMEIP_CONFIGURATION=/app/build/client-config-perf.json
+        jq -s '.[0] * .[1]' /app/client-config.json /common/vsomeip-logging-perf.json > "$VSOMEIP_CONFIGURATION"
+        ;;
+    *)
+        echo "Unknown BUILD_PROFILE '$BUILD_PROFILE' (expected debug or perf)"
+        exit 1
+        ;;
+esac
 
 echo "LD_LIBRARY_PATH is set to: $LD_LIBRARY_PATH"
+echo "BUILD_PROFILE is set to: $BUILD_PROFILE"
 echo "VSOMEIP_LOG_LEVEL is set to: $VSOMEIP_LOG_LEVEL"
 echo "Using VSOMEIP configuration file: $VSOMEIP_CONFIGURATION"
 
@@ -20,10 +39,10 @@ ldconfig -p | grep vsomeip || echo "Warning: vSomeIP libraries not found in ldco
 echo "Waiting for server to be ready..."
 sleep 10
 
-mkdir -p build logs
 cd build
-cmake ..
+cmake -DBUILD_PROFILE="$BUILD_PROFILE" ..
 make -j$(nproc)
 
 echo "Starting client..."
-exec /app/build/client > /app/logs/client.log 2>&1
+# CLIENT_ARGS selects client modes, e.g. "--batch 32 --batch-ms 500"
+exec /app/build/client ${CLIENT_ARGS:-} > /app/logs/client.log 2>&1
@@ -0,0 +1,106 @@
+#include "inflight_window.h"
+
+InFlightWindow::InFlightWindow(size_t capacity, std::chrono::milliseconds timeout)
+    : entries_(capacity ? capacity : 1, Entry{State::Free, 0, 0}),
+      early_(entries_.size(), EarlyResponse{false, false, 0, 0}), used_(0), reserved_(0),
+      timeout_ns_(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count())),
+      timeouts_(0), errors_(0), stalls_(0) {}
+
+bool InFlightWindow::wait_for_slot(std::unique_lock<std::mutex>& lock, const std::atomic<bool>& running) {
+    if (used_ < entries_.size()) return true;
+
+    stalls_.fetch_add(1, std::memory_order_relaxed);
+    while (used_ == entries_.size()) {
+        if (!running) return false;
+        expire(monotonic_ns());
+        if (used_ < entries_.size()) break;
+        slot_freed_.wait_for(lock, std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+size_t InFlightWindow::reserve() {
+    for (size_t slot = 0; slot < entries_.size(); ++slot) {
+        if (entries_[slot].state == State::Free) {
+            entries_[slot].state = State::Reserved;
+            ++used_;
+            ++reserved_;
+            return slot;
+        }
+    }
+    return 0;   // unreachable: wait_for_slot() guaranteed a free entry
+}
+
+void InFlightWindow::record(size_t slot, uint16_t session, uint64_t send_ns) {
+    bool freed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry& entry = entries_[slot];
+        entry = Entry{State::InFlight, session, send_ns};
+        --reserved_;
+        for (EarlyResponse& early : early_) {
+            if (early.used && early.session == session) {
+                early.used = false;
+                finish(entry, early.ok, early.receive_ns);
+                freed = true;
+                break;
+            }
+        }
+        // With no send pending, held responses can no longer match anything
+        if (reserved_ == 0) {
+            for (EarlyResponse& early : early_) early.used = false;
+        }
+    }
+    if (freed) slot_freed_.notify_one();
+}
+
+void InFlightWindow::finish(Entry& entry, bool ok, uint64_t receive_ns) {
+    rtt_.record(receive_ns > entry.send_ns ? receive_ns - entry.send_ns : 0);
+    entry.state = State::Free;
+    --used_;
+    if (!ok) errors_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void InFlightWindow::expire(uint64_t now_ns) {
+    // Reserved entries are still being sent and cannot time out yet
+    for (Entry& entry : entries_) {
+        if (entry.state == State::InFlight && now_ns - entry.send_ns >= timeout_ns_) {
+            entry.state = State::Free;
+            --used_;
+            timeouts_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool InFlightWindow::complete(uint16_t session, bool ok) {
+    uint64_t receive_ns = monotonic_ns();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry* match = nullptr;
+        for (Entry& entry : entries_) {
+            if (entry.state == State::InFlight && entry.session == session) {
+                match = &entry;
+                break;
+            }
+        }
+        if (match == nullptr) {
+            if (reserved_ == 0) return false;
+            // Possibly the response of a send that has not recorded its session yet
+            for (EarlyResponse& early : early_) {
+                if (!early.used) {
+                    early = EarlyResponse{true, ok, session, receive_ns};
+                    return true;
+                }
+            }
+            return false;
+        }
+        finish(*match, ok, receive_ns);
+    }
+    slot_freed_.notify_one();
+    return true;
+}
+
+size_t InFlightWindow::in_flight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return used_;
+}
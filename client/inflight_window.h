@@ -0,0 +1,98 @@
+#ifndef INFLIGHT_WINDOW_H
+#define INFLIGHT_WINDOW_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "latency_histogram.h"
+
+// Acknowledged requests of one method that still wait for their response,
+// keyed by SOME/IP session ID. The window is bounded: a sender waits while
+// it is full, so a slow gateway throttles the client instead of piling up
+// requests. Requests unanswered after the timeout are counted as lost and
+// free their slot. Round-trip times go into a latency histogram.
+// Entries live in a preallocated array, so tracking never allocates.
+class InFlightWindow {
+public:
+    InFlightWindow(size_t capacity, std::chrono::milliseconds timeout);
+
+    InFlightWindow(const InFlightWindow&) = delete;
+    InFlightWindow& operator=(const InFlightWindow&) = delete;
+
+    // Waits for a free slot and reserves it, then calls send(), which must
+    // send the request and return its session ID, and records the session.
+    // The window is not locked during send(), so senders of one method and
+    // the response handler never wait on each other's network call; a
+    // response that overtakes the bookkeeping is held until its session is
+    // recorded. Returns false without sending when running is cleared while
+    // waiting.
+    template <typename SendFunction>
+    bool send(const std::atomic<bool>& running, SendFunction send) {
+        size_t slot;
+        uint64_t send_ns;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!wait_for_slot(lock, running)) return false;
+            slot = reserve();
+            send_ns = monotonic_ns();
+        }
+        uint16_t session = send();
+        record(slot, session, send_ns);
+        return true;
+    }
+
+    // Matches a response; returns false for unknown or already expired
+    // sessions. While a send is between reserve and record, an unknown
+    // session is held as an early response instead.
+    bool complete(uint16_t session, bool ok);
+
+    size_t capacity() const { return entries_.size(); }
+    size_t in_flight() const;
+    const LatencyHistogram& rtt() const { return rtt_; }
+    uint64_t timeouts() const { return timeouts_.load(std::memory_order_relaxed); }
+    uint64_t errors() const { return errors_.load(std::memory_order_relaxed); }
+    // Sends that had to wait for a free slot
+    uint64_t stalls() const { return stalls_.load(std::memory_order_relaxed); }
+
+private:
+    enum class State : uint8_t { Free, Reserved, InFlight };
+
+    struct Entry {
+        State state;
+        uint16_t session;
+        uint64_t send_ns;
+    };
+
+    // Response that arrived before send() recorded its session
+    struct EarlyResponse {
+        bool used;
+        bool ok;
+        uint16_t session;
+        uint64_t receive_ns;
+    };
+
+    bool wait_for_slot(std::unique_lock<std::mutex>& lock, const std::atomic<bool>& running);
+    size_t reserve();
+    void record(size_t slot, uint16_t session, uint64_t send_ns);
+    // Frees an in-flight entry answered at receive_ns; call with the lock held
+    void finish(Entry& entry, bool ok, uint64_t receive_ns);
+    void expire(uint64_t now_ns);
+
+    mutable std::mutex mutex_;
+    std::condition_variable slot_freed_;
+    std::vector<Entry> entries_;
+    std::vector<EarlyResponse> early_;
+    size_t used_;        // reserved or in flight
+    size_t reserved_;    // sends between reserve() and record()
+    const uint64_t timeout_ns_;
+    LatencyHistogram rtt_;
+    std::atomic<uint64_t> timeouts_;
+    std::atomic<uint64_t> errors_;
+    std::atomic<uint64_t> stalls_;
+};
+
+#endif // INFLIGHT_WINDOW_H
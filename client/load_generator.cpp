@@ -0,0 +1,86 @@
+#include "load_generator.h"
+#include <algorithm>
+#include <cstdio>
+#include <ostream>
+#include <thread>
+
+LoadResult LoadGenerator::run_stream(const LoadStream& stream, const std::atomic<bool>& running) const {
+    typedef DeadlinePacer::clock clock;
+    const unsigned ecus = std::max(1u, profile_.ecus);
+    const unsigned burst = std::max(1u, profile_.burst);
+    const double messages_hz = stream.rate_hz * ecus;
+    const auto interval = DeadlinePacer::interval_for(messages_hz, burst);
+    const bool pulsed = profile_.on_ms > 0 && profile_.off_ms > 0;
+    const auto on = std::chrono::milliseconds(profile_.on_ms);
+    const auto cycle = std::chrono::milliseconds(profile_.on_ms + profile_.off_ms);
+
+    const auto start = clock::now();
+    const auto end = start + std::chrono::nanoseconds(static_cast<int64_t>(profile_.duration_s * 1e9));
+    DeadlinePacer pacer(interval, start);
+    auto cycle_start = start;
+    uint64_t sent = 0;
+    unsigned ecu = 0;
+
+    while (running && clock::now() < end) {
+        pacer.wait();
+        if (pulsed) {
+            auto now = clock::now();
+            if (now - cycle_start >= cycle) {
+                cycle_start += cycle * ((now - cycle_start) / cycle);
+            }
+            if (now - cycle_start >= on) {
+                // Off phase: resume at the start of the next on phase
+                cycle_start += cycle;
+                std::this_thread::sleep_until(std::min(cycle_start, end));
+                pacer.restart(cycle_start);
+                continue;
+            }
+        }
+        for (unsigned i = 0; i < burst; ++i) {
+            stream.send(ecu);
+            ecu = (ecu + 1) % ecus;
+        }
+        sent += burst;
+    }
+
+    double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    double duty = pulsed ? static_cast<double>(profile_.on_ms) / (profile_.on_ms + profile_.off_ms) : 1.0;
+    LoadResult result;
+    result.name = stream.name;
+    result.method = stream.method;
+    result.requested_hz = messages_hz * duty;
+    result.achieved_hz = elapsed > 0 ? sent / elapsed : 0.0;
+    result.sent = sent;
+    result.late_ticks = pacer.late_ticks();
+    result.skipped_ticks = pacer.skipped_ticks();
+    return result;
+}
+
+std::vector<LoadResult> LoadGenerator::run(const std::atomic<bool>& running) {
+    std::vector<LoadResult> results(streams_.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < streams_.size(); ++i) {
+        threads.emplace_back([this, i, &results, &running]() {
+            results[i] = run_stream(streams_[i], running);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    return results;
+}
+
+void LoadGenerator::report(const std::vector<LoadResult>& results, std::ostream& out) {
+    char line[160];
+    out << "📊 Load generator results:\n";
+    for (const auto& result : results) {
+        std::snprintf(line, sizeof(line),
+                      "   • %-12s [Method 0x%04X] requested %10.0f/s achieved %10.0f/s (%5.1f%%) "
+                      "sent %llu late %llu skipped %llu\n",
+                      result.name.c_str(), result.method, result.requested_hz, result.achieved_hz,
+                      result.requested_hz > 0 ? 100.0 * result.achieved_hz / result.requested_hz : 0.0,
+                      static_cast<unsigned long long>(result.sent),
+                      static_cast<unsigned long long>(result.late_ticks),
+                      static_cast<unsigned long long>(result.skipped_ticks));
+        out << line;
+    }
+    out.flush();
+}
@@ -0,0 +1,59 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "deadline_pacer.h"
+
+// Shape of the generated traffic, shared by all streams
+struct LoadProfile {
+    unsigned ecus = 1;            // simulated ECUs, each sending at the stream rate
+    unsigned burst = 1;           // messages sent back-to-back per deadline
+    unsigned on_ms = 0;           // burst pattern: send for on_ms ...
+    unsigned off_ms = 0;          // ... then pause for off_ms (0/0 = continuous)
+    double duration_s = 10.0;     // run time of the load test
+};
+
+// One paced message stream, typically one per SOME/IP method
+struct LoadStream {
+    std::string name;
+    uint16_t method;
+    double rate_hz;                          // per ECU, during the on phase
+    std::function<void(unsigned ecu)> send;  // called once per message
+};
+
+struct LoadResult {
+    std::string name;
+    uint16_t method;
+    double requested_hz;  // averaged over on/off phases and all ECUs
+    double achieved_hz;
+    uint64_t sent;
+    uint64_t late_ticks;
+    uint64_t skipped_ticks;
+};
+
+// Runs every stream on its own thread for the profile's duration
+class LoadGenerator {
+public:
+    explicit LoadGenerator(const LoadProfile& profile) : profile_(profile) {}
+
+    void add_stream(const LoadStream& stream) { streams_.push_back(stream); }
+
+    // Blocks until the duration elapsed or running turns false
+    std::vector<LoadResult> run(const std::atomic<bool>& running);
+
+    static void report(const std::vector<LoadResult>& results, std::ostream& out);
+
+private:
+    LoadResult run_stream(const LoadStream& stream, const std::atomic<bool>& running) const;
+
+    LoadProfile profile_;
+    std::vector<LoadStream> streams_;
+};
+
+#endif // LOAD_GENERATOR_H
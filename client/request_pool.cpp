@@ -0,0 +1,45 @@
+#include "request_pool.h"
+
+RequestPool::RequestPool(vsomeip::service_t service, vsomeip::instance_t instance, vsomeip::method_t method,
+                         vsomeip::message_type_e type, vsomeip::interface_version_t interface_version,
+                         bool reliable, size_t size, size_t payload_capacity)
+    : service_(service), instance_(instance), method_(method), type_(type), interface_version_(interface_version),
+      reliable_(reliable), next_(0),
+      sends_(0), allocations_(0), overflows_(0) {
+    slots_.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        Slot slot;
+        slot.request = create_request();
+        slot.payload = vsomeip::runtime::get()->create_payload();
+        slot.payload->set_capacity(static_cast<vsomeip::length_t>(payload_capacity));
+        slot.request->set_payload(slot.payload);
+        slots_.push_back(slot);
+    }
+}
+
+std::shared_ptr<vsomeip::message> RequestPool::create_request() const {
+    auto request = vsomeip::runtime::get()->create_request(reliable_);
+    request->set_service(service_);
+    request->set_instance(instance_);
+    request->set_method(method_);
+    request->set_message_type(type_);
+    request->set_interface_version(interface_version_);
+    return request;
+}
+
+std::shared_ptr<vsomeip::message> RequestPool::acquire(const uint8_t* bytes, size_t length) {
+    for (size_t tries = 0; tries < slots_.size(); ++tries) {
+        Slot& slot = slots_[next_];
+        next_ = (next_ + 1) % slots_.size();
+        // Only the pool (and the request, for the payload) still hold references
+        if (slot.request.use_count() == 1 && slot.payload.use_count() == 2) {
+            slot.payload->set_data(bytes, static_cast<vsomeip::length_t>(length));
+            return slot.request;
+        }
+    }
+    
+    ++overflows_;
+    auto request = create_request();
+    request->set_payload(vsomeip::runtime::get()->create_payload(bytes, static_cast<uint32_t>(length)));
+    return request;
+}
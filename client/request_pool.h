@@ -0,0 +1,60 @@
+#ifndef REQUEST_POOL_H
+#define REQUEST_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <vsomeip/vsomeip.hpp>
+
+// Fixed pool of preconfigured requests for one method. Service, instance,
+// method, interface version, transport and the payload object are set up once; each send only refills
+// the payload bytes in place. A slot is reused once vsomeip has dropped
+// its references to the message. Not thread-safe: one pool per sensor thread.
+class RequestPool {
+public:
+    // type is MT_REQUEST for acknowledged sends, MT_REQUEST_NO_RETURN for fire-and-forget;
+    // interface_version announces the payload's wire format (wire_codec.h);
+    // reliable sends over the service's TCP port instead of UDP
+    RequestPool(vsomeip::service_t service, vsomeip::instance_t instance, vsomeip::method_t method,
+                vsomeip::message_type_e type, vsomeip::interface_version_t interface_version,
+                bool reliable, size_t size, size_t payload_capacity);
+
+    // Returns a free request carrying bytes as its payload. Falls back to a
+    // fresh, unpooled request when every slot is still in flight.
+    std::shared_ptr<vsomeip::message> acquire(const uint8_t* bytes, size_t length);
+
+    // Accounts one completed send and the heap allocations it made
+    void record_send(uint64_t allocations) {
+        ++sends_;
+        allocations_ += allocations;
+    }
+
+    vsomeip::method_t method() const { return method_; }
+    bool reliable() const { return reliable_; }
+    uint64_t sends() const { return sends_; }
+    uint64_t allocations() const { return allocations_; }
+    uint64_t overflows() const { return overflows_; }
+
+private:
+    struct Slot {
+        std::shared_ptr<vsomeip::message> request;
+        std::shared_ptr<vsomeip::payload> payload;
+    };
+
+    std::shared_ptr<vsomeip::message> create_request() const;
+
+    const vsomeip::service_t service_;
+    const vsomeip::instance_t instance_;
+    const vsomeip::method_t method_;
+    const vsomeip::message_type_e type_;
+    const vsomeip::interface_version_t interface_version_;
+    const bool reliable_;
+    std::vector<Slot> slots_;
+    size_t next_;
+    uint64_t sends_;
+    uint64_t allocations_;
+    uint64_t overflows_;
+};
+
+#endif // REQUEST_POOL_H
@@ -0,0 +1,52 @@
+#ifndef SENSOR_BATCHER_H
+#define SENSOR_BATCHER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "sensor_batch.h"
+
+// Accumulates samples of one sensor into a packed batch payload.
+// The batch is due when it holds max_samples samples or its oldest
+// sample is older than max_delay.
+template <typename S>
+class SensorBatcher {
+public:
+    SensorBatcher(size_t max_samples, std::chrono::milliseconds max_delay, WireFormat format = WireFormat::Legacy)
+        : max_samples_(max_samples), max_delay_(max_delay), format_(format), count_(0),
+          buffer_(batch_payload_size(max_samples)) {}
+
+    // Appends a sample; returns true when the batch should be sent
+    bool add(const typename S::data_type& data, std::chrono::steady_clock::time_point now) {
+        if (count_ == 0) first_sample_ = now;
+        encode_batch_record<S>(data, count_, buffer_.data(), format_);
+        ++count_;
+        return due(now);
+    }
+
+    bool due(std::chrono::steady_clock::time_point now) const {
+        return count_ > 0 && (count_ >= max_samples_ || now - first_sample_ >= max_delay_);
+    }
+
+    size_t size() const { return count_; }
+
+    // Writes the header and returns the packed bytes of the current batch
+    const uint8_t* finish(size_t& length) {
+        encode_batch_header<S>(static_cast<uint16_t>(count_), buffer_.data(), format_);
+        length = batch_payload_size(count_);
+        return buffer_.data();
+    }
+
+    void reset() { count_ = 0; }
+
+private:
+    const size_t max_samples_;
+    const std::chrono::milliseconds max_delay_;
+    const WireFormat format_;
+    size_t count_;
+    std::chrono::steady_clock::time_point first_sample_;
+    std::vector<uint8_t> buffer_;
+};
+
+#endif // SENSOR_BATCHER_H
@@ -0,0 +1,152 @@
+#include "sensor_scheduler.h"
+#include <algorithm>
+
+SensorScheduler::SensorScheduler(size_t threads)
+    : thread_count_(std::max<size_t>(threads, 1)), running_(false) {}
+
+SensorScheduler::~SensorScheduler() {
+    stop();
+}
+
+size_t SensorScheduler::add(const std::string& name, std::chrono::nanoseconds period, Task task,
+                            std::chrono::nanoseconds offset) {
+    std::unique_ptr<Entry> entry(new Entry());
+    entry->name = name;
+    entry->task = task;
+    entry->period = std::max(period, std::chrono::nanoseconds(1));
+    entry->deadline = clock::now() + entry->period + offset;
+    entry->generation = 0;
+    entry->running = false;
+    entry->runs = 0;
+    entry->skipped = 0;
+    entry->jitter.reset(new LatencyHistogram());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back(std::move(entry));
+    size_t id = entries_.size() - 1;
+    schedule(id);
+    return id;
+}
+
+bool SensorScheduler::set_period(size_t id, std::chrono::nanoseconds period) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id >= entries_.size()) return false;
+    Entry& entry = *entries_[id];
+    period = std::max(period, std::chrono::nanoseconds(1));
+    if (!entry.running) {
+        // Re-queue under a new generation; the old heap entry is dropped when it surfaces
+        entry.deadline += period - entry.period;
+        entry.period = period;
+        ++entry.generation;
+        schedule(id);
+    } else {
+        // The worker running it re-queues with the new period when the task returns
+        entry.period = period;
+    }
+    return true;
+}
+
+void SensorScheduler::scale_periods(double factor) {
+    std::vector<std::pair<size_t, std::chrono::nanoseconds>> periods;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t id = 0; id < entries_.size(); ++id) {
+            periods.emplace_back(id, std::chrono::nanoseconds(
+                static_cast<int64_t>(entries_[id]->period.count() * factor)));
+        }
+    }
+    for (const auto& period : periods) set_period(period.first, period.second);
+}
+
+void SensorScheduler::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+    running_ = true;
+    for (size_t i = 0; i < thread_count_; ++i) {
+        threads_.emplace_back(&SensorScheduler::run_worker, this);
+    }
+}
+
+void SensorScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    changed_.notify_all();
+    for (auto& thread : threads_) thread.join();
+    threads_.clear();
+}
+
+size_t SensorScheduler::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+SensorScheduler::TaskStats SensorScheduler::stats(size_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_locked(id);
+}
+
+std::vector<SensorScheduler::TaskStats> SensorScheduler::all_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<TaskStats> result;
+    for (size_t id = 0; id < entries_.size(); ++id) result.push_back(stats_locked(id));
+    return result;
+}
+
+SensorScheduler::TaskStats SensorScheduler::stats_locked(size_t id) const {
+    const Entry& entry = *entries_.at(id);
+    return TaskStats{entry.name, entry.period, entry.runs, entry.skipped,
+                     entry.jitter->percentile(0.50), entry.jitter->percentile(0.99), entry.jitter->max()};
+}
+
+// Caller holds mutex_
+void SensorScheduler::schedule(size_t id) {
+    const Entry& entry = *entries_[id];
+    due_.push(Due{entry.deadline, id, entry.generation});
+    // Every idle worker may be sleeping until a later deadline
+    changed_.notify_all();
+}
+
+void SensorScheduler::run_worker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        if (due_.empty()) {
+            changed_.wait(lock);
+            continue;
+        }
+        const Due next = due_.top();
+        Entry& entry = *entries_[next.id];
+        if (next.generation != entry.generation) {
+            due_.pop();
+            continue;
+        }
+        const clock::time_point now = clock::now();
+        if (now < next.deadline) {
+            changed_.wait_until(lock, next.deadline);
+            continue;
+        }
+        due_.pop();
+
+        // Over a period late: drop the missed deadlines, keep the phase
+        std::chrono::nanoseconds late = now - entry.deadline;
+        if (late >= entry.period) {
+            int64_t missed = late / entry.period;
+            entry.skipped += static_cast<uint64_t>(missed);
+            entry.deadline += entry.period * missed;
+            late -= entry.period * missed;
+        }
+        entry.jitter->record(static_cast<uint64_t>(late.count()));
+        entry.running = true;
+
+        lock.unlock();
+        entry.task();
+        lock.lock();
+
+        entry.running = false;
+        ++entry.runs;
+        entry.deadline += entry.period;
+        ++entry.generation;
+        schedule(next.id);
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef SENSOR_SCHEDULER_H
+#define SENSOR_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#include "latency_histogram.h"
+
+// Drives any number of periodic tasks from a few threads. Pending runs sit
+// in one min-heap ordered by absolute deadline; a deadline is always the
+// previous deadline plus the period, never "now" plus the period, so tasks
+// do not drift. A task is out of the heap while it runs, so it never runs
+// on two threads at once and needs no locking of its own. A task that falls
+// more than one period behind skips the missed runs instead of bursting.
+// Periods can be changed while running; stale heap entries are discarded
+// lazily by generation number.
+class SensorScheduler {
+public:
+    typedef std::chrono::steady_clock clock;
+    typedef std::function<void()> Task;
+
+    struct TaskStats {
+        std::string name;
+        std::chrono::nanoseconds period;
+        uint64_t runs;
+        uint64_t skipped;          // deadlines dropped because the task was over a period late
+        uint64_t jitter_p50_ns;    // start time minus deadline
+        uint64_t jitter_p99_ns;
+        uint64_t jitter_max_ns;
+    };
+
+    explicit SensorScheduler(size_t threads = 1);
+    ~SensorScheduler();
+
+    SensorScheduler(const SensorScheduler&) = delete;
+    SensorScheduler& operator=(const SensorScheduler&) = delete;
+
+    // Adds a task first due one period from now (plus offset, to spread
+    // tasks of equal period); returns its id
+    size_t add(const std::string& name, std::chrono::nanoseconds period, Task task,
+               std::chrono::nanoseconds offset = std::chrono::nanoseconds(0));
+
+    // Changes the period; the next run is due one new period after the last deadline
+    bool set_period(size_t id, std::chrono::nanoseconds period);
+    // Multiplies every period by factor (2.0 halves the rates)
+    void scale_periods(double factor);
+
+    void start();
+    // Waits for running tasks to finish; pending runs are dropped
+    void stop();
+
+    size_t size() const;
+    TaskStats stats(size_t id) const;
+    std::vector<TaskStats> all_stats() const;
+
+private:
+    struct Entry {
+        std::string name;
+        Task task;
+        std::chrono::nanoseconds period;
+        clock::time_point deadline;
+        uint64_t generation;
+        bool running;
+        uint64_t runs;
+        uint64_t skipped;
+        std::unique_ptr<LatencyHistogram> jitter;
+    };
+
+    struct Due {
+        clock::time_point deadline;
+        size_t id;
+        uint64_t generation;
+        bool operator>(const Due& other) const { return deadline > other.deadline; }
+    };
+
+    void run_worker();
+    void schedule(size_t id);
+    TaskStats stats_locked(size_t id) const;
+
+    const size_t thread_count_;
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<std::unique_ptr<Entry>> entries_;
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> due_;
+    std::vector<std::thread> threads_;
+    bool running_;
+};
+
+#endif // SENSOR_SCHEDULER_H
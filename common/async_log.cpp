@@ -0,0 +1,103 @@
+#include "async_log.h"
+#include <chrono>
+
+namespace {
+
+// Maximum records formatted into one write
+const size_t kBatchSize = 256;
+// Writer sleep when the ring is empty; bounds the added latency per line
+const std::chrono::milliseconds kIdleInterval(2);
+
+void format_text(std::string& out, const void* args) {
+    out.append(static_cast<const char*>(args));
+}
+
+} // namespace
+
+AsyncLog::AsyncLog(std::ostream& out, size_t capacity)
+    : out_(out), queue_(capacity), posted_(0), written_(0), dropped_(0),
+      dropped_reported_(0), running_(true), enabled_(true) {
+    writer_ = std::thread(&AsyncLog::run, this);
+}
+
+AsyncLog::~AsyncLog() {
+    stop();
+}
+
+bool AsyncLog::write(const char* text) {
+    if (!enabled_.load(std::memory_order_relaxed)) return false;
+    LogRecord record;
+    record.format = format_text;
+    size_t length = std::strlen(text);
+    if (length > kLogArgBytes - 1) length = kLogArgBytes - 1;
+    std::memcpy(record.args, text, length);
+    record.args[length] = '\0';
+    record.length = static_cast<uint32_t>(length + 1);
+    return push(record);
+}
+
+bool AsyncLog::push(const LogRecord& record) {
+    if (!queue_.try_push(record)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    posted_.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+void AsyncLog::flush() {
+    uint64_t target = posted_.load(std::memory_order_acquire);
+    while (written_.load(std::memory_order_acquire) < target &&
+           running_.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+void AsyncLog::stop() {
+    if (!running_.exchange(false)) return;
+    if (writer_.joinable()) writer_.join();
+}
+
+size_t AsyncLog::drain(std::string& batch) {
+    LogRecord record;
+    size_t count = 0;
+    while (count < kBatchSize && queue_.try_pop(record)) {
+        record.format(batch, record.args);
+        batch.push_back('\n');
+        ++count;
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != dropped_reported_) {
+        batch.append("[log] ");
+        batch.append(std::to_string(dropped - dropped_reported_));
+        batch.append(" line(s) dropped, log buffer full\n");
+        dropped_reported_ = dropped;
+    }
+
+    if (!batch.empty()) {
+        out_.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+        out_.flush();
+        batch.clear();
+    }
+    written_.fetch_add(count, std::memory_order_release);
+    return count;
+}
+
+void AsyncLog::run() {
+    std::string batch;
+    batch.reserve(kBatchSize * 96);
+    while (running_.load(std::memory_order_relaxed)) {
+        if (drain(batch) == 0) {
+            std::this_thread::sleep_for(kIdleInterval);
+        }
+    }
+    // Final drain after stop() so no queued line is lost
+    while (drain(batch) > 0) {
+    }
+}
+
+AsyncLog& console_log() {
+    static AsyncLog log(std::cout);
+    return log;
+}
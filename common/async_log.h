@@ -0,0 +1,103 @@
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include "bounded_queue.h"
+
+// One console line per sample, batch or event costs more CPU than handling
+// the message at high rates. The perf build profile (build_profile.cmake)
+// compiles these lines out; startup lines, periodic statistics and errors
+// are always logged.
+#ifndef LOG_PER_MESSAGE
+#define LOG_PER_MESSAGE 1
+#endif
+constexpr bool kLogPerMessage = LOG_PER_MESSAGE != 0;
+
+// Deferred formatter: renders the binary arguments captured by post() into out
+typedef void (*LogFormatter)(std::string& out, const void* args);
+
+// Fixed-size record stored in the ring; text lines longer than
+// kLogArgBytes are truncated
+const size_t kLogArgBytes = 112;
+
+struct LogRecord {
+    LogFormatter format;
+    uint32_t length;
+    uint8_t args[kLogArgBytes];
+};
+
+// Asynchronous console sink. Producers (handlers, sensor threads) push
+// fixed-size records into a lock-free ring and return immediately; a
+// background writer formats them in batches and issues one write and one
+// flush per batch. When the ring is full the line is dropped and counted,
+// and the writer reports the number of dropped lines.
+class AsyncLog {
+public:
+    explicit AsyncLog(std::ostream& out = std::cout, size_t capacity = 8192);
+    ~AsyncLog();
+
+    AsyncLog(const AsyncLog&) = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+
+    // Queues a preformatted line (newline appended by the writer)
+    bool write(const char* text);
+
+    // Queues a binary record; fn formats args later on the writer thread
+    template <typename Args>
+    bool post(LogFormatter fn, const Args& args) {
+        static_assert(std::is_trivially_copyable<Args>::value, "log args must be trivially copyable");
+        static_assert(sizeof(Args) <= kLogArgBytes, "log args exceed record size");
+        if (!enabled_.load(std::memory_order_relaxed)) return false;
+        LogRecord record;
+        record.format = fn;
+        record.length = sizeof(Args);
+        std::memcpy(record.args, &args, sizeof(Args));
+        return push(record);
+    }
+
+    // Blocks until every record posted before the call has been written
+    void flush();
+
+    // Drains the ring and joins the writer thread
+    void stop();
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    // Records posted but not yet written
+    uint64_t pending() const {
+        // posted_ is bumped after the push, so the writer may already have
+        // counted a record that is not counted as posted yet: clamp at 0
+        uint64_t written = written_.load(std::memory_order_acquire);
+        uint64_t posted = posted_.load(std::memory_order_acquire);
+        return posted > written ? posted - written : 0;
+    }
+
+    // A disabled sink discards lines at the producer without counting them
+    void set_enabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+
+private:
+    bool push(const LogRecord& record);
+    void run();
+    size_t drain(std::string& batch);
+
+    std::ostream& out_;
+    BoundedQueue<LogRecord> queue_;
+    std::atomic<uint64_t> posted_;
+    std::atomic<uint64_t> written_;
+    std::atomic<uint64_t> dropped_;
+    uint64_t dropped_reported_;
+    std::atomic<bool> running_;
+    std::atomic<bool> enabled_;
+    std::thread writer_;
+};
+
+// Process-wide sink writing to std::cout
+AsyncLog& console_log();
+
+#endif // ASYNC_LOG_H
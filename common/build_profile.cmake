@@ -0,0 +1,34 @@
+# Build profiles shared by the server, client and benchmarks. Include with
+# NO_POLICY_SCOPE so the IPO policy applies to the including project.
+#   debug (default): -O0 -g, one console line per message
+#   perf:            -O3 with link-time optimization, per-message console lines
+#                    compiled out (LOG_PER_MESSAGE=0, see async_log.h)
+# The matching vsomeip logging is chosen at runtime by the entrypoints.
+
+if(POLICY CMP0069)
+    cmake_policy(SET CMP0069 NEW)
+endif()
+
+set(BUILD_PROFILE "debug" CACHE STRING "Build profile: debug or perf")
+set_property(CACHE BUILD_PROFILE PROPERTY STRINGS debug perf)
+
+include(CheckIPOSupported)
+check_ipo_supported(RESULT BUILD_PROFILE_LTO OUTPUT BUILD_PROFILE_LTO_ERROR)
+
+# Applies the compile options of profile to target, independent of CMAKE_BUILD_TYPE
+function(apply_build_profile target profile)
+    if(profile STREQUAL "perf")
+        target_compile_options(${target} PRIVATE -O3)
+        target_compile_definitions(${target} PRIVATE NDEBUG LOG_PER_MESSAGE=0)
+        if(BUILD_PROFILE_LTO)
+            set_property(TARGET ${target} PROPERTY INTERPROCEDURAL_OPTIMIZATION TRUE)
+        else()
+            message(WARNING "${target}: link-time optimization not supported: ${BUILD_PROFILE_LTO_ERROR}")
+        endif()
+    elseif(profile STREQUAL "debug")
+        target_compile_options(${target} PRIVATE -O0 -g)
+        target_compile_definitions(${target} PRIVATE LOG_PER_MESSAGE=1)
+    else()
+        message(FATAL_ERROR "Unknown build profile '${profile}' (expected debug or perf)")
+    endif()
+endfunction()
@@ -0,0 +1,92 @@
+#ifndef CAPTURE_FORMAT_H
+#define CAPTURE_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "payload_view.h"
+
+// On-disk format of the gateway's traffic recorder, host byte order.
+//
+// Segment file "capture-NNNNNN.seg":
+//   [CaptureSegmentHeader][record][record]...
+//   record = [CaptureRecordHeader][payload][zero padding to 8 bytes]
+// Index file "capture-NNNNNN.idx", written when the segment is closed:
+//   [CaptureIndexHeader][CaptureIndexEntry every kCaptureIndexStride records]
+// Records are 8-byte aligned, so a memory-mapped segment can be walked in place.
+
+const uint32_t kCaptureVersion = 1;
+const size_t kCaptureIndexStride = 1024;
+
+struct CaptureSegmentHeader {
+    char magic[8];               // "VSCAPSEG"
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t segment;            // sequence number of the segment in the capture
+    uint64_t first_receive_ns;   // 0 for an empty segment
+};
+
+struct CaptureRecordHeader {
+    uint64_t receive_ns;         // gateway monotonic clock
+    uint32_t record_size;        // header + payload + padding
+    uint32_t payload_length;
+    uint16_t service;
+    uint16_t instance;
+    uint16_t method;
+    uint16_t client;
+    uint16_t session;
+    uint8_t message_type;
+    uint8_t interface_version;   // payload wire format (wire_codec.h); 0 in older captures
+    uint8_t reliable;            // 1 if received over TCP; 0 in older captures
+    uint8_t reserved[3];
+};
+
+struct CaptureIndexHeader {
+    char magic[8];               // "VSCAPIDX"
+    uint32_t version;
+    uint32_t stride;             // records between two index entries
+    uint64_t records;            // records in the segment
+    uint64_t last_receive_ns;
+};
+
+struct CaptureIndexEntry {
+    uint64_t receive_ns;
+    uint64_t offset;             // byte offset of the record in the segment file
+    uint64_t record;             // record number within the segment
+};
+
+static_assert(sizeof(CaptureSegmentHeader) == 32, "segment header layout");
+static_assert(sizeof(CaptureRecordHeader) == 32, "record header layout");
+static_assert(sizeof(CaptureIndexHeader) == 32, "index header layout");
+static_assert(sizeof(CaptureIndexEntry) == 24, "index entry layout");
+
+inline size_t capture_record_size(size_t payload_length) {
+    return (sizeof(CaptureRecordHeader) + payload_length + 7) & ~size_t(7);
+}
+
+inline std::string capture_segment_path(const std::string& directory, uint64_t segment, const char* extension) {
+    char name[48];
+    std::snprintf(name, sizeof(name), "capture-%06llu.%s", static_cast<unsigned long long>(segment), extension);
+    return directory + "/" + name;
+}
+
+// Validates the segment header at the start of data
+inline bool decode_capture_segment_header(PayloadView data, CaptureSegmentHeader& out) {
+    if (!data.read(0, out)) return false;
+    return std::memcmp(out.magic, "VSCAPSEG", 8) == 0 && out.version == kCaptureVersion &&
+           out.header_size == sizeof(CaptureSegmentHeader);
+}
+
+// Reads the record at offset; payload views into data. Returns false at the
+// end of the segment or on a truncated record (e.g. a capture cut by a crash).
+inline bool decode_capture_record(PayloadView data, size_t offset, CaptureRecordHeader& header, PayloadView& payload) {
+    if (!data.read(offset, header)) return false;
+    if (header.record_size != capture_record_size(header.payload_length)) return false;
+    if (!data.contains(offset, header.record_size)) return false;
+    payload = data.slice(offset + sizeof(CaptureRecordHeader), header.payload_length);
+    return true;
+}
+
+#endif // CAPTURE_FORMAT_H
@@ -0,0 +1,35 @@
+#ifndef CLAIMED_TABLE_H
+#define CLAIMED_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free lookup in a fixed open-addressing table whose entries carry a
+// std::atomic<uint64_t> key member (0 = free). Keys are claimed with one CAS
+// on first use and never removed, so a probe sequence only ever grows and
+// readers need no lock. Callers must never use 0 as a key.
+
+// First slot probed for key: Fibonacci hashing of the key's top bits
+inline size_t claimed_home_slot(uint64_t key, size_t capacity) {
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 58) % capacity;
+}
+
+// Entry holding key, claiming a free one when claim is set; nullptr if absent or full
+template <typename Entry, size_t N>
+Entry* find_claimed(Entry (&entries)[N], uint64_t key, bool claim) {
+    size_t index = claimed_home_slot(key, N);
+    for (size_t probe = 0; probe < N; ++probe, index = (index + 1) % N) {
+        uint64_t current = entries[index].key.load(std::memory_order_acquire);
+        if (current == key) return &entries[index];
+        if (current != 0) continue;
+        if (!claim) return nullptr;
+        // Free slot: claim it, or use it if a concurrent writer claimed it for the same key
+        if (entries[index].key.compare_exchange_strong(current, key, std::memory_order_acq_rel) || current == key) {
+            return &entries[index];
+        }
+    }
+    return nullptr;
+}
+
+#endif // CLAIMED_TABLE_H
@@ -0,0 +1,77 @@
+#ifndef DEADLINE_PACER_H
+#define DEADLINE_PACER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+// Below this distance to a deadline, pacing spins instead of sleeping
+constexpr std::chrono::microseconds kPacingSpinThreshold{100};
+
+// Returns at deadline with microsecond precision: sleeps until shortly
+// before it, then spins the rest. Returns at once for a past deadline.
+inline void sleep_then_spin_until(std::chrono::steady_clock::time_point deadline) {
+    if (deadline - std::chrono::steady_clock::now() > kPacingSpinThreshold) {
+        std::this_thread::sleep_until(deadline - kPacingSpinThreshold);
+    }
+    while (std::chrono::steady_clock::now() < deadline) {
+    }
+}
+
+// Sleeps until absolute deadlines spaced by a fixed interval. Deadlines are
+// computed from the start time, never from "now", so pacing does not drift.
+// Each wait goes through sleep_then_spin_until().
+class DeadlinePacer {
+public:
+    typedef std::chrono::steady_clock clock;
+
+    // A stream this far behind schedule resynchronizes instead of catching up
+    static constexpr std::chrono::milliseconds kMaxBacklog{100};
+
+    // Intervals are at least 1 ns, so any positive rate paces (at clock speed)
+    DeadlinePacer(std::chrono::nanoseconds interval, clock::time_point start)
+        : interval_(std::max(interval, std::chrono::nanoseconds(1))), next_(start), late_ticks_(0), skipped_ticks_(0) {}
+
+    // Interval between deadlines that sends burst messages per deadline at
+    // messages_hz; rates beyond 1e9 * burst per second round up to 1 ns
+    static std::chrono::nanoseconds interval_for(double messages_hz, unsigned burst) {
+        const double interval_ns = 1e9 * std::max(1u, burst) / messages_hz;
+        if (!(interval_ns >= 1.0)) return std::chrono::nanoseconds(1);
+        return std::chrono::nanoseconds(static_cast<int64_t>(std::min(interval_ns, 1e18)));
+    }
+
+    // Blocks until the next deadline; returns how late the caller already was
+    std::chrono::nanoseconds wait() {
+        auto now = clock::now();
+        std::chrono::nanoseconds lateness(0);
+        if (now < next_) {
+            sleep_then_spin_until(next_);
+        } else {
+            lateness = now - next_;
+            if (lateness > interval_) ++late_ticks_;
+            if (lateness > kMaxBacklog) {
+                // Drop the backlog rather than bursting to catch up
+                skipped_ticks_ += static_cast<uint64_t>(lateness / interval_);
+                next_ = now;
+            }
+        }
+        next_ += interval_;
+        return lateness;
+    }
+
+    // Moves the schedule so the next deadline is at start
+    void restart(clock::time_point start) { next_ = start; }
+
+    std::chrono::nanoseconds interval() const { return interval_; }
+    uint64_t late_ticks() const { return late_ticks_; }
+    uint64_t skipped_ticks() const { return skipped_ticks_; }
+
+private:
+    const std::chrono::nanoseconds interval_;
+    clock::time_point next_;
+    uint64_t late_ticks_;
+    uint64_t skipped_ticks_;
+};
+
+#endif // DEADLINE_PACER_H
@@ -0,0 +1,108 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// steady_clock in nanoseconds. CLOCK_MONOTONIC is shared by every process
+// (and container) on one host, so client and gateway stamps are comparable.
+inline uint64_t monotonic_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// HDR-style log-linear histogram of nanosecond values. Every power of two
+// is split into 32 linear sub-buckets, so any recorded value is reported
+// within ~3% while the whole 1 ns .. 18 min range fits in 1152 counters.
+// record() is wait-free and may run concurrently with readers.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 5;
+    static constexpr unsigned kMaxMagnitude = 40;
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    static constexpr size_t kBuckets = kSubBuckets + (kMaxMagnitude - kSubBucketBits) * kSubBuckets;
+    static constexpr uint64_t kMaxValue = (uint64_t(1) << kMaxMagnitude) - 1;
+
+    LatencyHistogram() { reset(); }
+
+    void record(uint64_t value) {
+        if (value > kMaxValue) value = kMaxValue;
+        counts_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+        total_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        uint64_t seen = max_.load(std::memory_order_relaxed);
+        while (value > seen && !max_.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return total_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const {
+        uint64_t n = count();
+        return n ? static_cast<double>(sum_.load(std::memory_order_relaxed)) / n : 0.0;
+    }
+
+    // Upper bound of the bucket holding the q-quantile (0 < q <= 1); 0 if empty
+    uint64_t percentile(double q) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * n + 0.5);
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                uint64_t upper = bucket_upper(i);
+                uint64_t highest = max();
+                return upper < highest ? upper : highest;
+            }
+        }
+        return max();
+    }
+
+    void reset() {
+        for (size_t i = 0; i < kBuckets; ++i) counts_[i].store(0, std::memory_order_relaxed);
+        total_.store(0, std::memory_order_relaxed);
+        sum_.store(0, std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    // Adds other's counts into this histogram
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < kBuckets; ++i) {
+            counts_[i].fetch_add(other.counts_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        total_.fetch_add(other.count(), std::memory_order_relaxed);
+        sum_.fetch_add(other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        uint64_t other_max = other.max();
+        uint64_t seen = max_.load(std::memory_order_relaxed);
+        while (other_max > seen && !max_.compare_exchange_weak(seen, other_max, std::memory_order_relaxed)) {
+        }
+    }
+
+    static size_t bucket_index(uint64_t value) {
+        if (value < kSubBuckets) return static_cast<size_t>(value);
+        unsigned magnitude = 63 - static_cast<unsigned>(__builtin_clzll(value));
+        unsigned shift = magnitude - kSubBucketBits;
+        size_t mantissa = static_cast<size_t>(value >> shift);  // in [32, 64)
+        return kSubBuckets + shift * kSubBuckets + (mantissa - kSubBuckets);
+    }
+
+    // Largest value that falls into bucket index
+    static uint64_t bucket_upper(size_t index) {
+        if (index < kSubBuckets) return index;
+        size_t shift = (index - kSubBuckets) / kSubBuckets;
+        uint64_t mantissa = kSubBuckets + (index - kSubBuckets) % kSubBuckets;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+private:
+    std::atomic<uint64_t> counts_[kBuckets];
+    std::atomic<uint64_t> total_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+};
+
+#endif // LATENCY_HISTOGRAM_H
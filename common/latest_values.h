@@ -0,0 +1,73 @@
+#ifndef LATEST_VALUES_H
+#define LATEST_VALUES_H
+
+#include <cstddef>
+#include <cstdint>
+#include "payload_view.h"
+#include "wire_codec.h"
+
+// Request/response method returning the most recent sample of every sensor
+// of the addressed service instance. An empty request asks for all sensors;
+// otherwise the request carries a list of u16 method IDs to return.
+// Response layout: [count u16][reserved u16][count x record]
+// Record layout:   [method u16][flags u16][value float][timestamp u32][age_ms u32]
+// Requests and responses are in the byte order of their message's wire format
+// (wire_codec.h); the gateway answers in kCurrentWireFormat.
+const uint16_t kLatestValuesMethod = 0x0020;
+const size_t kLatestHeaderSize = 4;
+const size_t kLatestRecordSize = 16;
+
+// Record flags
+const uint16_t kLatestFlagAlarm = 0x0001;
+
+struct LatestValueRecord {
+    uint16_t method;
+    uint16_t flags;
+    float value;
+    uint32_t timestamp;
+    uint32_t age_ms;     // time since the gateway received the sample
+};
+
+inline size_t latest_values_payload_size(size_t count) {
+    return kLatestHeaderSize + count * kLatestRecordSize;
+}
+
+inline void encode_latest_header(uint16_t count, uint8_t* out, WireFormat format = WireFormat::Legacy) {
+    store_wire(format, out, count);
+    store_wire(format, out + 2, uint16_t(0));
+}
+
+inline void encode_latest_record(const LatestValueRecord& record, size_t index, uint8_t* out,
+                                 WireFormat format = WireFormat::Legacy) {
+    uint8_t* at = out + kLatestHeaderSize + index * kLatestRecordSize;
+    store_wire(format, at, record.method);
+    store_wire(format, at + 2, record.flags);
+    store_wire(format, at + 4, record.value);
+    store_wire(format, at + 8, record.timestamp);
+    store_wire(format, at + 12, record.age_ms);
+}
+
+// Validates that the header and all count records are present
+inline bool decode_latest_header(PayloadView payload, uint16_t& count, WireFormat format = WireFormat::Legacy) {
+    if (!payload.contains(0, kLatestHeaderSize)) return false;
+    const uint16_t value = load_wire<uint16_t>(format, payload.data());
+    if (!payload.contains(kLatestHeaderSize, static_cast<size_t>(value) * kLatestRecordSize)) return false;
+    count = value;
+    return true;
+}
+
+// Reads record index of a validated response
+inline LatestValueRecord decode_latest_record(PayloadView payload, size_t index, WireFormat format = WireFormat::Legacy) {
+    LatestValueRecord record = {};
+    const size_t offset = kLatestHeaderSize + index * kLatestRecordSize;
+    if (!payload.contains(offset, kLatestRecordSize)) return record;
+    const uint8_t* at = payload.data() + offset;
+    record.method = load_wire<uint16_t>(format, at);
+    record.flags = load_wire<uint16_t>(format, at + 2);
+    record.value = load_wire<float>(format, at + 4);
+    record.timestamp = load_wire<uint32_t>(format, at + 8);
+    record.age_ms = load_wire<uint32_t>(format, at + 12);
+    return record;
+}
+
+#endif // LATEST_VALUES_H
@@ -0,0 +1,48 @@
+#ifndef PAYLOAD_VIEW_H
+#define PAYLOAD_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <vsomeip/vsomeip.hpp>
+
+// Non-owning, bounds-checked view over a received payload buffer.
+// Lets handlers decode straight from payload->get_data() without copying.
+class PayloadView {
+public:
+    PayloadView() : data_(nullptr), length_(0) {}
+    PayloadView(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+    explicit PayloadView(const std::vector<uint8_t>& bytes)
+        : data_(bytes.data()), length_(bytes.size()) {}
+    explicit PayloadView(const vsomeip::payload& payload)
+        : data_(payload.get_data()), length_(payload.get_length()) {}
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return length_; }
+
+    // True if [offset, offset + count) lies inside the view
+    bool contains(size_t offset, size_t count) const {
+        return offset <= length_ && count <= length_ - offset;
+    }
+
+    // Copies sizeof(T) bytes at offset into out; returns false if out of bounds
+    template <typename T>
+    bool read(size_t offset, T& out) const {
+        if (!contains(offset, sizeof(T))) return false;
+        std::memcpy(&out, data_ + offset, sizeof(T));
+        return true;
+    }
+
+    // Sub-view of count bytes at offset; empty if out of bounds
+    PayloadView slice(size_t offset, size_t count) const {
+        if (!contains(offset, count)) return PayloadView();
+        return PayloadView(data_ + offset, count);
+    }
+
+private:
+    const uint8_t* data_;
+    size_t length_;
+};
+
+#endif // PAYLOAD_VIEW_H
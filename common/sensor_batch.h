@@ -0,0 +1,72 @@
+#ifndef SENSOR_BATCH_H
+#define SENSOR_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "payload_view.h"
+#include "sensor_registry.h"
+
+// Batch method: many samples of one sensor packed into a single request.
+// Layout: [sensor method u16][count u16][count x (value float, timestamp u32)],
+// in the byte order of the message's wire format (wire_codec.h)
+const uint16_t kSensorBatchMethod = 0x0010;
+const size_t kBatchMethodOffset = 0;
+const size_t kBatchCountOffset = 2;
+const size_t kBatchHeaderSize = 4;
+const size_t kBatchRecordSize = 8;
+
+static_assert(kBatchCountOffset + sizeof(uint16_t) == kBatchHeaderSize, "batch header layout");
+static_assert(kBatchRecordSize % 4 == 0, "batch records keep their fields 4-byte aligned");
+
+// Largest batch that fits a single UDP datagram without SOME/IP-TP
+// (1416 bytes vsomeip UDP limit minus 16 bytes SOME/IP header)
+const size_t kMaxUdpBatchSamples = (1400 - kBatchHeaderSize) / kBatchRecordSize;
+
+struct SensorBatchView {
+    uint16_t method;
+    uint16_t count;
+    PayloadView records;
+};
+
+inline size_t batch_payload_size(size_t count) {
+    return kBatchHeaderSize + count * kBatchRecordSize;
+}
+
+// Validates the header and that all count records are present
+inline bool decode_batch_header(PayloadView payload, SensorBatchView& out, WireFormat format = WireFormat::Legacy) {
+    if (!payload.contains(0, kBatchHeaderSize)) return false;
+    const uint16_t method = load_wire<uint16_t>(format, payload.data() + kBatchMethodOffset);
+    const uint16_t count = load_wire<uint16_t>(format, payload.data() + kBatchCountOffset);
+    if (!payload.contains(kBatchHeaderSize, static_cast<size_t>(count) * kBatchRecordSize)) return false;
+    out.method = method;
+    out.count = count;
+    out.records = payload.slice(kBatchHeaderSize, static_cast<size_t>(count) * kBatchRecordSize);
+    return true;
+}
+
+// Writes the batch header for count samples of S
+template <typename S>
+void encode_batch_header(uint16_t count, uint8_t* out, WireFormat format = WireFormat::Legacy) {
+    store_wire(format, out + kBatchMethodOffset, S::method_id);
+    store_wire(format, out + kBatchCountOffset, count);
+}
+
+// Writes sample index of the batch; records share the single-sample layout
+template <typename S>
+void encode_batch_record(const typename S::data_type& data, size_t index, uint8_t* out,
+                         WireFormat format = WireFormat::Legacy) {
+    static_assert(S::payload_size == kBatchRecordSize, "batch records share the single-sample layout");
+    encode_sensor_data<S>(data, out + kBatchHeaderSize + index * kBatchRecordSize, format);
+}
+
+// Reads sample index of a validated batch
+template <typename S>
+typename S::data_type decode_batch_record(const SensorBatchView& batch, size_t index,
+                                          WireFormat format = WireFormat::Legacy) {
+    typename S::data_type data = {};
+    decode_sensor_data<S>(batch.records.slice(index * kBatchRecordSize, kBatchRecordSize), data, format);
+    return data;
+}
+
+#endif // SENSOR_BATCH_H
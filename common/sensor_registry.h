@@ -0,0 +1,253 @@
+#ifndef SENSOR_REGISTRY_H
+#define SENSOR_REGISTRY_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+#include "payload_view.h"
+#include "wire_codec.h"
+
+// Sensor data structures - one per sensor type
+struct SpeedData {
+    float speed_kmh;
+    uint32_t timestamp;
+};
+
+struct EngineTemperatureData {
+    float temperature_celsius;
+    uint32_t timestamp;
+};
+
+struct AmbientTemperatureData {
+    float temperature_celsius;
+    uint32_t timestamp;
+};
+
+enum class Threshold : uint8_t { None, Above, Below };
+
+// SOME/IP transport of a sensor's requests: UDP for high-rate samples that
+// the next sample supersedes, TCP for critical signals that must not be lost
+enum class Transport : uint8_t { Unreliable, Reliable };
+
+// Compile-time sensor descriptors. Each one carries everything the client
+// and the gateway need: SOME/IP method, payload layout, request transport,
+// alarm threshold, display strings, the simulation profile used by the ECU
+// client and the notification policy of the sensor's event.
+// Adding a sensor means adding a descriptor and listing it in Sensors.
+struct SpeedSensor {
+    using data_type = SpeedData;
+    static constexpr float data_type::*value = &SpeedData::speed_kmh;
+
+    static constexpr uint16_t method_id = 0x0001;
+    static constexpr size_t value_offset = 0;
+    static constexpr size_t timestamp_offset = 4;
+    static constexpr size_t payload_size = 8;
+    static constexpr Transport transport = Transport::Unreliable;
+
+    static constexpr Threshold alarm = Threshold::Above;
+    static constexpr float alarm_limit = 100.0f;
+
+    static constexpr const char* label = "🏃 SPEED";
+    static constexpr const char* unit = " km/h";
+    static constexpr const char* alarm_text = " ⚠️ HIGH SPEED!";
+
+    static constexpr float sim_initial = 0.0f;
+    static constexpr float sim_min = 0.0f;
+    static constexpr float sim_max = 120.0f;
+    static constexpr float sim_step = 5.0f;        // Gradual speed variation
+    static constexpr unsigned period_ms = 2000;
+
+    static constexpr float notify_epsilon = 1.0f;  // Smaller changes are not notified
+    static constexpr unsigned notify_cycle_ms = 100; // Faster updates are coalesced
+};
+
+struct EngineTempSensor {
+    using data_type = EngineTemperatureData;
+    static constexpr float data_type::*value = &EngineTemperatureData::temperature_celsius;
+
+    static constexpr uint16_t method_id = 0x0002;
+    static constexpr size_t value_offset = 0;
+    static constexpr size_t timestamp_offset = 4;
+    static constexpr size_t payload_size = 8;
+    static constexpr Transport transport = Transport::Reliable;   // Overheat alarms must arrive
+
+    static constexpr Threshold alarm = Threshold::Above;
+    static constexpr float alarm_limit = 100.0f;
+
+    static constexpr const char* label = "🔥 ENGINE";
+    static constexpr const char* unit = "°C";
+    static constexpr const char* alarm_text = " 🚨 OVERHEAT!";
+
+    static constexpr float sim_initial = 80.0f;
+    static constexpr float sim_min = 60.0f;
+    static constexpr float sim_max = 110.0f;
+    static constexpr float sim_step = 2.0f;        // Gradual temp variation
+    static constexpr unsigned period_ms = 3000;
+
+    static constexpr float notify_epsilon = 0.5f;
+    static constexpr unsigned notify_cycle_ms = 100;
+};
+
+struct AmbientTempSensor {
+    using data_type = AmbientTemperatureData;
+    static constexpr float data_type::*value = &AmbientTemperatureData::temperature_celsius;
+
+    static constexpr uint16_t method_id = 0x0003;
+    static constexpr size_t value_offset = 0;
+    static constexpr size_t timestamp_offset = 4;
+    static constexpr size_t payload_size = 8;
+    static constexpr Transport transport = Transport::Unreliable;
+
+    static constexpr Threshold alarm = Threshold::Below;
+    static constexpr float alarm_limit = 0.0f;
+
+    static constexpr const char* label = "🌡️ AMBIENT";
+    static constexpr const char* unit = "°C";
+    static constexpr const char* alarm_text = " ❄️ FREEZING!";
+
+    static constexpr float sim_initial = 20.0f;
+    static constexpr float sim_min = -20.0f;
+    static constexpr float sim_max = 50.0f;
+    static constexpr float sim_step = 1.0f;        // Slow ambient change
+    static constexpr unsigned period_ms = 5000;
+
+    static constexpr float notify_epsilon = 0.5f;
+    static constexpr unsigned notify_cycle_ms = 100;
+};
+
+// Compile-time list of sensors
+template <typename... S>
+struct SensorList {
+    static constexpr size_t size = sizeof...(S);
+    static constexpr std::array<uint16_t, sizeof...(S)> method_ids = {{S::method_id...}};
+    static constexpr uint16_t min_method = std::min({S::method_id...});
+    static constexpr uint16_t max_method = std::max({S::method_id...});
+};
+
+using Sensors = SensorList<SpeedSensor, EngineTempSensor, AmbientTempSensor>;
+
+template <typename S>
+struct SensorTag {
+    using type = S;
+};
+
+// Calls f(SensorTag<S>{}) for every sensor in the list
+template <typename... S, typename F>
+void for_each_sensor(SensorList<S...>, F&& f) {
+    (f(SensorTag<S>{}), ...);
+}
+
+// Alarm check generated from the descriptor's threshold
+template <typename S>
+constexpr bool is_alarm(float value) {
+    if constexpr (S::alarm == Threshold::Above) {
+        return value > S::alarm_limit;
+    } else if constexpr (S::alarm == Threshold::Below) {
+        return value < S::alarm_limit;
+    } else {
+        return false;
+    }
+}
+
+// Event and eventgroup carrying S's samples to subscribers; one eventgroup
+// per sensor, so consumers subscribe only to what they need
+template <typename S>
+constexpr uint16_t sensor_event_id() {
+    return 0x8000 | S::method_id;
+}
+
+template <typename S>
+constexpr uint16_t sensor_eventgroup() {
+    return S::method_id;
+}
+
+// Compile-time check of a descriptor's payload layout: a float value and a
+// u32 timestamp, both 4-byte aligned, inside the payload and not overlapping
+template <typename S>
+constexpr bool sensor_layout_valid() {
+    return std::is_same<decltype(S::data_type::timestamp), uint32_t>::value &&
+           S::value_offset % 4 == 0 && S::timestamp_offset % 4 == 0 &&
+           S::value_offset + sizeof(float) <= S::payload_size &&
+           S::timestamp_offset + sizeof(uint32_t) <= S::payload_size &&
+           (S::value_offset + sizeof(float) <= S::timestamp_offset ||
+            S::timestamp_offset + sizeof(uint32_t) <= S::value_offset);
+}
+
+template <typename... S>
+constexpr bool sensor_layouts_valid(SensorList<S...>) {
+    return (sensor_layout_valid<S>() && ...);
+}
+
+static_assert(sensor_layouts_valid(Sensors{}), "sensor payload layout");
+
+// Writes the sample into out (at least S::payload_size bytes). Legacy is
+// host byte order, as before the format was versioned; see wire_codec.h.
+template <typename S>
+void encode_sensor_data(const typename S::data_type& data, uint8_t* out, WireFormat format = WireFormat::Legacy) {
+    static_assert(sensor_layout_valid<S>(), "sensor payload layout");
+    store_wire(format, out + S::value_offset, data.*S::value);
+    store_wire(format, out + S::timestamp_offset, data.timestamp);
+}
+
+// Reads a sample from the payload; false and out untouched on short payloads.
+// Bytes behind S::payload_size belong to later fields and are ignored.
+template <typename S>
+bool decode_sensor_data(PayloadView payload, typename S::data_type& out, WireFormat format = WireFormat::Legacy) {
+    static_assert(sensor_layout_valid<S>(), "sensor payload layout");
+    if (!payload.contains(0, S::payload_size)) return false;
+    out.*S::value = load_wire<float>(format, payload.data() + S::value_offset);
+    out.timestamp = load_wire<uint32_t>(format, payload.data() + S::timestamp_offset);
+    return true;
+}
+
+// Optional latency extension appended after the sensor fields of a
+// single-sample payload: sequence number, steady_clock send time and the
+// sequence stream. Each stream (one sender: a signal, or the ECUs of one
+// load-generator shard) numbers its samples on its own, so sequences of a
+// client are only comparable within one stream.
+// Gateways that do not know it only read the first S::payload_size bytes.
+struct SampleExtension {
+    uint32_t sequence;
+    uint64_t send_ns;
+    uint16_t stream;
+};
+
+// Offsets relative to the end of the sensor fields
+const size_t kExtensionSequenceOffset = 0;
+const size_t kExtensionSendTimeOffset = 4;
+const size_t kExtensionStreamOffset = 12;
+const size_t kSampleExtensionSize = 14;
+
+static_assert(kExtensionSequenceOffset + sizeof(SampleExtension::sequence) == kExtensionSendTimeOffset &&
+              kExtensionSendTimeOffset + sizeof(SampleExtension::send_ns) == kExtensionStreamOffset &&
+              kExtensionStreamOffset + sizeof(SampleExtension::stream) == kSampleExtensionSize,
+              "latency extension layout");
+
+template <typename S>
+constexpr size_t extended_payload_size() {
+    return S::payload_size + kSampleExtensionSize;
+}
+
+// Writes the extension behind the sample (out holds extended_payload_size<S>() bytes)
+template <typename S>
+void encode_sample_extension(const SampleExtension& ext, uint8_t* out, WireFormat format = WireFormat::Legacy) {
+    store_wire(format, out + S::payload_size + kExtensionSequenceOffset, ext.sequence);
+    store_wire(format, out + S::payload_size + kExtensionSendTimeOffset, ext.send_ns);
+    store_wire(format, out + S::payload_size + kExtensionStreamOffset, ext.stream);
+}
+
+// Reads the extension; false when the payload carries none
+template <typename S>
+bool decode_sample_extension(PayloadView payload, SampleExtension& out, WireFormat format = WireFormat::Legacy) {
+    if (!payload.contains(S::payload_size, kSampleExtensionSize)) return false;
+    out.sequence = load_wire<uint32_t>(format, payload.data() + S::payload_size + kExtensionSequenceOffset);
+    out.send_ns = load_wire<uint64_t>(format, payload.data() + S::payload_size + kExtensionSendTimeOffset);
+    out.stream = load_wire<uint16_t>(format, payload.data() + S::payload_size + kExtensionStreamOffset);
+    return true;
+}
+
+#endif // SENSOR_REGISTRY_H
@@ -0,0 +1,72 @@
+#ifndef SENSOR_SNAPSHOT_H
+#define SENSOR_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "payload_view.h"
+#include "sensor_batch.h"
+
+// Bulk snapshot method: a block of samples of several sensors in one
+// request, e.g. a second of high-rate samples. Snapshots exceed a UDP
+// datagram and travel as SOME/IP-TP segments, which vsomeip reassembles
+// into one payload before the handler runs (someip-tp in the configs).
+// Layout: [snapshot id u32][section count u16][reserved u16], then the
+// sections back to back, each in batch layout (sensor_batch.h):
+// [sensor method u16][count u16][count x (value float, timestamp u32)].
+// All fields in the byte order of the message's wire format (wire_codec.h).
+const uint16_t kSensorSnapshotMethod = 0x0011;
+const size_t kSnapshotIdOffset = 0;
+const size_t kSnapshotSectionsOffset = 4;
+const size_t kSnapshotReservedOffset = 6;
+const size_t kSnapshotHeaderSize = 8;
+
+static_assert(kSnapshotReservedOffset + sizeof(uint16_t) == kSnapshotHeaderSize, "snapshot header layout");
+
+// Largest snapshot the gateway reassembles (max-payload-size-unreliable)
+const size_t kMaxSnapshotSize = 256 * 1024;
+
+// SOME/IP-TP segment payloads are multiples of 16 bytes; 1392 is the
+// largest that still fits a 1416-byte vsomeip UDP datagram
+const size_t kTpSegmentAlignment = 16;
+const size_t kMaxTpSegmentLength = 1392;
+
+struct SensorSnapshotView {
+    uint32_t id;
+    uint16_t sections;
+    PayloadView body;      // the sections, behind the header
+};
+
+inline size_t snapshot_section_size(size_t count) {
+    return batch_payload_size(count);
+}
+
+// Reads the header; the sections are validated while iterating
+inline bool decode_snapshot_header(PayloadView payload, SensorSnapshotView& out,
+                                   WireFormat format = WireFormat::Legacy) {
+    if (!payload.contains(0, kSnapshotHeaderSize)) return false;
+    out.id = load_wire<uint32_t>(format, payload.data() + kSnapshotIdOffset);
+    out.sections = load_wire<uint16_t>(format, payload.data() + kSnapshotSectionsOffset);
+    out.body = payload.slice(kSnapshotHeaderSize, payload.size() - kSnapshotHeaderSize);
+    return true;
+}
+
+// Reads the section at offset into the body as a batch view over the same
+// bytes (no copy) and moves offset behind it; false if it is truncated
+inline bool next_snapshot_section(const SensorSnapshotView& snapshot, size_t& offset, SensorBatchView& out,
+                                  WireFormat format = WireFormat::Legacy) {
+    if (!snapshot.body.contains(offset, 0)) return false;
+    if (!decode_batch_header(snapshot.body.slice(offset, snapshot.body.size() - offset), out, format)) return false;
+    offset += snapshot_section_size(out.count);
+    return true;
+}
+
+// Writes the header; each section is written like a batch at its offset
+// (encode_batch_header<S> and encode_batch_record<S>)
+inline void encode_snapshot_header(uint32_t id, uint16_t sections, uint8_t* out,
+                                   WireFormat format = WireFormat::Legacy) {
+    store_wire(format, out + kSnapshotIdOffset, id);
+    store_wire(format, out + kSnapshotSectionsOffset, sections);
+    store_wire(format, out + kSnapshotReservedOffset, uint16_t(0));
+}
+
+#endif // SENSOR_SNAPSHOT_H
@@ -0,0 +1,91 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single value published through a sequence lock. Writers never wait: a
+// writer that finds another update in progress gives up and reports it.
+// Slots are meant to have one writer (the gateway keeps one per sensor
+// method), so with correct use a store never fails. Readers retry while an
+// update is in progress and always see a complete value.
+// The value is kept in atomic words so torn reads are not a data race.
+template <typename T>
+class SeqlockSlot {
+    static_assert(std::is_trivially_copyable<T>::value, "seqlock values are copied bytewise");
+
+public:
+    SeqlockSlot() : sequence_(0) {
+        for (auto& word : words_) word.store(0, std::memory_order_relaxed);
+    }
+
+    SeqlockSlot(const SeqlockSlot&) = delete;
+    SeqlockSlot& operator=(const SeqlockSlot&) = delete;
+
+    // Returns false when another writer was publishing at the same time
+    bool try_store(const T& value) {
+        return try_store_if(value, [](const T&) { return true; });
+    }
+
+    // Publishes value unless replaces(current) is false for the stored
+    // value, so the caller decides whether an update is newer (e.g. by
+    // receive time). replaces is not called on an empty slot. Returns false
+    // when value was not published, or when another writer was publishing.
+    template <typename F>
+    bool try_store_if(const T& value, F replaces) {
+        uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        if ((seq & 1) || !sequence_.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire)) {
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        
+        uint64_t buffer[kWords] = {};
+        if (seq != 0) {
+            for (size_t i = 0; i < kWords; ++i) buffer[i] = words_[i].load(std::memory_order_relaxed);
+            T current;
+            std::memcpy(&current, buffer, sizeof(T));
+            if (!replaces(current)) {
+                // Nothing changed, so readers that saw seq before still read a consistent value
+                sequence_.store(seq, std::memory_order_release);
+                return false;
+            }
+        }
+        std::memcpy(buffer, &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) words_[i].store(buffer[i], std::memory_order_relaxed);
+        
+        sequence_.store(seq + 2, std::memory_order_release);
+        return true;
+    }
+
+    // Returns false while nothing has been stored yet
+    bool load(T& out) const {
+        uint64_t buffer[kWords];
+        for (;;) {
+            uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            for (size_t i = 0; i < kWords; ++i) buffer[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                if (before == 0) return false;
+                std::memcpy(&out, buffer, sizeof(T));
+                return true;
+            }
+        }
+    }
+
+    // Number of completed updates
+    uint64_t version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // Even when idle, 0 until the first store. 64 bits never wrap back to 0
+    // (a 32-bit counter would after 2^31 stores and read as empty again).
+    std::atomic<uint64_t> sequence_;
+    std::atomic<uint64_t> words_[kWords];
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,121 @@
+#ifndef SHARD_RING_H
+#define SHARD_RING_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Gateway shards: shard i offers service 0x1234 as instance kFirstShardInstance + i,
+// from its own vsomeip application and therefore its own dispatcher
+constexpr uint16_t kFirstShardInstance = 0x0001;
+constexpr size_t kMaxShards = 8;
+
+inline uint16_t shard_instance(size_t shard) {
+    return static_cast<uint16_t>(kFirstShardInstance + shard);
+}
+
+// Instance under which state of a sharded service is kept: every shard
+// instance maps to the first, any other instance to itself
+inline uint16_t logical_instance(uint16_t instance) {
+    return instance >= kFirstShardInstance && instance < kFirstShardInstance + kMaxShards ? kFirstShardInstance
+                                                                                          : instance;
+}
+
+// vsomeip application name of a shard; shard 0 keeps the unsharded gateway's name
+inline std::string shard_application_name(size_t shard) {
+    return shard == 0 ? std::string("central_gateway") : "central_gateway_" + std::to_string(shard);
+}
+
+// Consistent hash ring of gateway instances. Every instance is placed on the
+// ring at `replicas` pseudo-random points; a key belongs to the instance of
+// the first point at or after its own hash. Adding or removing an instance
+// therefore only moves the keys of the arcs it gains or loses, roughly
+// 1/N of them, and every other ECU stays on the gateway it already talks to.
+class ShardRing {
+public:
+    static constexpr size_t kDefaultReplicas = 160;
+
+    explicit ShardRing(const std::vector<uint16_t>& instances, size_t replicas = kDefaultReplicas)
+        : instances_(instances) {
+        points_.reserve(instances.size() * replicas);
+        for (uint16_t instance : instances) {
+            for (size_t replica = 0; replica < replicas; ++replica) {
+                points_.push_back(Point{mix((uint64_t(instance) << 32) | replica), instance});
+            }
+        }
+        // Ties, however unlikely, are broken by instance so the order never depends on input order
+        std::sort(points_.begin(), points_.end(), [](const Point& a, const Point& b) {
+            return a.hash != b.hash ? a.hash < b.hash : a.instance < b.instance;
+        });
+    }
+
+    // Ring of instances kFirstShardInstance .. kFirstShardInstance + shards - 1
+    static ShardRing of_shards(size_t shards, size_t replicas = kDefaultReplicas) {
+        std::vector<uint16_t> instances;
+        for (size_t shard = 0; shard < shards; ++shard) instances.push_back(shard_instance(shard));
+        return ShardRing(instances, replicas);
+    }
+
+    // Instance serving key (an ECU ID); 0 for an empty ring
+    uint16_t instance_for(uint32_t key) const {
+        return points_.empty() ? 0 : points_[first_point(key)].instance;
+    }
+
+    // Instances of keys 0..keys-1 with bounded loads: no instance takes more
+    // than ceil(keys / N * (1 + slack)) keys. A key whose instance is full
+    // walks on clockwise to the next instance with room, so with few keys
+    // (a handful of ECUs) one unlucky arc cannot collect most of them, while
+    // most keys still land where instance_for() puts them.
+    std::vector<uint16_t> assign(uint32_t keys, double slack = 0.25) const {
+        std::vector<uint16_t> out(keys, 0);
+        if (points_.empty()) return out;
+        const size_t capacity = static_cast<size_t>(std::ceil(keys * (1.0 + slack) / instances_.size()));
+        std::vector<size_t> load(instances_.size(), 0);
+        for (uint32_t key = 0; key < keys; ++key) {
+            size_t point = first_point(key);
+            for (size_t step = 0; step < points_.size(); ++step, point = (point + 1) % points_.size()) {
+                size_t index = static_cast<size_t>(
+                    std::find(instances_.begin(), instances_.end(), points_[point].instance) - instances_.begin());
+                if (load[index] < capacity) {
+                    ++load[index];
+                    out[key] = points_[point].instance;
+                    break;
+                }
+            }
+        }
+        return out;
+    }
+
+    const std::vector<uint16_t>& instances() const { return instances_; }
+
+private:
+    struct Point {
+        uint64_t hash;
+        uint16_t instance;
+    };
+
+    // Index of the first point at or after the key's hash, wrapping around
+    size_t first_point(uint32_t key) const {
+        // Keys are salted so ECU n does not land exactly on a point of instance n
+        const uint64_t hash = mix(key ^ 0x5EC0E0C0DEull);
+        auto it = std::lower_bound(points_.begin(), points_.end(), hash,
+                                   [](const Point& point, uint64_t value) { return point.hash < value; });
+        return it == points_.end() ? 0 : static_cast<size_t>(it - points_.begin());
+    }
+
+    // splitmix64 finalizer: consecutive inputs spread over the whole ring
+    static uint64_t mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    std::vector<uint16_t> instances_;
+    std::vector<Point> points_;
+};
+
+#endif // SHARD_RING_H
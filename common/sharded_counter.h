@@ -0,0 +1,51 @@
+#ifndef SHARDED_COUNTER_H
+#define SHARDED_COUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Event counter split into cache-line sized shards. Each thread increments
+// its own shard, so concurrent writers never contend on one cache line;
+// readers sum all shards (exact when writers are quiescent).
+class ShardedCounter {
+public:
+    static constexpr size_t kShards = 16;
+
+    ShardedCounter() { reset(); }
+
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    void add(uint64_t count = 1) {
+        shards_[shard_index()].value.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    uint64_t load() const {
+        uint64_t total = 0;
+        for (const Shard& shard : shards_) total += shard.value.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    void reset() {
+        for (Shard& shard : shards_) shard.value.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    // One cache line per shard; the alignment also pads it to the full line
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value;
+    };
+    static_assert(sizeof(Shard) == 64, "shards must not share cache lines");
+
+    // Threads are assigned shards round-robin on first use
+    static size_t shard_index() {
+        static std::atomic<size_t> next{0};
+        thread_local size_t index = next.fetch_add(1, std::memory_order_relaxed) % kShards;
+        return index;
+    }
+
+    Shard shards_[kShards];
+};
+
+#endif // SHARDED_COUNTER_H
@@ -0,0 +1,77 @@
+#ifndef WINDOW_STATS_H
+#define WINDOW_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "payload_view.h"
+#include "wire_codec.h"
+
+// Rolling statistics of one sensor over one time window
+struct WindowStats {
+    uint32_t window_ms;
+    uint32_t count;      // samples currently inside the window
+    float min;
+    float max;
+    float mean;
+    float stddev;        // population standard deviation
+};
+
+// Request/response method returning the window statistics of one sensor.
+// Request layout:  [sensor method u16]
+// Response layout: [sensor method u16][windows u16][windows x record]
+// Record layout:   [window_ms u32][count u32][min f32][max f32][mean f32][stddev f32]
+// Unknown sensors and short requests are answered with zero windows.
+// Fields are in the byte order of the message's wire format (wire_codec.h).
+const uint16_t kSensorStatsMethod = 0x0021;
+const size_t kStatsHeaderSize = 4;
+const size_t kStatsRecordSize = 24;
+
+inline size_t stats_payload_size(size_t windows) {
+    return kStatsHeaderSize + windows * kStatsRecordSize;
+}
+
+inline void encode_stats_header(uint16_t method, uint16_t windows, uint8_t* out,
+                                WireFormat format = WireFormat::Legacy) {
+    store_wire(format, out, method);
+    store_wire(format, out + 2, windows);
+}
+
+inline void encode_stats_record(const WindowStats& stats, size_t index, uint8_t* out,
+                                WireFormat format = WireFormat::Legacy) {
+    uint8_t* at = out + kStatsHeaderSize + index * kStatsRecordSize;
+    store_wire(format, at, stats.window_ms);
+    store_wire(format, at + 4, stats.count);
+    store_wire(format, at + 8, stats.min);
+    store_wire(format, at + 12, stats.max);
+    store_wire(format, at + 16, stats.mean);
+    store_wire(format, at + 20, stats.stddev);
+}
+
+// Validates that the header and all window records are present
+inline bool decode_stats_header(PayloadView payload, uint16_t& method, uint16_t& windows,
+                                WireFormat format = WireFormat::Legacy) {
+    if (!payload.contains(0, kStatsHeaderSize)) return false;
+    const uint16_t sensor = load_wire<uint16_t>(format, payload.data());
+    const uint16_t count = load_wire<uint16_t>(format, payload.data() + 2);
+    if (!payload.contains(kStatsHeaderSize, static_cast<size_t>(count) * kStatsRecordSize)) return false;
+    method = sensor;
+    windows = count;
+    return true;
+}
+
+// Reads record index of a validated response
+inline WindowStats decode_stats_record(PayloadView payload, size_t index, WireFormat format = WireFormat::Legacy) {
+    WindowStats stats = {};
+    const size_t offset = kStatsHeaderSize + index * kStatsRecordSize;
+    if (!payload.contains(offset, kStatsRecordSize)) return stats;
+    const uint8_t* at = payload.data() + offset;
+    stats.window_ms = load_wire<uint32_t>(format, at);
+    stats.count = load_wire<uint32_t>(format, at + 4);
+    stats.min = load_wire<float>(format, at + 8);
+    stats.max = load_wire<float>(format, at + 12);
+    stats.mean = load_wire<float>(format, at + 16);
+    stats.stddev = load_wire<float>(format, at + 20);
+    return stats;
+}
+
+#endif // WINDOW_STATS_H
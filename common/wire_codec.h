@@ -0,0 +1,99 @@
+#ifndef WIRE_CODEC_H
+#define WIRE_CODEC_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Byte order of sensor payloads on the wire.
+//
+// Legacy payloads (SOME/IP interface version 0, everything sent before the
+// format was versioned) carry fields in the sender's host byte order.
+// Version 1 payloads carry every field in network (big-endian) byte order,
+// as SOME/IP serialization requires. The version travels in the interface
+// version field of the SOME/IP header, so the payload layout itself is
+// unchanged and a gateway decodes both.
+//
+// Version 1 layouts are append-only: a new field goes behind the existing
+// ones, decoders read the fields they know and ignore trailing bytes, and
+// a field is present when the payload is long enough to hold it. Adding a
+// field therefore needs neither a new version nor a lockstep deploy of ECUs
+// and gateways; only an incompatible change (reordering, resizing) does.
+enum class WireFormat : uint8_t {
+    Legacy = 0,
+    V1 = 1,
+};
+
+// Format new senders use
+const WireFormat kCurrentWireFormat = WireFormat::V1;
+
+constexpr bool kHostBigEndian = __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__;
+
+// Branch-free byte swaps (a single bswap/rev instruction)
+inline uint8_t byte_swap(uint8_t value) { return value; }
+inline uint16_t byte_swap(uint16_t value) { return __builtin_bswap16(value); }
+inline uint32_t byte_swap(uint32_t value) { return __builtin_bswap32(value); }
+inline uint64_t byte_swap(uint64_t value) { return __builtin_bswap64(value); }
+
+// Unsigned integer of the same size as T, the unit the byte swap works on
+template <typename T>
+using wire_bits_t = typename std::conditional<sizeof(T) == 1, uint8_t,
+                    typename std::conditional<sizeof(T) == 2, uint16_t,
+                    typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type>::type>::type;
+
+// Writes value at out in big-endian order; a plain copy on big-endian hosts
+template <typename T>
+inline void store_be(uint8_t* out, T value) {
+    static_assert(std::is_arithmetic<T>::value && sizeof(T) <= 8, "wire fields are scalars");
+    wire_bits_t<T> bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    if (!kHostBigEndian) bits = byte_swap(bits);
+    std::memcpy(out, &bits, sizeof(T));
+}
+
+// Reads a big-endian value at in
+template <typename T>
+inline T load_be(const uint8_t* in) {
+    static_assert(std::is_arithmetic<T>::value && sizeof(T) <= 8, "wire fields are scalars");
+    wire_bits_t<T> bits;
+    std::memcpy(&bits, in, sizeof(T));
+    if (!kHostBigEndian) bits = byte_swap(bits);
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+// Field codecs for either format. When the format matches the host order
+// (legacy, or version 1 on a big-endian host) this is a plain copy.
+template <typename T>
+inline void store_wire(WireFormat format, uint8_t* out, T value) {
+    if (format == WireFormat::Legacy || kHostBigEndian) {
+        std::memcpy(out, &value, sizeof(T));
+    } else {
+        store_be(out, value);
+    }
+}
+
+template <typename T>
+inline T load_wire(WireFormat format, const uint8_t* in) {
+    if (format == WireFormat::Legacy || kHostBigEndian) {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        return value;
+    }
+    return load_be<T>(in);
+}
+
+// Maps the SOME/IP interface version of a message to its payload format;
+// false for versions this build cannot decode
+inline bool wire_format_from_interface_version(uint8_t version, WireFormat& out) {
+    if (version > static_cast<uint8_t>(WireFormat::V1)) return false;
+    out = static_cast<WireFormat>(version);
+    return true;
+}
+
+inline uint8_t interface_version_of(WireFormat format) {
+    return static_cast<uint8_t>(format);
+}
+
+#endif // WIRE_CODEC_H
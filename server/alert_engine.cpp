@@ -0,0 +1,267 @@
+#include "alert_engine.h"
+#include "async_log.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+AlertEngine::AlertEngine(size_t queue_capacity) : queue_(queue_capacity) {
+    std::fill(std::begin(method_first_), std::end(method_first_), uint16_t(0));
+    for (Source& source : sources_) source.key.store(0, std::memory_order_relaxed);
+}
+
+bool AlertEngine::configure(const std::vector<AlertRule>& rules, std::string& error) {
+    if (rules.size() > kMaxRules) {
+        error = "at most " + std::to_string(kMaxRules) + " alert rules are supported";
+        return false;
+    }
+    for (const AlertRule& rule : rules) {
+        bool known = std::find(Sensors::method_ids.begin(), Sensors::method_ids.end(), rule.method) !=
+                     Sensors::method_ids.end();
+        if (!known) {
+            char method[8];
+            std::snprintf(method, sizeof(method), "0x%04X", rule.method);
+            error = std::string("alert rule for unknown sensor method ") + method;
+            return false;
+        }
+        if (!(rule.hysteresis >= 0.0f)) {
+            error = "alert rule hysteresis must not be negative";
+            return false;
+        }
+    }
+
+    rules_ = rules;
+    compiled_.clear();
+    for (size_t m = 0; m < kMethods; ++m) {
+        method_first_[m] = static_cast<uint16_t>(compiled_.size());
+        for (size_t i = 0; i < rules.size(); ++i) {
+            const AlertRule& rule = rules[i];
+            if (rule.method != Sensors::min_method + m) continue;
+            CompiledRule compiled;
+            bool falling = rule.condition == AlertCondition::Below || rule.condition == AlertCondition::FallRate;
+            compiled.sign = falling ? -1.0f : 1.0f;
+            // Falling rates are configured as a positive speed, lower limits as a value
+            compiled.raise_above = rule.condition == AlertCondition::Below ? -rule.threshold : rule.threshold;
+            compiled.clear_at = compiled.raise_above - rule.hysteresis;
+            compiled.rate = rule.condition == AlertCondition::RiseRate || rule.condition == AlertCondition::FallRate;
+            compiled.index = static_cast<uint16_t>(i);
+            compiled.min_duration_ns = uint64_t(rule.min_duration_ms) * 1000000;
+            compiled_.push_back(compiled);
+        }
+    }
+    method_first_[kMethods] = static_cast<uint16_t>(compiled_.size());
+
+    for (Source& source : sources_) {
+        source.key.store(0, std::memory_order_relaxed);
+        for (MethodState& state : source.methods) {
+            state.has_last = false;
+            state.last_value = 0.0f;
+            state.last_ns = 0;
+        }
+        std::fill(std::begin(source.rules), std::end(source.rules), RuleState{false, false, 0});
+    }
+    AlertEvent stale;
+    while (queue_.try_pop(stale)) {}
+    raised_.reset();
+    cleared_.reset();
+    dropped_.reset();
+    untracked_.reset();
+    return true;
+}
+
+void AlertEngine::evaluate(uint16_t method, uint16_t service, uint16_t instance, const float* values, size_t count,
+                           uint64_t now_ns) {
+    size_t m = static_cast<size_t>(method - Sensors::min_method);
+    if (m >= kMethods) return;
+    size_t first = method_first_[m];
+    size_t last = method_first_[m + 1];
+    if (first == last || count == 0) return;
+
+    Source* source = find_claimed(sources_, make_key(service, instance), true);
+    if (source == nullptr) {
+        untracked_.add(count);
+        return;
+    }
+    MethodState& state = source->methods[m];
+    for (size_t i = 0; i < count; ++i) {
+        evaluate_sample(*source, state, first, last, method, values[i], now_ns);
+    }
+}
+
+void AlertEngine::evaluate_sample(Source& source, MethodState& state, size_t first, size_t last, uint16_t method,
+                                  float value, uint64_t now_ns) {
+    // Samples received together (a batch) have no time between them, hence no
+    // rate. Rates are compared as change > limit * elapsed, without dividing.
+    bool has_rate = state.has_last && now_ns > state.last_ns;
+    float change = value - state.last_value;
+    float elapsed_s = has_rate ? static_cast<float>(now_ns - state.last_ns) * 1e-9f : 0.0f;
+    state.has_last = true;
+    state.last_value = value;
+    state.last_ns = now_ns;
+
+    for (size_t r = first; r < last; ++r) {
+        const CompiledRule& rule = compiled_[r];
+        if (rule.rate && !has_rate) continue;
+        float metric = rule.sign * (rule.rate ? change : value);
+        float scale = rule.rate ? elapsed_s : 1.0f;
+        RuleState& rule_state = source.rules[r];
+        AlertEdge edge;
+        if (!rule_state.active) {
+            if (!(metric > rule.raise_above * scale)) {
+                rule_state.pending = false;
+                continue;
+            }
+            if (!rule_state.pending) {
+                rule_state.pending = true;
+                rule_state.since_ns = now_ns;
+            }
+            if (now_ns - rule_state.since_ns < rule.min_duration_ns) continue;
+            rule_state.active = true;
+            rule_state.pending = false;
+            edge = AlertEdge::Raised;
+            raised_.add();
+        } else {
+            if (!(metric <= rule.clear_at * scale)) continue;
+            rule_state.active = false;
+            edge = AlertEdge::Cleared;
+            cleared_.add();
+        }
+        uint64_t key = source.key.load(std::memory_order_relaxed);
+        float observed = rule.rate ? change / elapsed_s : value;
+        emit(AlertEvent{rule.index, method, static_cast<uint16_t>(key >> 16), static_cast<uint16_t>(key & 0xFFFF),
+                        edge, value, observed, now_ns});
+    }
+}
+
+void AlertEngine::emit(const AlertEvent& event) {
+    if (!queue_.try_push(event)) dropped_.add();
+}
+
+bool AlertEngine::active(size_t rule, uint16_t service, uint16_t instance) const {
+    const Source* source = find_claimed(const_cast<AlertEngine*>(this)->sources_, make_key(service, instance), false);
+    if (source == nullptr) return false;
+    for (size_t r = 0; r < compiled_.size(); ++r) {
+        if (compiled_[r].index == rule) return source->rules[r].active;
+    }
+    return false;
+}
+
+std::vector<AlertRule> default_alert_rules() {
+    std::vector<AlertRule> rules;
+    for_each_sensor(Sensors{}, [&rules](auto tag) {
+        using S = typename decltype(tag)::type;
+        if (S::alarm == Threshold::None) return;
+        AlertCondition condition = S::alarm == Threshold::Above ? AlertCondition::Above : AlertCondition::Below;
+        rules.push_back(AlertRule{S::method_id, condition, S::alarm_limit, 0.0f, 0});
+    });
+    return rules;
+}
+
+static bool parse_condition(const std::string& text, AlertCondition& out) {
+    if (text == "above") {
+        out = AlertCondition::Above;
+    } else if (text == "below") {
+        out = AlertCondition::Below;
+    } else if (text == "rise-rate") {
+        out = AlertCondition::RiseRate;
+    } else if (text == "fall-rate") {
+        out = AlertCondition::FallRate;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool parse_float(const std::string& text, float& out) {
+    char* end = nullptr;
+    out = std::strtof(text.c_str(), &end);
+    return !text.empty() && *end == '\0';
+}
+
+bool parse_alert_rules(std::istream& in, std::vector<AlertRule>& out, std::string& error) {
+    std::vector<AlertRule> rules;
+    std::string line;
+    for (size_t number = 1; std::getline(in, line); ++number) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string method, condition, threshold, hysteresis = "0", duration = "0", extra;
+        if (!(fields >> method)) continue;
+        fields >> condition >> threshold;
+        if (fields >> hysteresis) fields >> duration;
+
+        AlertRule rule = {};
+        char* end = nullptr;
+        unsigned long method_id = std::strtoul(method.c_str(), &end, 0);
+        unsigned long duration_ms = 0;
+        bool valid = *end == '\0' && method_id <= 0xFFFF && parse_condition(condition, rule.condition) &&
+                     parse_float(threshold, rule.threshold) && parse_float(hysteresis, rule.hysteresis) &&
+                     rule.hysteresis >= 0.0f && !(fields >> extra);
+        if (valid) {
+            duration_ms = std::strtoul(duration.c_str(), &end, 10);
+            valid = !duration.empty() && duration[0] != '-' && *end == '\0' && duration_ms <= UINT32_MAX;
+        }
+        if (!valid) {
+            error = "alert rule line " + std::to_string(number) +
+                    ": expected METHOD above|below|rise-rate|fall-rate THRESHOLD [HYSTERESIS [MIN_DURATION_MS]]";
+            return false;
+        }
+        rule.method = static_cast<uint16_t>(method_id);
+        rule.min_duration_ms = static_cast<uint32_t>(duration_ms);
+        rules.push_back(rule);
+    }
+    out = rules;
+    return true;
+}
+
+// Display strings of the sensor behind method
+struct SensorText {
+    const char* label;
+    const char* unit;
+};
+
+static SensorText sensor_text(uint16_t method) {
+    SensorText text = {"❓ UNKNOWN", ""};
+    for_each_sensor(Sensors{}, [&](auto tag) {
+        using S = typename decltype(tag)::type;
+        if (S::method_id == method) text = SensorText{S::label, S::unit};
+    });
+    return text;
+}
+
+std::string describe_alert(const AlertEngine& engine, const AlertEvent& event) {
+    static const char* const kConditions[] = {"above", "below", "rising faster than", "falling faster than"};
+    if (event.rule >= engine.rules().size()) return "🚨 ALERT of a rule no longer configured";
+    const AlertRule& rule = engine.rules()[event.rule];
+    bool rate = rule.condition == AlertCondition::RiseRate || rule.condition == AlertCondition::FallRate;
+    SensorText text = sensor_text(event.method);
+    char line[256];
+    std::snprintf(line, sizeof(line), "%s %s %s %.1f%s%s: %.1f%s%s [0x%04X.0x%04X Method 0x%04X]",
+                  event.edge == AlertEdge::Raised ? "🚨 ALERT" : "✅ CLEARED", text.label,
+                  kConditions[static_cast<size_t>(rule.condition)], rule.threshold, text.unit, rate ? "/s" : "",
+                  event.metric, text.unit, rate ? "/s" : "", event.service, event.instance, event.method);
+    return line;
+}
+
+AlertEngine& alert_engine() {
+    static AlertEngine engine;
+    static bool configured = []() {
+        std::string error;
+        return engine.configure(default_alert_rules(), error);
+    }();
+    (void)configured;
+    return engine;
+}
+
+static void format_alert_line(std::string& out, const void* args) {
+    out.append(describe_alert(alert_engine(), *static_cast<const AlertEvent*>(args)));
+}
+
+size_t log_alert_events() {
+    size_t count = 0;
+    AlertEvent event;
+    while (alert_engine().poll(event)) {
+        console_log().post(format_alert_line, event);
+        ++count;
+    }
+    return count;
+}
@@ -0,0 +1,157 @@
+#ifndef ALERT_ENGINE_H
+#define ALERT_ENGINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+#include "bounded_queue.h"
+#include "claimed_table.h"
+#include "sensor_registry.h"
+#include "sharded_counter.h"
+
+enum class AlertCondition : uint8_t { Above, Below, RiseRate, FallRate };
+
+// One configured rule. Level conditions compare the sample value with
+// threshold; rate conditions compare its change per second since the
+// previous sample of the same source, in the sensor's unit. A rule raises
+// once its condition has held for min_duration_ms and clears once the value
+// (or rate) is back inside the threshold by at least hysteresis.
+struct AlertRule {
+    uint16_t method;
+    AlertCondition condition;
+    float threshold;
+    float hysteresis;
+    uint32_t min_duration_ms;
+};
+
+enum class AlertEdge : uint8_t { Raised, Cleared };
+
+// Edge of one rule for one source, queued for the alert consumer
+struct AlertEvent {
+    uint16_t rule;         // index into rules()
+    uint16_t method;
+    uint16_t service;
+    uint16_t instance;
+    AlertEdge edge;
+    float value;           // sample that caused the edge
+    float metric;          // value, or rate per second, compared with the threshold
+    uint64_t time_ns;      // receive time of that sample
+};
+
+// Alert rules evaluated on the handler path. Rules are compiled once into a
+// per-method range of "metric above limit" checks, so a sample costs a table
+// lookup plus one compare per rule of its method. Each source (service,
+// instance) claims a state slot (claimed_table.h) on its first sample. Only edges
+// leave the hot path: they are pushed into a lock-free queue, dropped and
+// counted when it is full, and formatted by whoever polls it.
+class AlertEngine {
+public:
+    static constexpr size_t kMaxRules = 32;
+    // Distinct sources with alert state; samples of later ones are not evaluated
+    static constexpr size_t kSourceSlots = 16;
+
+    explicit AlertEngine(size_t queue_capacity = 1024);
+
+    AlertEngine(const AlertEngine&) = delete;
+    AlertEngine& operator=(const AlertEngine&) = delete;
+
+    // Replaces the rules and forgets all alert state and queued events.
+    // Not safe against concurrent evaluation; call before traffic starts.
+    // Returns false and keeps the old rules when a rule is invalid.
+    bool configure(const std::vector<AlertRule>& rules, std::string& error);
+
+    // Evaluates the rules of method for one sample, or for count samples
+    // received together (a batch, evaluated in order). The state of a
+    // method has one writer: calls for one method must not overlap, which
+    // the dispatch stage guarantees by running each method on one thread.
+    void evaluate(uint16_t method, uint16_t service, uint16_t instance, float value, uint64_t now_ns) {
+        evaluate(method, service, instance, &value, 1, now_ns);
+    }
+    void evaluate(uint16_t method, uint16_t service, uint16_t instance, const float* values, size_t count,
+                  uint64_t now_ns);
+
+    // Takes the oldest queued edge; false when none is queued
+    bool poll(AlertEvent& out) { return queue_.try_pop(out); }
+
+    const std::vector<AlertRule>& rules() const { return rules_; }
+    // Whether rule is currently raised for the source
+    bool active(size_t rule, uint16_t service, uint16_t instance) const;
+
+    uint64_t raised() const { return raised_.load(); }
+    uint64_t cleared() const { return cleared_.load(); }
+    // Edges lost to a full queue
+    uint64_t dropped() const { return dropped_.load(); }
+    // Samples of sources beyond kSourceSlots
+    uint64_t untracked() const { return untracked_.load(); }
+
+private:
+    static constexpr size_t kMethods = Sensors::max_method - Sensors::min_method + 1;
+
+    // A rule rewritten as "sign * metric > raise_above", cleared at or below clear_at
+    struct CompiledRule {
+        float sign;
+        float raise_above;
+        float clear_at;
+        bool rate;
+        uint16_t index;
+        uint64_t min_duration_ns;
+    };
+
+    struct RuleState {
+        bool active;
+        bool pending;
+        uint64_t since_ns;
+    };
+
+    struct MethodState {
+        bool has_last;
+        float last_value;
+        uint64_t last_ns;
+    };
+
+    struct alignas(64) Source {
+        std::atomic<uint64_t> key;   // 0 = free
+        MethodState methods[kMethods];
+        RuleState rules[kMaxRules];
+    };
+
+    static uint64_t make_key(uint16_t service, uint16_t instance) {
+        return (uint64_t(1) << 63) | (uint64_t(service) << 16) | instance;
+    }
+
+    void evaluate_sample(Source& source, MethodState& state, size_t first, size_t last, uint16_t method,
+                         float value, uint64_t now_ns);
+    void emit(const AlertEvent& event);
+
+    std::vector<AlertRule> rules_;
+    std::vector<CompiledRule> compiled_;     // grouped by method
+    uint16_t method_first_[kMethods + 1];    // compiled_ range of each method
+    Source sources_[kSourceSlots];
+    BoundedQueue<AlertEvent> queue_;
+    ShardedCounter raised_;
+    ShardedCounter cleared_;
+    ShardedCounter dropped_;
+    ShardedCounter untracked_;
+};
+
+// One rule per descriptor threshold, without hysteresis or minimum duration
+std::vector<AlertRule> default_alert_rules();
+
+// Reads rules, one per line: METHOD CONDITION THRESHOLD [HYSTERESIS [MIN_DURATION_MS]]
+// with CONDITION one of above, below, rise-rate, fall-rate; '#' starts a comment.
+// On failure returns false and names the offending line in error.
+bool parse_alert_rules(std::istream& in, std::vector<AlertRule>& out, std::string& error);
+
+// Human-readable line for an edge of one of engine's rules
+std::string describe_alert(const AlertEngine& engine, const AlertEvent& event);
+
+// Process-wide engine fed by the sensor handlers, with default_alert_rules()
+AlertEngine& alert_engine();
+
+// Moves queued edges of alert_engine() to the console; returns how many
+size_t log_alert_events();
+
+#endif // ALERT_ENGINE_H
@@ -0,0 +1,281 @@
+#include "batch_decode.h"
+#include "sensor_batch.h"
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define BATCH_DECODE_X86 1
+#endif
+
+static_assert(kBatchRecordSize == 8, "batch kernels expect 8-byte records");
+
+namespace {
+
+const size_t kLanes = 8;
+
+// Per-lane accumulators; every kernel ends in this form
+struct Lanes {
+    float min[kLanes];
+    float max[kLanes];
+    float sum[kLanes];
+};
+
+// Scalar twins of minps/maxps: the second operand wins unless the first compares true
+inline float lane_min(float a, float b) { return a < b ? a : b; }
+inline float lane_max(float a, float b) { return a > b ? a : b; }
+
+inline bool alarm_at(Threshold alarm, float limit, float value) {
+    if (alarm == Threshold::Above) return value > limit;
+    if (alarm == Threshold::Below) return value < limit;
+    return false;
+}
+
+void init_lanes(Lanes& lanes) {
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        lanes.min[lane] = std::numeric_limits<float>::infinity();
+        lanes.max[lane] = -std::numeric_limits<float>::infinity();
+        lanes.sum[lane] = 0.0f;
+    }
+}
+
+// Decodes records [from, count) one at a time into lane i % 8; from is a multiple of 8
+void decode_scalar(const uint8_t* records, size_t from, size_t count, WireFormat format, Threshold alarm,
+                   float limit, const BatchColumns& out, Lanes& lanes) {
+    for (size_t i = from; i < count; i += kLanes) {
+        uint8_t bits = 0;
+        for (size_t lane = 0; lane < kLanes && i + lane < count; ++lane) {
+            const uint8_t* record = records + (i + lane) * kBatchRecordSize;
+            const float value = load_wire<float>(format, record);
+            const uint32_t timestamp = load_wire<uint32_t>(format, record + 4);
+            out.values[i + lane] = value;
+            out.timestamps[i + lane] = timestamp;
+            lanes.min[lane] = lane_min(value, lanes.min[lane]);
+            lanes.max[lane] = lane_max(value, lanes.max[lane]);
+            lanes.sum[lane] += value;
+            if (alarm_at(alarm, limit, value)) bits |= static_cast<uint8_t>(1u << lane);
+        }
+        out.alarm_bits[i / kLanes] = bits;
+    }
+}
+
+// Combines the eight lanes as the vector kernels do: lane j with j + 4, then j with j + 2, then 0 with 1
+void finish(const Lanes& lanes, size_t count, const BatchColumns& out, BatchSummary& summary) {
+    float min4[4], max4[4], sum4[4];
+    for (size_t j = 0; j < 4; ++j) {
+        min4[j] = lane_min(lanes.min[j], lanes.min[j + 4]);
+        max4[j] = lane_max(lanes.max[j], lanes.max[j + 4]);
+        sum4[j] = lanes.sum[j] + lanes.sum[j + 4];
+    }
+    float min2[2], max2[2], sum2[2];
+    for (size_t j = 0; j < 2; ++j) {
+        min2[j] = lane_min(min4[j], min4[j + 2]);
+        max2[j] = lane_max(max4[j], max4[j + 2]);
+        sum2[j] = sum4[j] + sum4[j + 2];
+    }
+    summary.min = lane_min(min2[0], min2[1]);
+    summary.max = lane_max(max2[0], max2[1]);
+    summary.sum = sum2[0] + sum2[1];
+
+    uint32_t alarms = 0;
+    for (size_t byte = 0; byte < (count + kLanes - 1) / kLanes; ++byte) {
+        alarms += static_cast<uint32_t>(__builtin_popcount(out.alarm_bits[byte]));
+    }
+    summary.alarms = alarms;
+}
+
+void run_scalar(const uint8_t* records, size_t count, WireFormat format, Threshold alarm, float limit,
+                const BatchColumns& out, BatchSummary& summary) {
+    Lanes lanes;
+    init_lanes(lanes);
+    decode_scalar(records, 0, count, format, alarm, limit, out, lanes);
+    finish(lanes, count, out, summary);
+}
+
+#if BATCH_DECODE_X86
+
+// Reverses the bytes of every 32-bit element. SSE2 has no byte shuffle:
+// swap the bytes of each 16-bit half, then swap the halves.
+inline __m128 byte_swap_32(__m128 value) {
+    __m128i bits = _mm_castps_si128(value);
+    bits = _mm_or_si128(_mm_slli_epi16(bits, 8), _mm_srli_epi16(bits, 8));
+    bits = _mm_shufflehi_epi16(_mm_shufflelo_epi16(bits, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_castsi128_ps(bits);
+}
+
+// SSE2 is part of x86-64, so this kernel needs no target attribute.
+// Lanes 0-3 and 4-7 live in two registers, one per group of four records.
+void run_sse2(const uint8_t* records, size_t count, WireFormat format, Threshold alarm, float limit,
+              const BatchColumns& out, BatchSummary& summary) {
+    const bool swap = format == WireFormat::V1;
+    __m128 min_lo = _mm_set1_ps(std::numeric_limits<float>::infinity()), min_hi = min_lo;
+    __m128 max_lo = _mm_set1_ps(-std::numeric_limits<float>::infinity()), max_hi = max_lo;
+    __m128 sum_lo = _mm_setzero_ps(), sum_hi = sum_lo;
+    const __m128 limits = _mm_set1_ps(limit);
+    float* values_out = out.values;
+    uint32_t* stamps_out = out.timestamps;
+    uint8_t* bits_out = out.alarm_bits;
+
+    const size_t full = count / kLanes * kLanes;
+    for (size_t i = 0; i < full; i += kLanes) {
+        const float* in = reinterpret_cast<const float*>(records + i * kBatchRecordSize);
+        // Each register holds two records: v t v t
+        __m128 r0 = _mm_loadu_ps(in), r1 = _mm_loadu_ps(in + 4);
+        __m128 r2 = _mm_loadu_ps(in + 8), r3 = _mm_loadu_ps(in + 12);
+        if (swap) {
+            r0 = byte_swap_32(r0);
+            r1 = byte_swap_32(r1);
+            r2 = byte_swap_32(r2);
+            r3 = byte_swap_32(r3);
+        }
+        __m128 values_lo = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 values_hi = _mm_shuffle_ps(r2, r3, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 stamps_lo = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 stamps_hi = _mm_shuffle_ps(r2, r3, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(values_out + i, values_lo);
+        _mm_storeu_ps(values_out + i + 4, values_hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(stamps_out + i), _mm_castps_si128(stamps_lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(stamps_out + i + 4), _mm_castps_si128(stamps_hi));
+
+        min_lo = _mm_min_ps(values_lo, min_lo);
+        min_hi = _mm_min_ps(values_hi, min_hi);
+        max_lo = _mm_max_ps(values_lo, max_lo);
+        max_hi = _mm_max_ps(values_hi, max_hi);
+        sum_lo = _mm_add_ps(sum_lo, values_lo);
+        sum_hi = _mm_add_ps(sum_hi, values_hi);
+
+        int bits = 0;
+        if (alarm == Threshold::Above) {
+            bits = _mm_movemask_ps(_mm_cmpgt_ps(values_lo, limits)) |
+                   _mm_movemask_ps(_mm_cmpgt_ps(values_hi, limits)) << 4;
+        } else if (alarm == Threshold::Below) {
+            bits = _mm_movemask_ps(_mm_cmplt_ps(values_lo, limits)) |
+                   _mm_movemask_ps(_mm_cmplt_ps(values_hi, limits)) << 4;
+        }
+        bits_out[i / kLanes] = static_cast<uint8_t>(bits);
+    }
+
+    Lanes lanes;
+    _mm_storeu_ps(lanes.min, min_lo);
+    _mm_storeu_ps(lanes.min + 4, min_hi);
+    _mm_storeu_ps(lanes.max, max_lo);
+    _mm_storeu_ps(lanes.max + 4, max_hi);
+    _mm_storeu_ps(lanes.sum, sum_lo);
+    _mm_storeu_ps(lanes.sum + 4, sum_hi);
+    decode_scalar(records, full, count, format, alarm, limit, out, lanes);
+    finish(lanes, count, out, summary);
+}
+
+// Compiled for AVX2 regardless of the build flags; only called after the CPU check
+__attribute__((target("avx2")))
+void run_avx2(const uint8_t* records, size_t count, WireFormat format, Threshold alarm, float limit,
+              const BatchColumns& out, BatchSummary& summary) {
+    const bool swap = format == WireFormat::V1;
+    // Byte order reversal within every 32-bit element, per 128-bit half
+    const __m256i swap_bytes = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    __m256 min = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    __m256 max = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    __m256 sum = _mm256_setzero_ps();
+    const __m256 limits = _mm256_set1_ps(limit);
+    float* values_out = out.values;
+    uint32_t* stamps_out = out.timestamps;
+    uint8_t* bits_out = out.alarm_bits;
+
+    const size_t full = count / kLanes * kLanes;
+    for (size_t i = 0; i < full; i += kLanes) {
+        const float* in = reinterpret_cast<const float*>(records + i * kBatchRecordSize);
+        // Four records per register: v0 t0 v1 t1 | v2 t2 v3 t3
+        __m256 r0 = _mm256_loadu_ps(in), r1 = _mm256_loadu_ps(in + 8);
+        if (swap) {
+            r0 = _mm256_castsi256_ps(_mm256_shuffle_epi8(_mm256_castps_si256(r0), swap_bytes));
+            r1 = _mm256_castsi256_ps(_mm256_shuffle_epi8(_mm256_castps_si256(r1), swap_bytes));
+        }
+        // Per 128-bit half: v0 v1 v4 v5 | v2 v3 v6 v7, then reorder the 64-bit pairs
+        __m256 values = _mm256_shuffle_ps(r0, r1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 stamps = _mm256_shuffle_ps(r0, r1, _MM_SHUFFLE(3, 1, 3, 1));
+        values = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(values), _MM_SHUFFLE(3, 1, 2, 0)));
+        stamps = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(stamps), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(values_out + i, values);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(stamps_out + i), _mm256_castps_si256(stamps));
+
+        min = _mm256_min_ps(values, min);
+        max = _mm256_max_ps(values, max);
+        sum = _mm256_add_ps(sum, values);
+
+        int bits = 0;
+        if (alarm == Threshold::Above) {
+            bits = _mm256_movemask_ps(_mm256_cmp_ps(values, limits, _CMP_GT_OQ));
+        } else if (alarm == Threshold::Below) {
+            bits = _mm256_movemask_ps(_mm256_cmp_ps(values, limits, _CMP_LT_OQ));
+        }
+        bits_out[i / kLanes] = static_cast<uint8_t>(bits);
+    }
+
+    Lanes lanes;
+    _mm256_storeu_ps(lanes.min, min);
+    _mm256_storeu_ps(lanes.max, max);
+    _mm256_storeu_ps(lanes.sum, sum);
+    // The tail and lane combine are SSE code; avoid the AVX-to-SSE transition penalty
+    _mm256_zeroupper();
+    decode_scalar(records, full, count, format, alarm, limit, out, lanes);
+    finish(lanes, count, out, summary);
+}
+
+#endif // BATCH_DECODE_X86
+
+} // namespace
+
+bool batch_kernel_supported(BatchKernel kernel) {
+    switch (kernel) {
+    case BatchKernel::Scalar:
+        return true;
+#if BATCH_DECODE_X86
+    case BatchKernel::Sse2:
+        return true;
+    case BatchKernel::Avx2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+BatchKernel active_batch_kernel() {
+    static const BatchKernel kernel = batch_kernel_supported(BatchKernel::Avx2)   ? BatchKernel::Avx2
+                                      : batch_kernel_supported(BatchKernel::Sse2) ? BatchKernel::Sse2
+                                                                                  : BatchKernel::Scalar;
+    return kernel;
+}
+
+const char* batch_kernel_name(BatchKernel kernel) {
+    switch (kernel) {
+    case BatchKernel::Avx2: return "avx2";
+    case BatchKernel::Sse2: return "sse2";
+    default: return "scalar";
+    }
+}
+
+bool decode_batch_columns_with(BatchKernel kernel, const uint8_t* records, size_t count, WireFormat format,
+                               Threshold alarm, float limit, const BatchColumns& out, BatchSummary& summary) {
+    if (!batch_kernel_supported(kernel)) return false;
+    switch (kernel) {
+#if BATCH_DECODE_X86
+    case BatchKernel::Avx2:
+        run_avx2(records, count, format, alarm, limit, out, summary);
+        break;
+    case BatchKernel::Sse2:
+        run_sse2(records, count, format, alarm, limit, out, summary);
+        break;
+#endif
+    default:
+        run_scalar(records, count, format, alarm, limit, out, summary);
+        break;
+    }
+    return true;
+}
+
+void decode_batch_columns(const uint8_t* records, size_t count, WireFormat format, Threshold alarm,
+                          float limit, const BatchColumns& out, BatchSummary& summary) {
+    decode_batch_columns_with(active_batch_kernel(), records, count, format, alarm, limit, out, summary);
+}
@@ -0,0 +1,57 @@
+#ifndef BATCH_DECODE_H
+#define BATCH_DECODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include "sensor_registry.h"
+
+// Column-wise (SoA) decode of packed batch records: (value float,
+// timestamp u32) pairs as laid out by sensor_batch.h, in either wire
+// format; the vector kernels byte-swap version 1 records in registers.
+// One pass splits the records into a value and a timestamp array, sets
+// one alarm bit per sample and accumulates min, max and sum.
+//
+// The SSE2 and AVX2 kernels are bit-exact with the scalar kernel: all of
+// them accumulate in eight interleaved lanes (sample i goes to lane i % 8)
+// and combine the lanes in the same fixed order, and min/max keep the
+// accumulator when a comparison is false, exactly like minps/maxps.
+// A NaN sample therefore never becomes the min or max and is never an alarm.
+
+enum class BatchKernel { Scalar, Sse2, Avx2 };
+
+struct BatchColumns {
+    float* values;         // count entries
+    uint32_t* timestamps;  // count entries
+    uint8_t* alarm_bits;   // (count + 7) / 8 bytes; bit i % 8 of byte i / 8 is sample i
+};
+
+struct BatchSummary {
+    float min;             // +inf for an empty batch
+    float max;             // -inf for an empty batch
+    float sum;
+    uint32_t alarms;
+};
+
+// Decodes count records at records (any alignment) with the fastest kernel
+// the CPU supports
+void decode_batch_columns(const uint8_t* records, size_t count, WireFormat format, Threshold alarm,
+                          float limit, const BatchColumns& out, BatchSummary& summary);
+
+// Same with a given kernel; false if the CPU or build does not support it
+bool decode_batch_columns_with(BatchKernel kernel, const uint8_t* records, size_t count, WireFormat format,
+                               Threshold alarm, float limit, const BatchColumns& out, BatchSummary& summary);
+
+// Kernel chosen by decode_batch_columns (probed once)
+BatchKernel active_batch_kernel();
+bool batch_kernel_supported(BatchKernel kernel);
+const char* batch_kernel_name(BatchKernel kernel);
+
+// Descriptor-typed convenience wrapper
+template <typename S>
+void decode_batch_columns(const uint8_t* records, size_t count, WireFormat format, const BatchColumns& out,
+                          BatchSummary& summary) {
+    static_assert(S::value_offset == 0 && S::timestamp_offset == 4, "batch kernels expect (value, timestamp) records");
+    decode_batch_columns(records, count, format, S::alarm, S::alarm_limit, out, summary);
+}
+
+#endif // BATCH_DECODE_H
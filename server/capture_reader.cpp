@@ -0,0 +1,97 @@
+#include "capture_reader.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CaptureReader::CaptureReader() : segment_(0), data_(nullptr), length_(0), offset_(0) {}
+
+CaptureReader::~CaptureReader() {
+    close();
+}
+
+bool CaptureReader::open(const std::string& directory, std::string& error) {
+    close();
+    directory_ = directory;
+    return rewind(error);
+}
+
+void CaptureReader::close() {
+    unmap();
+    directory_.clear();
+    error_.clear();
+}
+
+bool CaptureReader::rewind(std::string& error) {
+    unmap();
+    error_.clear();
+    segment_ = 0;
+    return map_segment(0, error);
+}
+
+bool CaptureReader::next(CaptureRecordHeader& header, PayloadView& payload) {
+    while (data_ != nullptr) {
+        PayloadView data(data_, length_);
+        if (decode_capture_record(data, offset_, header, payload)) {
+            offset_ += header.record_size;
+            return true;
+        }
+
+        // End of this segment: a missing next segment ends the capture
+        std::string path = capture_segment_path(directory_, segment_ + 1, "seg");
+        if (::access(path.c_str(), F_OK) != 0) {
+            unmap();
+            return false;
+        }
+        unmap();
+        if (!map_segment(segment_ + 1, error_)) return false;
+    }
+    return false;
+}
+
+bool CaptureReader::map_segment(uint64_t segment, std::string& error) {
+    std::string path = capture_segment_path(directory_, segment, "seg");
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(CaptureSegmentHeader))) {
+        ::close(fd);
+        error = path + " is not a capture segment";
+        return false;
+    }
+
+    size_t length = static_cast<size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        error = "cannot map " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    // Records are read front to back exactly once
+    ::madvise(mapped, length, MADV_SEQUENTIAL);
+
+    CaptureSegmentHeader header;
+    if (!decode_capture_segment_header(PayloadView(static_cast<const uint8_t*>(mapped), length), header)) {
+        ::munmap(mapped, length);
+        error = path + " has no valid segment header";
+        return false;
+    }
+
+    data_ = static_cast<const uint8_t*>(mapped);
+    length_ = length;
+    offset_ = header.header_size;
+    segment_ = segment;
+    return true;
+}
+
+void CaptureReader::unmap() {
+    if (data_ != nullptr) ::munmap(const_cast<uint8_t*>(data_), length_);
+    data_ = nullptr;
+    length_ = 0;
+    offset_ = 0;
+}
@@ -0,0 +1,48 @@
+#ifndef CAPTURE_READER_H
+#define CAPTURE_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "capture_format.h"
+
+// Sequential reader of a capture written by TrafficRecorder. Segments are
+// memory-mapped one at a time, in segment order, and records are returned
+// as views into the mapping, so reading copies nothing. A truncated last
+// record (capture cut by a crash) ends its segment.
+class CaptureReader {
+public:
+    CaptureReader();
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    // Maps the first segment in directory
+    bool open(const std::string& directory, std::string& error);
+    void close();
+
+    // Next record; payload stays valid until the following call. Returns
+    // false at the end of the capture or when a segment cannot be mapped.
+    bool next(CaptureRecordHeader& header, PayloadView& payload);
+
+    // Starts over at the first segment
+    bool rewind(std::string& error);
+
+    uint64_t segment() const { return segment_; }
+    // Set when reading stopped on an unreadable segment rather than at the end
+    const std::string& error() const { return error_; }
+
+private:
+    bool map_segment(uint64_t segment, std::string& error);
+    void unmap();
+
+    std::string directory_;
+    uint64_t segment_;
+    const uint8_t* data_;
+    size_t length_;
+    size_t offset_;
+    std::string error_;
+};
+
+#endif // CAPTURE_READER_H
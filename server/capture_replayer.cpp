@@ -0,0 +1,134 @@
+#include "capture_replayer.h"
+#include "deadline_pacer.h"
+#include "sensor_data.h"
+#include <chrono>
+#include <cstdio>
+#include <ostream>
+
+namespace {
+
+typedef std::chrono::steady_clock clock_type;
+
+// Records replayed later than this count as late
+const uint64_t kLateNs = 1000000;
+
+} // namespace
+
+bool CaptureReplayer::run(CaptureReader& reader, const ReplaySink& sink, const std::atomic<bool>& running,
+                          ReplayResult& result, std::string& error) {
+    const bool paced = config_.speed > 0.0;
+    const unsigned passes = config_.repeat == 0 ? 1 : config_.repeat;
+    const auto start = clock_type::now();
+    uint64_t busy_ns = 0;
+
+    for (unsigned pass = 0; pass < passes && running; ++pass) {
+        if (pass > 0 && !reader.rewind(error)) return false;
+
+        CaptureRecordHeader header;
+        PayloadView payload;
+        bool first = true;
+        uint64_t base_ns = 0;
+        clock_type::time_point pass_start;
+        while (running && reader.next(header, payload)) {
+            if (first) {
+                base_ns = header.receive_ns;
+                pass_start = clock_type::now();
+                first = false;
+            }
+            if (paced) {
+                // Records of one capture are in arrival order; clamp anything odd to "now"
+                uint64_t offset = header.receive_ns > base_ns ? header.receive_ns - base_ns : 0;
+                auto deadline = pass_start + std::chrono::nanoseconds(static_cast<int64_t>(offset / config_.speed));
+                sleep_then_spin_until(deadline);
+                uint64_t lag = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - deadline).count());
+                if (lag > kLateNs) ++result.late;
+                if (lag > result.max_lag_ns) result.max_lag_ns = lag;
+            }
+
+            uint64_t before = monotonic_ns();
+            bool replayed = sink(header, payload);
+            uint64_t spent = monotonic_ns() - before;
+            if (!replayed) {
+                ++result.skipped;
+                continue;
+            }
+            busy_ns += spent;
+            result.call_ns->record(spent);
+            ++result.records;
+            result.bytes += header.payload_length;
+            ++result.per_method[header.method];
+        }
+        if (!reader.error().empty()) {
+            error = reader.error();
+            return false;
+        }
+    }
+
+    result.elapsed_s = std::chrono::duration<double>(clock_type::now() - start).count();
+    result.busy_s = busy_ns / 1e9;
+    return true;
+}
+
+void CaptureReplayer::report(const ReplayResult& result, std::ostream& out) {
+    char line[160];
+    out << "📊 Replay results:\n";
+    std::snprintf(line, sizeof(line),
+                  "   • %llu records (%llu payload bytes, %llu skipped) in %.3fs → %.0f msg/s\n",
+                  static_cast<unsigned long long>(result.records), static_cast<unsigned long long>(result.bytes),
+                  static_cast<unsigned long long>(result.skipped), result.elapsed_s,
+                  result.elapsed_s > 0 ? result.records / result.elapsed_s : 0.0);
+    out << line;
+    std::snprintf(line, sizeof(line),
+                  "   • handler throughput %.0f msg/s, per call p50 %lluns p99 %lluns max %lluns\n",
+                  result.busy_s > 0 ? result.records / result.busy_s : 0.0,
+                  static_cast<unsigned long long>(result.call_ns->percentile(0.50)),
+                  static_cast<unsigned long long>(result.call_ns->percentile(0.99)),
+                  static_cast<unsigned long long>(result.call_ns->max()));
+    out << line;
+    if (result.late > 0 || result.max_lag_ns > 0) {
+        std::snprintf(line, sizeof(line), "   • schedule: %llu late (>1ms), max lag %.3fms\n",
+                      static_cast<unsigned long long>(result.late), result.max_lag_ns / 1e6);
+        out << line;
+    }
+    for (const auto& method : result.per_method) {
+        std::snprintf(line, sizeof(line), "   • [Method 0x%04X] %llu records\n", method.first,
+                      static_cast<unsigned long long>(method.second));
+        out << line;
+    }
+    out.flush();
+}
+
+HandlerReplayTarget::HandlerReplayTarget()
+    : request_(vsomeip::runtime::get()->create_request()),
+      payload_(vsomeip::runtime::get()->create_payload()) {
+    request_->set_payload(payload_);
+}
+
+bool HandlerReplayTarget::operator()(const CaptureRecordHeader& header, PayloadView payload) {
+    const bool batch = header.method == kSensorBatchMethod;
+    const bool snapshot = header.method == kSensorSnapshotMethod;
+    if (!batch && !snapshot && (header.method < Sensors::min_method || header.method > Sensors::max_method)) {
+        return false;
+    }
+
+    // The handlers never keep the request, so one object serves every record
+    request_->set_service(header.service);
+    request_->set_instance(header.instance);
+    request_->set_method(header.method);
+    request_->set_client(header.client);
+    request_->set_session(header.session);
+    request_->set_message_type(static_cast<vsomeip::message_type_e>(header.message_type));
+    request_->set_interface_version(header.interface_version);
+    request_->set_reliable(header.reliable != 0);
+    payload_->set_data(payload.data(), static_cast<vsomeip::length_t>(payload.size()));
+
+    if (batch) {
+        on_sensor_batch_message(request_);
+    } else if (snapshot) {
+        on_sensor_snapshot_message(request_);
+    } else {
+        dispatch_sensor_message(request_);
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+#ifndef CAPTURE_REPLAYER_H
+#define CAPTURE_REPLAYER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <vsomeip/vsomeip.hpp>
+#include "capture_reader.h"
+#include "latency_histogram.h"
+
+struct ReplayConfig {
+    double speed = 1.0;      // 1 = original timing, N = N times faster, 0 = as fast as possible
+    unsigned repeat = 1;     // passes over the capture
+};
+
+// Receives one record; returns false when it was not replayed (e.g. unknown method)
+typedef std::function<bool(const CaptureRecordHeader& header, PayloadView payload)> ReplaySink;
+
+struct ReplayResult {
+    uint64_t records = 0;        // handed to the sink
+    uint64_t skipped = 0;        // refused by the sink
+    uint64_t bytes = 0;          // payload bytes replayed
+    double elapsed_s = 0.0;      // wall time of the whole replay
+    double busy_s = 0.0;         // time spent inside the sink
+    uint64_t late = 0;           // records replayed more than 1 ms after their deadline
+    uint64_t max_lag_ns = 0;
+    std::map<uint16_t, uint64_t> per_method;
+    std::shared_ptr<LatencyHistogram> call_ns = std::make_shared<LatencyHistogram>();
+};
+
+// Feeds the records of a capture to a sink with the recorded spacing,
+// scaled by the speed factor, or back to back. Each pass restarts the
+// schedule at its first record. Deadlines are absolute, so a slow sink
+// makes the replay late rather than stretching the rest of the run.
+class CaptureReplayer {
+public:
+    explicit CaptureReplayer(const ReplayConfig& config) : config_(config) {}
+
+    // Replays until the capture ends repeat times or running turns false
+    bool run(CaptureReader& reader, const ReplaySink& sink, const std::atomic<bool>& running,
+             ReplayResult& result, std::string& error);
+
+    static void report(const ReplayResult& result, std::ostream& out);
+
+private:
+    ReplayConfig config_;
+};
+
+// Sink driving the gateway handlers directly: each record is rebuilt into
+// one reused request and passed to dispatch_sensor_message, or to
+// on_sensor_batch_message for batches. Other methods are skipped.
+class HandlerReplayTarget {
+public:
+    HandlerReplayTarget();
+
+    bool operator()(const CaptureRecordHeader& header, PayloadView payload);
+
+private:
+    std::shared_ptr<vsomeip::message> request_;
+    std::shared_ptr<vsomeip::payload> payload_;
+};
+
+#endif // CAPTURE_REPLAYER_H
@@ -0,0 +1,118 @@
+#include "dispatch_stage.h"
+#include <chrono>
+#include <iostream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Samples taken from one queue before the worker looks at its next queue
+static const size_t kDrainBatch = 64;
+// Empty polling rounds spent yielding before a worker starts sleeping
+static const unsigned kIdleSpins = 256;
+
+DispatchStage::DispatchStage(size_t queues, size_t capacity) : running_(false), stalls_(0) {
+    for (size_t i = 0; i < queues; ++i) {
+        queues_.emplace_back(new BoundedQueue<Item>(capacity));
+    }
+}
+
+DispatchStage::~DispatchStage() {
+    stop();
+}
+
+static void pin_to_core(std::thread &thread, size_t core) {
+#ifdef __linux__
+    unsigned cores = std::thread::hardware_concurrency();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cores ? core % cores : core, &set);
+    if (pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) != 0) {
+        std::cerr << "⚠️ Could not pin dispatch worker to CPU " << core << std::endl;
+    }
+#else
+    (void)thread;
+    (void)core;
+#endif
+}
+
+void DispatchStage::start(size_t workers, bool pin_cores) {
+    if (running() || workers == 0 || queues_.empty()) return;
+    if (workers > queues_.size()) workers = queues_.size();
+    
+    running_.store(true, std::memory_order_release);
+    for (size_t i = 0; i < workers; ++i) {
+        threads_.emplace_back(&DispatchStage::run_worker, this, i, workers);
+        if (pin_cores) pin_to_core(threads_.back(), i);
+    }
+}
+
+void DispatchStage::stop() {
+    if (!running()) return;
+    running_.store(false, std::memory_order_release);
+    for (auto &thread : threads_) thread.join();
+    threads_.clear();
+    
+    // A push that raced with stop() may have landed after the final drain
+    for (size_t i = 0; i < queues_.size(); ++i) {
+        processed_.add(drain(i, static_cast<size_t>(-1)));
+    }
+}
+
+bool DispatchStage::push(size_t queue, SampleProcessor process, const SensorSample &sample) {
+    return push_item(queue, Item{process, nullptr, sample, SensorSection{}});
+}
+
+bool DispatchStage::push(size_t queue, SectionProcessor process, const SensorSection &section) {
+    return push_item(queue, Item{nullptr, process, SensorSample{}, section});
+}
+
+bool DispatchStage::push_item(size_t queue, const Item &item) {
+    if (queue >= queues_.size() || !running()) return false;
+    if (queues_[queue]->try_push(item)) return true;
+    
+    stalls_.fetch_add(1, std::memory_order_relaxed);
+    while (!queues_[queue]->try_push(item)) {
+        if (!running()) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+size_t DispatchStage::drain(size_t queue, size_t limit) {
+    Item item;
+    size_t count = 0;
+    while (count < limit && queues_[queue]->try_pop(item)) {
+        if (item.process_section) {
+            item.process_section(item.section);
+            item.section.request.reset();   // release the message now, not at the next pop
+        } else {
+            item.process_sample(item.sample);
+        }
+        ++count;
+    }
+    return count;
+}
+
+// Worker i owns queues i, i + stride, i + 2 * stride, ...
+void DispatchStage::run_worker(size_t worker, size_t stride) {
+    unsigned idle = 0;
+    for (;;) {
+        bool stopping = !running();
+        size_t done = 0;
+        for (size_t q = worker; q < queues_.size(); q += stride) {
+            done += drain(q, kDrainBatch);
+        }
+        
+        if (done > 0) {
+            processed_.add(done);
+            idle = 0;
+        } else if (stopping) {
+            return;
+        } else if (++idle < kIdleSpins) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef DISPATCH_STAGE_H
+#define DISPATCH_STAGE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <vsomeip/vsomeip.hpp>
+#include "bounded_queue.h"
+#include "sensor_batch.h"
+#include "sensor_registry.h"
+#include "sharded_counter.h"
+#include "wire_codec.h"
+
+// One decoded sample, handed from the vsomeip dispatcher to a worker
+struct SensorSample {
+    uint16_t service;
+    uint16_t instance;
+    uint16_t client;
+    float value;
+    uint32_t timestamp;
+    bool has_extension;
+    SampleExtension extension;
+    uint64_t receive_ns;
+};
+
+// One validated batch (or snapshot section) of a single sensor method,
+// handed over together with the message that holds its records
+struct SensorSection {
+    std::shared_ptr<vsomeip::message> request;
+    SensorBatchView batch;
+    WireFormat format;
+    uint64_t receive_ns;
+};
+
+typedef void (*SampleProcessor)(const SensorSample &);
+typedef void (*SectionProcessor)(const SensorSection &);
+
+// Optional processing stage between the vsomeip dispatcher and the sensor
+// handlers. Each method has its own lock-free queue for single samples and
+// batch sections alike, and every queue is drained by exactly one worker,
+// so a method's state has a single writer and its samples are processed in
+// arrival order while different methods run in parallel.
+class DispatchStage {
+public:
+    DispatchStage(size_t queues, size_t capacity);
+    ~DispatchStage();
+
+    DispatchStage(const DispatchStage&) = delete;
+    DispatchStage& operator=(const DispatchStage&) = delete;
+
+    // Starts up to one worker per queue; with pin_cores worker i is bound to CPU i
+    void start(size_t workers, bool pin_cores);
+
+    // Stops the workers after every queued sample has been processed
+    void stop();
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+    size_t workers() const { return threads_.size(); }
+
+    // Queues a sample for its worker. Waits (yielding) while the queue is
+    // full, so a slow worker back-pressures the dispatcher instead of losing
+    // samples. Returns false when the stage is not running; the caller then
+    // processes the sample itself.
+    bool push(size_t queue, SampleProcessor process, const SensorSample &sample);
+    bool push(size_t queue, SectionProcessor process, const SensorSection &section);
+
+    // Samples and sections currently waiting in queue (approximate while workers run)
+    size_t depth(size_t queue) const {
+        return queue < queues_.size() ? queues_[queue]->size_approx() : 0;
+    }
+
+    uint64_t processed() const { return processed_.load(); }
+    // Number of pushes that found their queue full
+    uint64_t stalls() const { return stalls_.load(std::memory_order_relaxed); }
+
+private:
+    // Exactly one of the processors is set
+    struct Item {
+        SampleProcessor process_sample;
+        SectionProcessor process_section;
+        SensorSample sample;
+        SensorSection section;
+    };
+
+    bool push_item(size_t queue, const Item &item);
+    void run_worker(size_t worker, size_t stride);
+    size_t drain(size_t queue, size_t limit);
+
+    std::vector<std::unique_ptr<BoundedQueue<Item>>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<bool> running_;
+    ShardedCounter processed_;
+    std::atomic<uint64_t> stalls_;
+};
+
+#endif // DISPATCH_STAGE_H
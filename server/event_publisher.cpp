@@ -0,0 +1,120 @@
+#include "event_publisher.h"
+#include <array>
+#include <cmath>
+#include <cstring>
+
+NotificationFilter::NotificationFilter(NotificationPolicy policy) : policy_(policy) {}
+
+bool NotificationFilter::offer(float value, uint64_t now_ns) {
+    if (policy_.epsilon > 0.0f && has_last_ && std::fabs(value - last_value_) < policy_.epsilon) {
+        // Back inside the deadband: subscribers already hold a close enough value
+        ++suppressed_;
+        if (pending_) ++coalesced_;
+        pending_ = false;
+        return false;
+    }
+    if (pending_) ++coalesced_;
+    if (policy_.cycle_ms > 0 && has_last_ && now_ns - last_ns_ < policy_.cycle_ms * 1000000ull) {
+        pending_ = true;
+        return false;
+    }
+    pending_ = false;
+    return true;
+}
+
+bool NotificationFilter::due(uint64_t now_ns) {
+    return pending_ && now_ns - last_ns_ >= policy_.cycle_ms * 1000000ull;
+}
+
+void NotificationFilter::notified(float value, uint64_t now_ns) {
+    has_last_ = true;
+    last_value_ = value;
+    last_ns_ = now_ns;
+    pending_ = false;
+}
+
+SensorEventChannel::SensorEventChannel()
+    : event_(0), service_(0), instance_(0), payload_size_(0), filter_(NotificationPolicy{0.0f, 0}),
+      pending_value_(0.0f), payload_(vsomeip::runtime::get()->create_payload()), notifications_(0) {}
+
+void SensorEventChannel::configure(uint16_t event, size_t payload_size, NotificationPolicy policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    event_ = event;
+    payload_size_ = payload_size < sizeof(pending_bytes_) ? payload_size : sizeof(pending_bytes_);
+    filter_ = NotificationFilter(policy);
+    payload_->set_capacity(static_cast<vsomeip::length_t>(payload_size_));
+}
+
+void SensorEventChannel::notify_locked(uint64_t now_ns, EventSink sink) {
+    payload_->set_data(pending_bytes_, static_cast<vsomeip::length_t>(payload_size_));
+    sink(service_, instance_, event_, payload_);
+    filter_.notified(pending_value_, now_ns);
+    ++notifications_;
+}
+
+void SensorEventChannel::publish(uint16_t service, uint16_t instance, const uint8_t *bytes, float value,
+                                 uint64_t now_ns, EventSink sink) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool send = filter_.offer(value, now_ns);
+    if (send || filter_.pending()) {
+        // Newest sample wins; a pending one is sent by flush()
+        std::memcpy(pending_bytes_, bytes, payload_size_);
+        pending_value_ = value;
+        service_ = service;
+        instance_ = instance;
+    }
+    if (send) notify_locked(now_ns, sink);
+}
+
+void SensorEventChannel::flush(uint64_t now_ns, EventSink sink) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (filter_.due(now_ns)) notify_locked(now_ns, sink);
+}
+
+uint64_t SensorEventChannel::notifications() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return notifications_;
+}
+
+uint64_t SensorEventChannel::suppressed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return filter_.suppressed();
+}
+
+uint64_t SensorEventChannel::coalesced() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return filter_.coalesced();
+}
+
+SensorEventChannel* sensor_event_channel(uint16_t method) {
+    static std::array<SensorEventChannel, Sensors::max_method - Sensors::min_method + 1> channels;
+    size_t index = static_cast<size_t>(method - Sensors::min_method);
+    return index < channels.size() ? &channels[index] : nullptr;
+}
+
+static std::atomic<EventSink> event_sink(nullptr);
+
+void enable_sensor_events(EventSink sink, const NotificationPolicy *override_policy) {
+    for_each_sensor(Sensors{}, [&](auto tag) {
+        using S = typename decltype(tag)::type;
+        NotificationPolicy policy = {S::notify_epsilon, S::notify_cycle_ms};
+        sensor_event_channel(S::method_id)->configure(sensor_event_id<S>(), S::payload_size,
+                                                      override_policy ? *override_policy : policy);
+    });
+    event_sink.store(sink, std::memory_order_release);
+}
+
+void publish_sensor_event(uint16_t method, uint16_t service, uint16_t instance,
+                          const uint8_t *bytes, float value, uint64_t now_ns) {
+    EventSink sink = event_sink.load(std::memory_order_acquire);
+    SensorEventChannel* channel = sink ? sensor_event_channel(method) : nullptr;
+    if (channel) channel->publish(service, instance, bytes, value, now_ns, sink);
+}
+
+void flush_sensor_events(uint64_t now_ns) {
+    EventSink sink = event_sink.load(std::memory_order_acquire);
+    if (!sink) return;
+    for (auto method : Sensors::method_ids) {
+        sensor_event_channel(method)->flush(now_ns, sink);
+    }
+}
@@ -0,0 +1,105 @@
+#ifndef EVENT_PUBLISHER_H
+#define EVENT_PUBLISHER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vsomeip/vsomeip.hpp>
+#include "sensor_registry.h"
+
+// When a sample becomes an event. epsilon > 0 suppresses samples closer than
+// epsilon to the last notified value (deadband); cycle_ms > 0 notifies at
+// most once per cycle and coalesces the samples in between into the newest.
+struct NotificationPolicy {
+    float epsilon;
+    uint32_t cycle_ms;
+};
+
+// Per-event decision logic, independent of vsomeip
+class NotificationFilter {
+public:
+    explicit NotificationFilter(NotificationPolicy policy);
+
+    // Offers a sample received at now_ns; true when it must be notified now.
+    // Otherwise it is either dropped (deadband) or kept pending (cycle).
+    bool offer(float value, uint64_t now_ns);
+
+    // True when a pending sample's cycle has elapsed; it must be notified now
+    bool due(uint64_t now_ns);
+
+    // Records that a notification went out at now_ns with value
+    void notified(float value, uint64_t now_ns);
+
+    bool pending() const { return pending_; }
+    uint64_t suppressed() const { return suppressed_; }
+    uint64_t coalesced() const { return coalesced_; }
+
+private:
+    NotificationPolicy policy_;
+    bool has_last_ = false;
+    float last_value_ = 0.0f;
+    uint64_t last_ns_ = 0;
+    bool pending_ = false;
+    uint64_t suppressed_ = 0;
+    uint64_t coalesced_ = 0;
+};
+
+// Delivers one notification; the gateway passes app->notify
+typedef void (*EventSink)(uint16_t service, uint16_t instance, uint16_t event,
+                          const std::shared_ptr<vsomeip::payload> &payload);
+
+// Event of one sensor: filter state plus a single payload object that is
+// refilled for every notification. vsomeip copies it into the event once and
+// serializes one message for all subscribers (or one multicast datagram), so
+// fan-out never copies the sample per subscriber.
+class SensorEventChannel {
+public:
+    SensorEventChannel();
+
+    void configure(uint16_t event, size_t payload_size, NotificationPolicy policy);
+
+    // Publishes the encoded sample through sink if the filter lets it pass
+    void publish(uint16_t service, uint16_t instance, const uint8_t *bytes, float value,
+                 uint64_t now_ns, EventSink sink);
+
+    // Sends a coalesced sample whose cycle has elapsed
+    void flush(uint64_t now_ns, EventSink sink);
+
+    uint64_t notifications() const;
+    uint64_t suppressed() const;
+    uint64_t coalesced() const;
+
+private:
+    void notify_locked(uint64_t now_ns, EventSink sink);
+
+    mutable std::mutex mutex_;
+    uint16_t event_;
+    uint16_t service_;
+    uint16_t instance_;
+    size_t payload_size_;
+    NotificationFilter filter_;
+    uint8_t pending_bytes_[32];
+    float pending_value_;
+    std::shared_ptr<vsomeip::payload> payload_;
+    uint64_t notifications_;
+};
+
+// Enables sensor events: every handled sample is offered to its sensor's
+// channel with the descriptor policy, or override_policy when given.
+// Until this is called (and again after a call with a null sink) the
+// handler path skips events entirely.
+void enable_sensor_events(EventSink sink, const NotificationPolicy *override_policy);
+
+// Event channel of the given sensor method; nullptr outside Sensors
+SensorEventChannel* sensor_event_channel(uint16_t method);
+
+// Offers one handled sample to its sensor's channel (no-op while events are disabled)
+void publish_sensor_event(uint16_t method, uint16_t service, uint16_t instance,
+                          const uint8_t *bytes, float value, uint64_t now_ns);
+
+// Sends coalesced samples whose cycle has elapsed; call periodically
+void flush_sensor_events(uint64_t now_ns);
+
+#endif // EVENT_PUBLISHER_H
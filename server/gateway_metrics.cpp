@@ -0,0 +1,242 @@
+#include "gateway_metrics.h"
+#include "sensor_data.h"
+#include "traffic_recorder.h"
+#include "async_log.h"
+#include <cstdio>
+
+GatewayMetrics::GatewayMetrics() : other_client_messages_(0), other_client_bytes_(0) {
+    for (ClientSlot& slot : clients_) {
+        slot.key.store(0, std::memory_order_relaxed);
+        slot.messages.store(0, std::memory_order_relaxed);
+        slot.bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t GatewayMetrics::method_index(uint16_t method) {
+    if (method >= Sensors::min_method && method <= Sensors::max_method) return method - Sensors::min_method;
+    if (method == kSensorBatchMethod) return kMethods - 2;
+    if (method == kSensorSnapshotMethod) return kMethods - 1;
+    return kMethods;
+}
+
+uint16_t GatewayMetrics::method_at(size_t index) {
+    if (index == kMethods - 2) return kSensorBatchMethod;
+    if (index == kMethods - 1) return kSensorSnapshotMethod;
+    return static_cast<uint16_t>(Sensors::min_method + index);
+}
+
+void GatewayMetrics::record_message(uint16_t method, uint16_t client, size_t bytes, bool decoded,
+                                    uint64_t handler_ns) {
+    size_t index = method_index(method);
+    if (index == kMethods) {
+        record_unknown(client, bytes);
+        return;
+    }
+    MethodMetrics& metrics = methods_[index];
+    metrics.messages.add();
+    metrics.bytes.add(bytes);
+    if (!decoded) metrics.decode_errors.add();
+    metrics.handler_ns.record(handler_ns);
+    record_client(client, bytes);
+}
+
+void GatewayMetrics::record_unknown(uint16_t client, size_t bytes) {
+    unknown_.add();
+    record_client(client, bytes);
+}
+
+void GatewayMetrics::record_instance(uint16_t instance) {
+    size_t shard = static_cast<size_t>(instance - kFirstShardInstance);
+    instances_[shard < kMaxShards ? shard : kMaxShards].add();
+}
+
+void GatewayMetrics::record_client(uint16_t client, size_t bytes) {
+    const uint32_t key = static_cast<uint32_t>(client) + 1;
+    size_t slot = (client * 0x9E37u) % kClientSlots;
+    for (size_t probe = 0; probe < kClientSlots; ++probe, slot = (slot + 1) % kClientSlots) {
+        ClientSlot& entry = clients_[slot];
+        uint32_t seen = entry.key.load(std::memory_order_acquire);
+        if (seen == 0 && entry.key.compare_exchange_strong(seen, key, std::memory_order_acq_rel)) {
+            seen = key;
+        }
+        if (seen == key) {
+            entry.messages.fetch_add(1, std::memory_order_relaxed);
+            entry.bytes.fetch_add(bytes, std::memory_order_relaxed);
+            return;
+        }
+    }
+    other_client_messages_.fetch_add(1, std::memory_order_relaxed);
+    other_client_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+const GatewayMetrics::ClientSlot* GatewayMetrics::find_client(uint16_t client) const {
+    const uint32_t key = static_cast<uint32_t>(client) + 1;
+    size_t slot = (client * 0x9E37u) % kClientSlots;
+    for (size_t probe = 0; probe < kClientSlots; ++probe, slot = (slot + 1) % kClientSlots) {
+        uint32_t seen = clients_[slot].key.load(std::memory_order_acquire);
+        if (seen == key) return &clients_[slot];
+        if (seen == 0) return nullptr;
+    }
+    return nullptr;
+}
+
+uint64_t GatewayMetrics::messages(uint16_t method) const {
+    size_t index = method_index(method);
+    return index < kMethods ? methods_[index].messages.load() : 0;
+}
+
+uint64_t GatewayMetrics::bytes(uint16_t method) const {
+    size_t index = method_index(method);
+    return index < kMethods ? methods_[index].bytes.load() : 0;
+}
+
+uint64_t GatewayMetrics::decode_errors(uint16_t method) const {
+    size_t index = method_index(method);
+    return index < kMethods ? methods_[index].decode_errors.load() : 0;
+}
+
+const LatencyHistogram* GatewayMetrics::handler_histogram(uint16_t method) const {
+    size_t index = method_index(method);
+    return index < kMethods ? &methods_[index].handler_ns : nullptr;
+}
+
+uint64_t GatewayMetrics::client_messages(uint16_t client) const {
+    const ClientSlot* slot = find_client(client);
+    return slot ? slot->messages.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t GatewayMetrics::instance_messages(uint16_t instance) const {
+    size_t shard = static_cast<size_t>(instance - kFirstShardInstance);
+    return shard < kMaxShards ? instances_[shard].load() : 0;
+}
+
+void GatewayMetrics::reset() {
+    for (MethodMetrics& metrics : methods_) {
+        metrics.messages.reset();
+        metrics.bytes.reset();
+        metrics.decode_errors.reset();
+        metrics.handler_ns.reset();
+    }
+    for (ShardedCounter& instance : instances_) instance.reset();
+    for (ClientSlot& slot : clients_) {
+        slot.key.store(0, std::memory_order_relaxed);
+        slot.messages.store(0, std::memory_order_relaxed);
+        slot.bytes.store(0, std::memory_order_relaxed);
+    }
+    other_client_messages_.store(0, std::memory_order_relaxed);
+    other_client_bytes_.store(0, std::memory_order_relaxed);
+    unknown_.reset();
+}
+
+namespace {
+
+void append_header(std::string& out, const char* name, const char* type, const char* help) {
+    out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+    out.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+}
+
+void append_sample(std::string& out, const char* name, const char* labels, double value) {
+    char line[192];
+    std::snprintf(line, sizeof(line), "%s%s %.9g\n", name, labels, value);
+    out.append(line);
+}
+
+} // namespace
+
+std::string GatewayMetrics::snapshot() const {
+    std::string out;
+    out.reserve(8192);
+    char labels[64];
+
+    append_header(out, "gateway_messages_total", "counter", "Messages received per method");
+    for (size_t i = 0; i < kMethods; ++i) {
+        std::snprintf(labels, sizeof(labels), "{method=\"0x%04X\"}", method_at(i));
+        append_sample(out, "gateway_messages_total", labels, static_cast<double>(methods_[i].messages.load()));
+    }
+    append_header(out, "gateway_payload_bytes_total", "counter", "Payload bytes received per method");
+    for (size_t i = 0; i < kMethods; ++i) {
+        std::snprintf(labels, sizeof(labels), "{method=\"0x%04X\"}", method_at(i));
+        append_sample(out, "gateway_payload_bytes_total", labels, static_cast<double>(methods_[i].bytes.load()));
+    }
+    append_header(out, "gateway_decode_errors_total", "counter",
+                  "Payloads too short or malformed for their method, processed as zeros or dropped");
+    for (size_t i = 0; i < kMethods; ++i) {
+        std::snprintf(labels, sizeof(labels), "{method=\"0x%04X\"}", method_at(i));
+        append_sample(out, "gateway_decode_errors_total", labels,
+                      static_cast<double>(methods_[i].decode_errors.load()));
+    }
+    append_header(out, "gateway_unknown_method_messages_total", "counter", "Messages for methods without a handler");
+    append_sample(out, "gateway_unknown_method_messages_total", "", static_cast<double>(unknown_.load()));
+
+    append_header(out, "gateway_handler_seconds", "summary", "Handler time on the receiving thread per method");
+    for (size_t i = 0; i < kMethods; ++i) {
+        const LatencyHistogram& histogram = methods_[i].handler_ns;
+        static const double quantiles[] = {0.5, 0.99, 0.999};
+        for (double q : quantiles) {
+            std::snprintf(labels, sizeof(labels), "{method=\"0x%04X\",quantile=\"%g\"}", method_at(i), q);
+            append_sample(out, "gateway_handler_seconds", labels, histogram.percentile(q) / 1e9);
+        }
+        std::snprintf(labels, sizeof(labels), "{method=\"0x%04X\"}", method_at(i));
+        append_sample(out, "gateway_handler_seconds_sum", labels, histogram.mean() * histogram.count() / 1e9);
+        append_sample(out, "gateway_handler_seconds_count", labels, static_cast<double>(histogram.count()));
+    }
+
+    // Every shard of a sharded gateway shares this registry, so these sum to the process total
+    append_header(out, "gateway_instance_messages_total", "counter",
+                  "Messages received per service instance (gateway shard)");
+    for (size_t shard = 0; shard < kMaxShards; ++shard) {
+        uint64_t messages = instances_[shard].load();
+        if (messages == 0) continue;
+        std::snprintf(labels, sizeof(labels), "{instance=\"0x%04X\"}", shard_instance(shard));
+        append_sample(out, "gateway_instance_messages_total", labels, static_cast<double>(messages));
+    }
+    append_sample(out, "gateway_instance_messages_total", "{instance=\"other\"}",
+                  static_cast<double>(instances_[kMaxShards].load()));
+
+    append_header(out, "gateway_client_messages_total", "counter", "Messages received per SOME/IP client ID");
+    for (const ClientSlot& slot : clients_) {
+        uint32_t key = slot.key.load(std::memory_order_acquire);
+        if (key == 0) continue;
+        std::snprintf(labels, sizeof(labels), "{client=\"0x%04X\"}", key - 1);
+        append_sample(out, "gateway_client_messages_total", labels,
+                      static_cast<double>(slot.messages.load(std::memory_order_relaxed)));
+    }
+    append_sample(out, "gateway_client_messages_total", "{client=\"other\"}",
+                  static_cast<double>(other_client_messages_.load(std::memory_order_relaxed)));
+    append_header(out, "gateway_client_payload_bytes_total", "counter", "Payload bytes received per SOME/IP client ID");
+    for (const ClientSlot& slot : clients_) {
+        uint32_t key = slot.key.load(std::memory_order_acquire);
+        if (key == 0) continue;
+        std::snprintf(labels, sizeof(labels), "{client=\"0x%04X\"}", key - 1);
+        append_sample(out, "gateway_client_payload_bytes_total", labels,
+                      static_cast<double>(slot.bytes.load(std::memory_order_relaxed)));
+    }
+    append_sample(out, "gateway_client_payload_bytes_total", "{client=\"other\"}",
+                  static_cast<double>(other_client_bytes_.load(std::memory_order_relaxed)));
+
+    // Queue depths, sampled now
+    append_header(out, "gateway_dispatch_workers", "gauge", "Dispatch worker threads behind the handlers");
+    append_sample(out, "gateway_dispatch_workers", "", static_cast<double>(dispatch_worker_count()));
+    append_header(out, "gateway_dispatch_queue_depth", "gauge", "Samples waiting in the per-method dispatch queue");
+    for (auto method : Sensors::method_ids) {
+        std::snprintf(labels, sizeof(labels), "{method=\"0x%04X\"}", method);
+        append_sample(out, "gateway_dispatch_queue_depth", labels, static_cast<double>(dispatch_queue_depth(method)));
+    }
+    append_header(out, "gateway_log_queue_depth", "gauge", "Log records waiting for the console writer");
+    append_sample(out, "gateway_log_queue_depth", "", static_cast<double>(console_log().pending()));
+    append_header(out, "gateway_log_dropped_total", "counter", "Log records dropped because the log queue was full");
+    append_sample(out, "gateway_log_dropped_total", "", static_cast<double>(console_log().dropped()));
+
+    if (const TrafficRecorder* recorder = installed_traffic_recorder()) {
+        append_header(out, "gateway_recorder_records_total", "counter", "Messages written to the traffic capture");
+        append_sample(out, "gateway_recorder_records_total", "", static_cast<double>(recorder->records()));
+        append_header(out, "gateway_recorder_dropped_total", "counter", "Messages the traffic recorder had to drop");
+        append_sample(out, "gateway_recorder_dropped_total", "", static_cast<double>(recorder->dropped()));
+    }
+    return out;
+}
+
+GatewayMetrics& gateway_metrics() {
+    static GatewayMetrics metrics;
+    return metrics;
+}
@@ -0,0 +1,88 @@
+#ifndef GATEWAY_METRICS_H
+#define GATEWAY_METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "latency_histogram.h"
+#include "sensor_registry.h"
+#include "sensor_batch.h"
+#include "sensor_snapshot.h"
+#include "shard_ring.h"
+#include "sharded_counter.h"
+
+// Runtime statistics of the gateway's receive path. Message, byte and
+// decode error counters are sharded per thread; per-client counters live
+// in a fixed open-addressing table claimed with one CAS per new client,
+// so recording never locks or allocates. snapshot() renders everything,
+// plus queue depths sampled at that moment, in Prometheus text format.
+class GatewayMetrics {
+public:
+    // Distinct clients tracked individually; later ones are summed as "other"
+    static constexpr size_t kClientSlots = 64;
+
+    GatewayMetrics();
+
+    GatewayMetrics(const GatewayMetrics&) = delete;
+    GatewayMetrics& operator=(const GatewayMetrics&) = delete;
+
+    // Accounts one message of a sensor method, kSensorBatchMethod or kSensorSnapshotMethod.
+    // decoded is false for payloads too short for their method.
+    void record_message(uint16_t method, uint16_t client, size_t bytes, bool decoded, uint64_t handler_ns);
+
+    // Accounts a message whose method (or batch sensor) the gateway does not know
+    void record_unknown(uint16_t client, size_t bytes);
+
+    // Accounts one received message to the service instance (gateway shard) it was sent to
+    void record_instance(uint16_t instance);
+
+    uint64_t messages(uint16_t method) const;
+    uint64_t bytes(uint16_t method) const;
+    uint64_t decode_errors(uint16_t method) const;
+    uint64_t unknown_methods() const { return unknown_.load(); }
+    const LatencyHistogram* handler_histogram(uint16_t method) const;
+    // Messages seen from client; 0 for untracked clients
+    uint64_t client_messages(uint16_t client) const;
+    // Messages seen on a shard instance; instances beyond the shards are summed as "other"
+    uint64_t instance_messages(uint16_t instance) const;
+
+    // Prometheus text exposition format (version 0.0.4)
+    std::string snapshot() const;
+
+    void reset();
+
+private:
+    static constexpr size_t kMethods = Sensors::max_method - Sensors::min_method + 3;
+
+    struct MethodMetrics {
+        ShardedCounter messages;
+        ShardedCounter bytes;
+        ShardedCounter decode_errors;
+        LatencyHistogram handler_ns;
+    };
+
+    struct alignas(64) ClientSlot {
+        std::atomic<uint32_t> key;       // client + 1, 0 while free
+        std::atomic<uint64_t> messages;
+        std::atomic<uint64_t> bytes;
+    };
+
+    // Index into methods_; kMethods for methods outside the table
+    static size_t method_index(uint16_t method);
+    static uint16_t method_at(size_t index);
+    void record_client(uint16_t client, size_t bytes);
+    const ClientSlot* find_client(uint16_t client) const;
+
+    MethodMetrics methods_[kMethods];
+    ShardedCounter instances_[kMaxShards + 1];   // last one: other instances
+    ClientSlot clients_[kClientSlots];
+    std::atomic<uint64_t> other_client_messages_;
+    std::atomic<uint64_t> other_client_bytes_;
+    ShardedCounter unknown_;
+};
+
+// Process-wide metrics fed by the sensor handlers
+GatewayMetrics& gateway_metrics();
+
+#endif // GATEWAY_METRICS_H
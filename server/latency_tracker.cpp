@@ -0,0 +1,99 @@
+#include "latency_tracker.h"
+#include "async_log.h"
+#include <array>
+#include <cstdio>
+
+void SequenceTracker::observe(uint16_t client, uint16_t stream, uint32_t sequence) {
+    const uint32_t key = (uint32_t(client) << 16) | stream;
+    auto it = clients_.find(key);
+    if (it == clients_.end()) {
+        // First sample of this stream defines the starting point
+        clients_[key] = ClientState{sequence + 1};
+        return;
+    }
+    
+    ClientState& state = it->second;
+    if (sequence == state.expected) {
+        state.expected = sequence + 1;
+    } else if (static_cast<int32_t>(sequence - state.expected) > 0) {
+        // Gap: everything in between counts as lost until it shows up late
+        lost_ += sequence - state.expected;
+        state.expected = sequence + 1;
+    } else {
+        // Older than expected: a late sample that was counted as lost
+        // (duplicates are indistinguishable and also count as reordered)
+        ++reordered_;
+        if (lost_ > 0) --lost_;
+    }
+}
+
+void LatencyTracker::record(uint16_t client, const SampleExtension& ext, uint64_t receive_ns) {
+    // Clock skew can make the difference negative; count it as zero
+    histogram_.record(receive_ns > ext.send_ns ? receive_ns - ext.send_ns : 0);
+    std::lock_guard<std::mutex> lock(sequence_mutex_);
+    sequences_.observe(client, ext.stream, ext.sequence);
+}
+
+uint64_t LatencyTracker::lost() const {
+    std::lock_guard<std::mutex> lock(sequence_mutex_);
+    return sequences_.lost();
+}
+
+uint64_t LatencyTracker::reordered() const {
+    std::lock_guard<std::mutex> lock(sequence_mutex_);
+    return sequences_.reordered();
+}
+
+std::string LatencyTracker::summary() const {
+    char line[192];
+    std::snprintf(line, sizeof(line),
+                  "n=%llu p50 %.1fus p99 %.1fus p99.9 %.1fus max %.1fus lost %llu reordered %llu",
+                  static_cast<unsigned long long>(histogram_.count()),
+                  histogram_.percentile(0.50) / 1e3, histogram_.percentile(0.99) / 1e3,
+                  histogram_.percentile(0.999) / 1e3, histogram_.max() / 1e3,
+                  static_cast<unsigned long long>(lost()), static_cast<unsigned long long>(reordered()));
+    return line;
+}
+
+LatencyTracker* latency_tracker(uint16_t method) {
+    static std::array<LatencyTracker, Sensors::max_method - Sensors::min_method + 1> trackers;
+    size_t index = static_cast<size_t>(method - Sensors::min_method);
+    return index < trackers.size() ? &trackers[index] : nullptr;
+}
+
+// Snapshot formatted on the log writer thread
+struct LatencyReportArgs {
+    uint64_t count;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+    uint64_t lost;
+    uint64_t reordered;
+};
+
+template <typename S>
+static void format_latency_report(std::string& out, const void* raw) {
+    const LatencyReportArgs& args = *static_cast<const LatencyReportArgs*>(raw);
+    char line[224];
+    std::snprintf(line, sizeof(line),
+                  "⏱️ LATENCY %s [Method 0x%04X]: n=%llu p50 %.1fus p99 %.1fus p99.9 %.1fus max %.1fus "
+                  "lost %llu reordered %llu",
+                  S::label, S::method_id, static_cast<unsigned long long>(args.count),
+                  args.p50 / 1e3, args.p99 / 1e3, args.p999 / 1e3, args.max / 1e3,
+                  static_cast<unsigned long long>(args.lost),
+                  static_cast<unsigned long long>(args.reordered));
+    out.append(line);
+}
+
+void log_latency_report() {
+    for_each_sensor(Sensors{}, [](auto tag) {
+        using S = typename decltype(tag)::type;
+        const LatencyTracker& tracker = *latency_tracker(S::method_id);
+        const LatencyHistogram& histogram = tracker.histogram();
+        if (histogram.count() == 0) return;
+        console_log().post(format_latency_report<S>, LatencyReportArgs{
+            histogram.count(), histogram.percentile(0.50), histogram.percentile(0.99),
+            histogram.percentile(0.999), histogram.max(), tracker.lost(), tracker.reordered()});
+    });
+}
@@ -0,0 +1,57 @@
+#ifndef LATENCY_TRACKER_H
+#define LATENCY_TRACKER_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "latency_histogram.h"
+#include "sensor_registry.h"
+
+// Loss and reorder accounting from sequence numbers, tracked per
+// (client, stream): a client numbers every sequence stream separately
+class SequenceTracker {
+public:
+    // Feeds the next sequence number received on stream of client
+    void observe(uint16_t client, uint16_t stream, uint32_t sequence);
+
+    uint64_t lost() const { return lost_; }
+    uint64_t reordered() const { return reordered_; }
+
+private:
+    struct ClientState {
+        uint32_t expected;
+    };
+
+    // Keyed by client << 16 | stream
+    std::unordered_map<uint32_t, ClientState> clients_;
+    uint64_t lost_ = 0;
+    uint64_t reordered_ = 0;
+};
+
+// One-way latency and sequence statistics of one method
+class LatencyTracker {
+public:
+    // Records a sample carrying the latency extension, received at receive_ns
+    void record(uint16_t client, const SampleExtension& ext, uint64_t receive_ns);
+
+    const LatencyHistogram& histogram() const { return histogram_; }
+    uint64_t lost() const;
+    uint64_t reordered() const;
+
+    // "p50 ... p99 ... p99.9 ... max ... lost ... reordered" in microseconds
+    std::string summary() const;
+
+private:
+    LatencyHistogram histogram_;
+    mutable std::mutex sequence_mutex_;
+    SequenceTracker sequences_;
+};
+
+// Tracker of the given sensor method; nullptr for methods outside Sensors
+LatencyTracker* latency_tracker(uint16_t method);
+
+// Posts one summary line per sensor method that has latency samples
+void log_latency_report();
+
+#endif // LATENCY_TRACKER_H
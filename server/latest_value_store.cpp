@@ -0,0 +1,79 @@
+#include "latest_value_store.h"
+#include "latency_histogram.h"
+#include <algorithm>
+#include <vector>
+
+LatestValueStore::LatestValueStore() {
+    for (Entry& entry : entries_) entry.key.store(0, std::memory_order_relaxed);
+}
+
+bool LatestValueStore::update(uint16_t service, uint16_t instance, uint16_t method, const LatestValue& value) {
+    Entry* entry = find_claimed(entries_, make_key(service, instance, method), true);
+    // A sample received before the stored one never replaces it
+    return entry != nullptr &&
+           entry->slot.try_store_if(value, [&value](const LatestValue& current) {
+               return value.receive_ns >= current.receive_ns;
+           });
+}
+
+bool LatestValueStore::lookup(uint16_t service, uint16_t instance, uint16_t method, LatestValue& out) const {
+    const Entry* entry =
+        find_claimed(const_cast<LatestValueStore*>(this)->entries_, make_key(service, instance, method), false);
+    return entry != nullptr && entry->slot.load(out);
+}
+
+LatestValueStore& latest_values() {
+    static LatestValueStore store;
+    return store;
+}
+
+static LatestValueRecord make_record(uint16_t method, const LatestValue& value, uint64_t now_ns) {
+    LatestValueRecord record = {};
+    record.method = method;
+    record.flags = value.alarm ? kLatestFlagAlarm : 0;
+    record.value = value.value;
+    record.timestamp = value.timestamp;
+    uint64_t age_ns = now_ns > value.receive_ns ? now_ns - value.receive_ns : 0;
+    record.age_ms = static_cast<uint32_t>(std::min<uint64_t>(age_ns / 1000000, UINT32_MAX));
+    return record;
+}
+
+std::shared_ptr<vsomeip::message> make_latest_values_response(const std::shared_ptr<vsomeip::message> &request) {
+    const uint16_t service = request->get_service();
+    const uint16_t instance = request->get_instance();
+    const uint64_t now_ns = monotonic_ns();
+    PayloadView query(*request->get_payload());
+    // Method lists are read in the request's wire format (legacy for unknown versions)
+    WireFormat query_format = WireFormat::Legacy;
+    wire_format_from_interface_version(request->get_interface_version(), query_format);
+    
+    std::vector<LatestValueRecord> records;
+    if (query.size() == 0) {
+        latest_values().for_each(service, instance, [&](uint16_t method, const LatestValue& value) {
+            records.push_back(make_record(method, value, now_ns));
+        });
+        std::sort(records.begin(), records.end(),
+                  [](const LatestValueRecord& a, const LatestValueRecord& b) { return a.method < b.method; });
+    } else {
+        // Explicit method list, answered in request order; unknown methods are skipped
+        for (size_t offset = 0; records.size() < LatestValueStore::kCapacity && query.contains(offset, sizeof(uint16_t));
+             offset += sizeof(uint16_t)) {
+            const uint16_t method = load_wire<uint16_t>(query_format, query.data() + offset);
+            LatestValue value;
+            if (latest_values().lookup(service, instance, method, value)) {
+                records.push_back(make_record(method, value, now_ns));
+            }
+        }
+    }
+    
+    std::vector<vsomeip::byte_t> bytes(latest_values_payload_size(records.size()));
+    encode_latest_header(static_cast<uint16_t>(records.size()), bytes.data(), kCurrentWireFormat);
+    for (size_t i = 0; i < records.size(); ++i) {
+        encode_latest_record(records[i], i, bytes.data(), kCurrentWireFormat);
+    }
+    
+    auto response = vsomeip::runtime::get()->create_response(request);
+    response->set_interface_version(interface_version_of(kCurrentWireFormat));
+    response->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    return response;
+}
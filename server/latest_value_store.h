@@ -0,0 +1,77 @@
+#ifndef LATEST_VALUE_STORE_H
+#define LATEST_VALUE_STORE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vsomeip/vsomeip.hpp>
+#include "claimed_table.h"
+#include "latest_values.h"
+#include "seqlock.h"
+#include "shard_ring.h"
+
+// Most recent sample of one sensor method
+struct LatestValue {
+    float value;
+    uint32_t timestamp;
+    uint64_t receive_ns;
+    bool alarm;
+};
+
+// Latest value per (service, instance, method) in a fixed open-addressing
+// table (claimed_table.h): keys are claimed with a CAS and never removed;
+// values live in seqlock slots, so handler-side updates never block and any
+// number of readers can poll concurrently. Each key has one writer, the
+// worker (or dispatcher) of its sensor method. Gateway shard instances are one logical
+// instance (logical_instance()), so a query on any shard sees the samples
+// every shard received.
+class LatestValueStore {
+public:
+    static constexpr size_t kCapacity = 64;
+
+    LatestValueStore();
+
+    LatestValueStore(const LatestValueStore&) = delete;
+    LatestValueStore& operator=(const LatestValueStore&) = delete;
+
+    // Returns false when the table is full, a sample received later
+    // (value.receive_ns) is already stored for the key, or a concurrent
+    // update of the key was in progress
+    bool update(uint16_t service, uint16_t instance, uint16_t method, const LatestValue& value);
+
+    // Returns false when no value has been stored for the key
+    bool lookup(uint16_t service, uint16_t instance, uint16_t method, LatestValue& out) const;
+
+    // Calls visit(method, value) for every stored method of service/instance
+    template <typename F>
+    void for_each(uint16_t service, uint16_t instance, F visit) const {
+        for (const Entry& entry : entries_) {
+            uint64_t key = entry.key.load(std::memory_order_acquire);
+            if (key == 0 || (key >> 16) != (make_key(service, instance, 0) >> 16)) continue;
+            LatestValue value;
+            if (entry.slot.load(value)) visit(static_cast<uint16_t>(key & 0xFFFF), value);
+        }
+    }
+
+private:
+    struct Entry {
+        std::atomic<uint64_t> key;   // 0 = free
+        SeqlockSlot<LatestValue> slot;
+    };
+
+    // Bit 63 marks a claimed key, so a valid key is never 0
+    static uint64_t make_key(uint16_t service, uint16_t instance, uint16_t method) {
+        return (uint64_t(1) << 63) | (uint64_t(service) << 32) | (uint64_t(logical_instance(instance)) << 16) | method;
+    }
+
+    Entry entries_[kCapacity];
+};
+
+// Process-wide store fed by the sensor handlers
+LatestValueStore& latest_values();
+
+// Builds the kLatestValuesMethod response for request from latest_values()
+std::shared_ptr<vsomeip::message> make_latest_values_response(const std::shared_ptr<vsomeip::message> &request);
+
+#endif // LATEST_VALUE_STORE_H
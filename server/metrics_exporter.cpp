@@ -0,0 +1,134 @@
+#include "metrics_exporter.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// A client gets this long to send its request line before the snapshot goes out
+static const int kRequestTimeoutMs = 100;
+
+MetricsExporter::MetricsExporter(const MetricsExporterConfig& config, SnapshotFunction snapshot)
+    : config_(config), snapshot_(snapshot), listen_fd_(-1), running_(false) {
+    wake_fds_[0] = wake_fds_[1] = -1;
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start(std::string& error) {
+    if (running_) return true;
+    if (::pipe2(wake_fds_, O_CLOEXEC) != 0) {
+        error = std::string("cannot create metrics wake pipe: ") + std::strerror(errno);
+        return false;
+    }
+
+    if (!config_.socket.empty()) {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (config_.socket.size() >= sizeof(address.sun_path)) {
+            error = "metrics socket path too long: " + config_.socket;
+            return false;
+        }
+        std::strncpy(address.sun_path, config_.socket.c_str(), sizeof(address.sun_path) - 1);
+        ::unlink(config_.socket.c_str());
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0 || ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::listen(listen_fd_, 8) != 0) {
+            error = "cannot listen on " + config_.socket + ": " + std::strerror(errno);
+            if (listen_fd_ >= 0) ::close(listen_fd_);
+            listen_fd_ = -1;
+            return false;
+        }
+    }
+
+    running_ = true;
+    thread_ = std::thread(&MetricsExporter::run, this);
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (running_.exchange(false)) {
+        // A failed wake-up only delays the exit to the end of the current interval
+        char wake = 0;
+        ssize_t woken = ::write(wake_fds_[1], &wake, 1);
+        (void)woken;
+        thread_.join();
+        write_file();
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        ::unlink(config_.socket.c_str());
+        listen_fd_ = -1;
+    }
+    for (int& fd : wake_fds_) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+}
+
+bool MetricsExporter::write_file() const {
+    if (config_.file.empty()) return true;
+    const std::string temporary = config_.file + ".tmp";
+    std::FILE* out = std::fopen(temporary.c_str(), "w");
+    if (out == nullptr) return false;
+    const std::string text = snapshot_();
+    bool ok = std::fwrite(text.data(), 1, text.size(), out) == text.size();
+    ok = std::fclose(out) == 0 && ok;
+    // Readers see either the previous or the new snapshot, never a partial one
+    return ok && std::rename(temporary.c_str(), config_.file.c_str()) == 0;
+}
+
+void MetricsExporter::run() {
+    auto next_file = std::chrono::steady_clock::now();
+    while (running_) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_file) {
+            write_file();
+            next_file = now + config_.interval;
+        }
+        int timeout = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            next_file - std::chrono::steady_clock::now()).count());
+
+        pollfd fds[2] = {{wake_fds_[0], POLLIN, 0}, {listen_fd_, POLLIN, 0}};
+        int ready = ::poll(fds, listen_fd_ >= 0 ? 2 : 1, timeout < 0 ? 0 : timeout);
+        if (ready <= 0 || !running_) continue;
+        if (listen_fd_ >= 0 && (fds[1].revents & POLLIN)) {
+            int connection = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (connection >= 0) {
+                serve_connection(connection);
+                ::close(connection);
+            }
+        }
+    }
+}
+
+void MetricsExporter::serve_connection(int fd) const {
+    // An HTTP client sends "GET ..." first; a plain reader sends nothing
+    char request[512];
+    ssize_t received = 0;
+    pollfd readable = {fd, POLLIN, 0};
+    if (::poll(&readable, 1, kRequestTimeoutMs) > 0) {
+        received = ::recv(fd, request, sizeof(request), MSG_DONTWAIT);
+    }
+    const bool http = received >= 4 && std::memcmp(request, "GET ", 4) == 0;
+
+    std::string text = snapshot_();
+    if (http) {
+        text = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+               std::to_string(text.size()) + "\r\n\r\n" + text;
+    }
+    const char* data = text.data();
+    size_t remaining = text.size();
+    while (remaining > 0) {
+        ssize_t sent = ::send(fd, data, remaining, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return;
+        data += sent;
+        remaining -= static_cast<size_t>(sent);
+    }
+}
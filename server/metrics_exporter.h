@@ -0,0 +1,54 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+struct MetricsExporterConfig {
+    // Rewritten every interval (atomically, via rename); empty disables the file
+    std::string file;
+    // Unix domain socket answering each connection with one snapshot; empty disables it
+    std::string socket;
+    std::chrono::milliseconds interval{5000};
+};
+
+// Background thread exporting metric snapshots in Prometheus text format.
+// The file suits node_exporter's textfile collector; the socket answers a
+// plain connection (e.g. "nc -U") with the snapshot and an HTTP GET with a
+// minimal HTTP/1.0 response, so a scraper can read it through a proxy.
+// Snapshots are produced on the exporter thread only.
+class MetricsExporter {
+public:
+    typedef std::function<std::string()> SnapshotFunction;
+
+    MetricsExporter(const MetricsExporterConfig& config, SnapshotFunction snapshot);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Binds the socket and starts the exporter thread
+    bool start(std::string& error);
+
+    // Writes a final file snapshot and removes the socket
+    void stop();
+
+    // Writes the file snapshot now; false if it could not be written
+    bool write_file() const;
+
+private:
+    void run();
+    void serve_connection(int fd) const;
+
+    const MetricsExporterConfig config_;
+    const SnapshotFunction snapshot_;
+    int listen_fd_;
+    int wake_fds_[2];
+    std::atomic<bool> running_;
+    std::thread thread_;
+};
+
+#endif // METRICS_EXPORTER_H
@@ -0,0 +1,145 @@
+// replay.cpp - Deterministic replay of a gateway traffic capture
+#include <vsomeip/vsomeip.hpp>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "async_log.h"
+#include "capture_reader.h"
+#include "capture_replayer.h"
+#include "replay_options.h"
+#include "sensor_data.h"
+#include "shard_ring.h"
+
+static std::atomic<bool> running(true);
+static std::atomic<bool> shard_available[kMaxShards];
+
+static void on_signal(int) {
+    running = false;
+}
+
+// Sink sending each record through the real vsomeip path. The request is
+// reused while vsomeip holds no reference to it, as in the client's pool.
+class VsomeipReplayTarget {
+public:
+    explicit VsomeipReplayTarget(std::shared_ptr<vsomeip::application> app)
+        : app_(app), payload_(vsomeip::runtime::get()->create_payload()) {
+        request_ = make_request();
+    }
+
+    bool operator()(const CaptureRecordHeader& header, PayloadView payload) {
+        if (request_.use_count() > 1) request_ = make_request();
+        request_->set_service(header.service);
+        request_->set_instance(header.instance);
+        request_->set_method(header.method);
+        request_->set_message_type(static_cast<vsomeip::message_type_e>(header.message_type));
+        request_->set_interface_version(header.interface_version);
+        request_->set_reliable(header.reliable != 0);
+        payload_->set_data(payload.data(), static_cast<vsomeip::length_t>(payload.size()));
+        app_->send(request_);
+        return true;
+    }
+
+private:
+    std::shared_ptr<vsomeip::message> make_request() {
+        auto request = vsomeip::runtime::get()->create_request();
+        payload_ = vsomeip::runtime::get()->create_payload();
+        request->set_payload(payload_);
+        return request;
+    }
+
+    std::shared_ptr<vsomeip::application> app_;
+    std::shared_ptr<vsomeip::payload> payload_;
+    std::shared_ptr<vsomeip::message> request_;
+};
+
+static bool replay_in_process(const ReplayOptions& options, CaptureReader& reader,
+                              ReplayResult& result, std::string& error) {
+    if (options.workers > 0) start_dispatch_workers(options.workers, false);
+    HandlerReplayTarget target;
+    CaptureReplayer replayer(options.config);
+    bool ok = replayer.run(reader, std::ref(target), running, result, error);
+    stop_dispatch_workers();
+    return ok;
+}
+
+static bool replay_over_vsomeip(const ReplayOptions& options, CaptureReader& reader,
+                                ReplayResult& result, std::string& error) {
+    auto app = vsomeip::runtime::get()->create_application("capture_replay");
+    if (!app->init()) {
+        error = "vsomeip application could not be initialized";
+        return false;
+    }
+    // Records keep the shard instance that received them, so every shard must be up
+    for (size_t shard = 0; shard < options.shards; ++shard) {
+        shard_available[shard] = false;
+        app->register_availability_handler(0x1234, shard_instance(shard),
+            [shard](vsomeip::service_t, vsomeip::instance_t, bool available) { shard_available[shard] = available; });
+        app->request_service(0x1234, shard_instance(shard));
+    }
+    auto all_available = [&options]() {
+        for (size_t shard = 0; shard < options.shards; ++shard) {
+            if (!shard_available[shard]) return false;
+        }
+        return true;
+    };
+    std::thread vsomeip_thread([app]() { app->start(); });
+
+    auto wait_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (running && !all_available() && std::chrono::steady_clock::now() < wait_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    bool ok = false;
+    if (!all_available()) {
+        error = "Central Gateway not available, replay aborted";
+    } else {
+        VsomeipReplayTarget target(app);
+        CaptureReplayer replayer(options.config);
+        ok = replayer.run(reader, std::ref(target), running, result, error);
+    }
+    app->stop();
+    vsomeip_thread.join();
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    ReplayOptions options;
+    std::string error;
+    if (!parse_replay_options(argc, argv, options, error)) {
+        std::cerr << "❌ " << error << std::endl;
+        print_replay_usage(argv[0]);
+        return 1;
+    }
+
+    CaptureReader reader;
+    if (!reader.open(options.directory, error)) {
+        std::cerr << "❌ " << error << std::endl;
+        return 1;
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    console_log().set_enabled(options.verbose);
+
+    std::cout << "⏯️  Replaying " << options.directory << " → "
+              << (options.vsomeip ? "vsomeip gateway" : "in-process handlers") << ", ";
+    if (options.config.speed > 0.0) {
+        std::cout << options.config.speed << "x recorded timing";
+    } else {
+        std::cout << "as fast as possible";
+    }
+    std::cout << ", " << options.config.repeat << " pass(es)" << std::endl;
+
+    ReplayResult result;
+    bool ok = options.vsomeip ? replay_over_vsomeip(options, reader, result, error)
+                              : replay_in_process(options, reader, result, error);
+    console_log().flush();
+    if (!ok) {
+        std::cerr << "❌ " << error << std::endl;
+        return 1;
+    }
+    CaptureReplayer::report(result, std::cout);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "replay_options.h"
+#include "shard_ring.h"
+#include <cstdlib>
+#include <iostream>
+
+// Parses a non-negative integer option value
+static bool parse_count(const char* text, unsigned long& out) {
+    if (text == nullptr || *text == '\0' || *text == '-') return false;
+    char* end = nullptr;
+    out = std::strtoul(text, &end, 10);
+    return *end == '\0';
+}
+
+bool parse_replay_options(int argc, char** argv, ReplayOptions& out, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        unsigned long number = 0;
+
+        if (arg == "--speed") {
+            char* end = nullptr;
+            double speed = value ? std::strtod(value, &end) : 0.0;
+            if (value == nullptr || *end != '\0' || !(speed > 0.0)) {
+                error = "--speed expects a positive factor";
+                return false;
+            }
+            out.config.speed = speed;
+            ++i;
+        } else if (arg == "--fast") {
+            out.config.speed = 0.0;
+        } else if (arg == "--repeat") {
+            if (!parse_count(value, number) || number == 0) {
+                error = "--repeat expects a positive number of passes";
+                return false;
+            }
+            out.config.repeat = static_cast<unsigned>(number);
+            ++i;
+        } else if (arg == "--vsomeip") {
+            out.vsomeip = true;
+        } else if (arg == "--workers") {
+            if (!parse_count(value, number)) {
+                error = "--workers expects a number of dispatch workers";
+                return false;
+            }
+            out.workers = number;
+            ++i;
+        } else if (arg == "--shards") {
+            if (!parse_count(value, number) || number == 0 || number > kMaxShards) {
+                error = "--shards expects 1 to " + std::to_string(kMaxShards) + " gateway instances";
+                return false;
+            }
+            out.shards = number;
+            ++i;
+        } else if (arg == "--verbose") {
+            out.verbose = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            error = "unknown option " + arg;
+            return false;
+        } else if (out.directory.empty()) {
+            out.directory = arg;
+        } else {
+            error = "only one capture directory can be replayed";
+            return false;
+        }
+    }
+    if (out.directory.empty()) {
+        error = "missing capture directory";
+        return false;
+    }
+    return true;
+}
+
+void print_replay_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] CAPTURE_DIR\n"
+              << "  --speed X       replay X times faster than recorded (default 1 = original timing)\n"
+              << "  --fast          replay as fast as possible\n"
+              << "  --repeat N      replay the capture N times (default 1)\n"
+              << "  --vsomeip       send through vsomeip to the running gateway instead of calling\n"
+              << "                  the handlers in-process\n"
+              << "  --workers N     in-process only: dispatch workers behind the handlers\n"
+              << "  --shards N      vsomeip only: wait for gateway instances 0x0001..N; records go to\n"
+              << "                  the instance that received them\n"
+              << "  --verbose       keep the per-sample handler log on\n";
+}
@@ -0,0 +1,29 @@
+#ifndef REPLAY_OPTIONS_H
+#define REPLAY_OPTIONS_H
+
+#include <cstddef>
+#include <string>
+#include "capture_replayer.h"
+
+// Command-line options of the capture replay tool
+struct ReplayOptions {
+    // Capture directory written by the gateway's --record
+    std::string directory;
+    // Timing and passes over the capture
+    ReplayConfig config;
+    // Send through a vsomeip application instead of calling the handlers in-process
+    bool vsomeip = false;
+    // Dispatch workers behind the handlers, as the gateway's --workers
+    size_t workers = 0;
+    // vsomeip only: gateway shard instances to request, as the gateway's --shards
+    size_t shards = 1;
+    // Keep the per-sample handler log on (off by default so it does not dominate the run)
+    bool verbose = false;
+};
+
+// Parses argv into out; on failure returns false and describes the problem in error
+bool parse_replay_options(int argc, char** argv, ReplayOptions& out, std::string& error);
+
+void print_replay_usage(const char* program);
+
+#endif // REPLAY_OPTIONS_H
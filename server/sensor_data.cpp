@@ -1,85 +1,401 @@
 #include "sensor_data.h"
+#include "async_log.h"
+#include "latency_tracker.h"
+#include "dispatch_stage.h"
+#include "latest_value_store.h"
+#include "sensor_history.h"
+#include "event_publisher.h"
+#include "traffic_recorder.h"
+#include "gateway_metrics.h"
+#include "batch_decode.h"
+#include "alert_engine.h"
 #include <vsomeip/vsomeip.hpp>
+#include <atomic>
 #include <cstring>
-#include <iostream>
-#include <iomanip>
+#include <cstdio>
+#include <vector>
 
-// Global message counter
-int message_count = 0;
+// Global message counter, sharded so concurrent handlers do not contend
+static ShardedCounter message_count;
+
+int get_message_count() {
+    return static_cast<int>(message_count.load());
+}
+
+void reset_message_count() {
+    message_count.reset();
+}
+
+// Specialized decoding functions, reading in place from the payload view
+bool decode_speed_data(PayloadView payload, SpeedData& out) {
+    return decode_sensor_data<SpeedSensor>(payload, out);
+}
+
+bool decode_engine_temp_data(PayloadView payload, EngineTemperatureData& out) {
+    return decode_sensor_data<EngineTempSensor>(payload, out);
+}
+
+bool decode_ambient_temp_data(PayloadView payload, AmbientTemperatureData& out) {
+    return decode_sensor_data<AmbientTempSensor>(payload, out);
+}
 
 // Specialized deserialization functions
-SpeedData deserialize_speed_data(const std::vector<uint8_t>& payload) {
+SpeedData deserialize_speed_data(PayloadView payload) {
     SpeedData data = {0};
-    if (payload.size() >= 8) {
-        // Extract speed (4 bytes)
-        std::memcpy(&data.speed_kmh, payload.data(), 4);
-        // Extract timestamp (4 bytes)
-        std::memcpy(&data.timestamp, payload.data() + 4, 4);
-    }
+    decode_speed_data(payload, data);
     return data;
 }
 
-EngineTemperatureData deserialize_engine_temp_data(const std::vector<uint8_t>& payload) {
+EngineTemperatureData deserialize_engine_temp_data(PayloadView payload) {
     EngineTemperatureData data = {0};
-    if (payload.size() >= 8) {
-        // Extract temperature (4 bytes)
-        std::memcpy(&data.temperature_celsius, payload.data(), 4);
-        // Extract timestamp (4 bytes)
-        std::memcpy(&data.timestamp, payload.data() + 4, 4);
-    }
+    decode_engine_temp_data(payload, data);
     return data;
 }
 
-AmbientTemperatureData deserialize_ambient_temp_data(const std::vector<uint8_t>& payload) {
+AmbientTemperatureData deserialize_ambient_temp_data(PayloadView payload) {
     AmbientTemperatureData data = {0};
-    if (payload.size() >= 8) {
-        // Extract temperature (4 bytes)
-        std::memcpy(&data.temperature_celsius, payload.data(), 4);
-        // Extract timestamp (4 bytes)
-        std::memcpy(&data.timestamp, payload.data() + 4, 4);
-    }
+    decode_ambient_temp_data(payload, data);
     return data;
 }
 
-// Message handler functions
-void on_speed_message(const std::shared_ptr<vsomeip::message> &request) {
-    auto payload = request->get_payload();
-    std::vector<uint8_t> data(payload->get_data(), payload->get_data() + payload->get_length());
+SpeedData deserialize_speed_data(const std::vector<uint8_t>& payload) {
+    return deserialize_speed_data(PayloadView(payload));
+}
+
+EngineTemperatureData deserialize_engine_temp_data(const std::vector<uint8_t>& payload) {
+    return deserialize_engine_temp_data(PayloadView(payload));
+}
+
+AmbientTemperatureData deserialize_ambient_temp_data(const std::vector<uint8_t>& payload) {
+    return deserialize_ambient_temp_data(PayloadView(payload));
+}
+
+// Binary log record captured on the dispatcher thread; formatted by the log writer
+struct SensorLogArgs {
+    int count;
+    float value;
+};
+
+template <typename S>
+static void format_sensor_line(std::string& out, const void* raw) {
+    const SensorLogArgs& args = *static_cast<const SensorLogArgs*>(raw);
+    char line[128];
+    std::snprintf(line, sizeof(line), "[#%4d] %s: %5.1f%s%s [Method 0x%04X]",
+                  args.count, S::label, args.value, S::unit,
+                  is_alarm<S>(args.value) ? S::alarm_text : "", S::method_id);
+    out.append(line);
+}
+
+// Second half of a sensor message: counting, latency and logging. Runs on the
+// vsomeip dispatcher or, with the dispatch stage enabled, on a worker.
+template <typename S>
+static void process_sensor_sample(const SensorSample &sample) {
+    message_count.add();
+    latest_values().update(sample.service, sample.instance, S::method_id,
+                           LatestValue{sample.value, sample.timestamp, sample.receive_ns, is_alarm<S>(sample.value)});
+    sensor_history(S::method_id)->add(sample.value, sample.receive_ns);
+    alert_engine().evaluate(S::method_id, sample.service, sample.instance, sample.value, sample.receive_ns);
     
-    auto speed_data = deserialize_speed_data(data);
-    message_count++;
+    typename S::data_type data = {};
+    data.*S::value = sample.value;
+    data.timestamp = sample.timestamp;
+    uint8_t bytes[S::payload_size];
+    encode_sensor_data<S>(data, bytes, kCurrentWireFormat);
+    publish_sensor_event(S::method_id, sample.service, sample.instance, bytes, sample.value, sample.receive_ns);
+    if (sample.has_extension) {
+        latency_tracker(S::method_id)->record(sample.client, sample.extension, sample.receive_ns);
+    }
     
-    std::cout << std::fixed << std::setprecision(1);
-    std::cout << "[#" << std::setw(4) << message_count << "] ";
-    std::cout << "🏃 SPEED: " << std::setw(5) << speed_data.speed_kmh << " km/h";
-    if (speed_data.speed_kmh > 100.0) std::cout << " ⚠️ HIGH SPEED!";
-    std::cout << " [Method 0x0001]" << std::endl;
+    if (kLogPerMessage) {
+        console_log().post(format_sensor_line<S>, SensorLogArgs{get_message_count(), sample.value});
+    }
 }
 
-void on_engine_temp_message(const std::shared_ptr<vsomeip::message> &request) {
-    auto payload = request->get_payload();
-    std::vector<uint8_t> data(payload->get_data(), payload->get_data() + payload->get_length());
+static DispatchStage& dispatch_stage() {
+    static DispatchStage stage(Sensors::max_method - Sensors::min_method + 1, 4096);
+    return stage;
+}
+
+// Generic handler body, instantiated once per descriptor: decodes on the
+// calling thread and hands the sample to the dispatch stage when it runs.
+// Returns false when the payload was too short; such a sample is never
+// ingested, so latest values, history, alerts and events keep the last good one.
+template <typename S>
+static bool handle_sensor_message(const std::shared_ptr<vsomeip::message> &request, WireFormat format) {
+    PayloadView payload(*request->get_payload());
+    typename S::data_type data = {};
+    if (!decode_sensor_data<S>(payload, data, format)) return false;
+    
+    SensorSample sample = {};
+    sample.receive_ns = monotonic_ns();
+    sample.service = request->get_service();
+    sample.instance = request->get_instance();
+    sample.client = request->get_client();
+    sample.value = data.*S::value;
+    sample.timestamp = data.timestamp;
+    sample.has_extension = decode_sample_extension<S>(payload, sample.extension, format);
+    
+    if (!dispatch_stage().push(S::method_id - Sensors::min_method, process_sensor_sample<S>, sample)) {
+        process_sensor_sample<S>(sample);
+    }
+    return true;
+}
+
+// One log record summarizes a whole batch or snapshot section
+struct BatchLogArgs {
+    int count;
+    uint32_t samples;
+    uint32_t alarms;
+    float min;
+    float max;
+    float last;
+    uint16_t method;       // kSensorBatchMethod or kSensorSnapshotMethod
+};
+
+template <typename S>
+static void format_batch_line(std::string& out, const void* raw) {
+    const BatchLogArgs& args = *static_cast<const BatchLogArgs*>(raw);
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "[#%4d] 📦 BATCH %s x%u: min %5.1f max %5.1f last %5.1f%s%s [Method 0x%04X]",
+                  args.count, S::label, args.samples, args.min, args.max, args.last, S::unit,
+                  args.alarms ? S::alarm_text : "", args.method);
+    out.append(line);
+}
+
+// Decodes every record of a validated batch (or snapshot section) in one
+// column-wise pass, straight from the received payload. Runs on the vsomeip
+// dispatcher or, with the dispatch stage enabled, on the method's worker.
+template <typename S>
+static void handle_sensor_batch(const SensorSection &section) {
+    const vsomeip::message &request = *section.request;
+    const SensorBatchView &batch = section.batch;
+    const WireFormat format = section.format;
+    const uint64_t receive_ns = section.receive_ns;
+    if (batch.count == 0) return;
     
-    auto engine_data = deserialize_engine_temp_data(data);
-    message_count++;
+    // Per-thread columns, sized for the largest batch seen so far
+    static thread_local std::vector<float> values;
+    static thread_local std::vector<uint32_t> timestamps;
+    static thread_local std::vector<uint8_t> alarm_bits;
+    if (values.size() < batch.count) {
+        values.resize(batch.count);
+        timestamps.resize(batch.count);
+        alarm_bits.resize((batch.count + 7) / 8);
+    }
+    BatchSummary summary;
+    decode_batch_columns<S>(batch.records.data(), batch.count, format,
+                            BatchColumns{values.data(), timestamps.data(), alarm_bits.data()}, summary);
+    
+    SensorHistory* history = sensor_history(S::method_id);
+    for (size_t i = 0; i < batch.count; ++i) {
+        history->add(values[i], receive_ns);
+    }
+    alert_engine().evaluate(S::method_id, request.get_service(), request.get_instance(), values.data(), batch.count,
+                            receive_ns);
+    BatchLogArgs args = {0, batch.count, summary.alarms, summary.min, summary.max, values[batch.count - 1],
+                         request.get_method()};
+    typename S::data_type data = {};
+    data.*S::value = args.last;
+    data.timestamp = timestamps[batch.count - 1];
+    message_count.add(batch.count);
+    args.count = get_message_count();
+    latest_values().update(request.get_service(), request.get_instance(), S::method_id,
+                           LatestValue{args.last, data.timestamp, receive_ns, is_alarm<S>(args.last)});
     
-    std::cout << std::fixed << std::setprecision(1);
-    std::cout << "[#" << std::setw(4) << message_count << "] ";
-    std::cout << "🔥 ENGINE: " << std::setw(5) << engine_data.temperature_celsius << "°C";
-    if (engine_data.temperature_celsius > 100.0) std::cout << " 🚨 OVERHEAT!";
-    std::cout << " [Method 0x0002]" << std::endl;
+    // Subscribers get the newest sample of the batch
+    uint8_t bytes[S::payload_size];
+    encode_sensor_data<S>(data, bytes, kCurrentWireFormat);
+    publish_sensor_event(S::method_id, request.get_service(), request.get_instance(), bytes, args.last, receive_ns);
+    
+    if (kLogPerMessage) {
+        console_log().post(format_batch_line<S>, args);
+    }
+}
+
+// Per-method entry points; requests in an unknown wire format are dropped
+template <typename S>
+static void handle_versioned_message(const std::shared_ptr<vsomeip::message> &request) {
+    WireFormat format;
+    if (wire_format_from_interface_version(request->get_interface_version(), format)) {
+        handle_sensor_message<S>(request, format);
+    }
+}
+
+// Message handler functions
+void on_speed_message(const std::shared_ptr<vsomeip::message> &request) {
+    handle_versioned_message<SpeedSensor>(request);
+}
+
+void on_engine_temp_message(const std::shared_ptr<vsomeip::message> &request) {
+    handle_versioned_message<EngineTempSensor>(request);
 }
 
 void on_ambient_temp_message(const std::shared_ptr<vsomeip::message> &request) {
-    auto payload = request->get_payload();
-    std::vector<uint8_t> data(payload->get_data(), payload->get_data() + payload->get_length());
+    handle_versioned_message<AmbientTempSensor>(request);
+}
+
+// Flat jump table from (method - min_method) to the generated handler
+typedef bool (*SensorHandler)(const std::shared_ptr<vsomeip::message> &, WireFormat);
+
+template <typename... S>
+static constexpr auto build_dispatch_table(SensorList<S...>) {
+    using List = SensorList<S...>;
+    std::array<SensorHandler, List::max_method - List::min_method + 1> table = {};
+    ((table[S::method_id - List::min_method] = &handle_sensor_message<S>), ...);
+    return table;
+}
+
+static constexpr auto dispatch_table = build_dispatch_table(Sensors{});
+
+// Same layout for batches, keyed by the sensor method in the batch header
+template <typename... S>
+static constexpr auto build_batch_table(SensorList<S...>) {
+    using List = SensorList<S...>;
+    std::array<SectionProcessor, List::max_method - List::min_method + 1> table = {};
+    ((table[S::method_id - List::min_method] = &handle_sensor_batch<S>), ...);
+    return table;
+}
+
+static constexpr auto batch_table = build_batch_table(Sensors{});
+
+// Hands a batch section to its method's worker, like single samples, so each
+// method keeps one writer; processes it here when the stage is not running
+static bool process_sensor_section(const std::shared_ptr<vsomeip::message> &request, const SensorBatchView &batch,
+                                   WireFormat format, uint64_t receive_ns) {
+    size_t index = static_cast<size_t>(batch.method - Sensors::min_method);
+    if (index >= batch_table.size() || !batch_table[index]) return false;
+    SensorSection section = {request, batch, format, receive_ns};
+    if (!dispatch_stage().push(index, batch_table[index], section)) {
+        batch_table[index](section);
+    }
+    return true;
+}
+
+static std::atomic<ResponseSink> response_sink(nullptr);
+
+void set_response_sink(ResponseSink sink) {
+    response_sink.store(sink, std::memory_order_release);
+}
+
+// Answers requests that expect a response (MT_REQUEST); fire-and-forget
+// requests (MT_REQUEST_NO_RETURN) are never answered
+static void acknowledge(const std::shared_ptr<vsomeip::message> &request, vsomeip::return_code_e code) {
+    ResponseSink sink = response_sink.load(std::memory_order_acquire);
+    if (sink == nullptr || request->get_message_type() != vsomeip::message_type_e::MT_REQUEST) return;
     
-    auto ambient_data = deserialize_ambient_temp_data(data);
-    message_count++;
+    auto response = vsomeip::runtime::get()->create_response(request);
+    if (code != vsomeip::return_code_e::E_OK) {
+        response->set_message_type(vsomeip::message_type_e::MT_ERROR);
+        response->set_return_code(code);
+    }
+    sink(response);
+}
+
+// Payload format of a request, from the interface version in its SOME/IP
+// header. Versions this gateway cannot decode are answered with
+// E_WRONG_INTERFACE_VERSION and counted as decode errors.
+static bool supported_wire_format(const std::shared_ptr<vsomeip::message> &request, size_t bytes,
+                                  uint64_t start_ns, WireFormat &format) {
+    if (wire_format_from_interface_version(request->get_interface_version(), format)) return true;
+    acknowledge(request, vsomeip::return_code_e::E_WRONG_INTERFACE_VERSION);
+    gateway_metrics().record_message(request->get_method(), request->get_client(), bytes, false,
+                                     monotonic_ns() - start_ns);
+    return false;
+}
+
+void dispatch_sensor_message(const std::shared_ptr<vsomeip::message> &request) {
+    const uint64_t start_ns = monotonic_ns();
+    record_traffic(*request, start_ns);
+    gateway_metrics().record_instance(request->get_instance());
+    const size_t bytes = request->get_payload()->get_length();
+    WireFormat format;
+    if (!supported_wire_format(request, bytes, start_ns, format)) return;
+    size_t index = static_cast<size_t>(request->get_method() - Sensors::min_method);
+    if (index < dispatch_table.size() && dispatch_table[index]) {
+        bool decoded = dispatch_table[index](request, format);
+        acknowledge(request, decoded ? vsomeip::return_code_e::E_OK : vsomeip::return_code_e::E_MALFORMED_MESSAGE);
+        gateway_metrics().record_message(request->get_method(), request->get_client(), bytes, decoded,
+                                         monotonic_ns() - start_ns);
+    } else {
+        acknowledge(request, vsomeip::return_code_e::E_UNKNOWN_METHOD);
+        gateway_metrics().record_unknown(request->get_client(), bytes);
+    }
+}
+
+void on_sensor_batch_message(const std::shared_ptr<vsomeip::message> &request) {
+    const uint64_t start_ns = monotonic_ns();
+    record_traffic(*request, start_ns);
+    gateway_metrics().record_instance(request->get_instance());
+    const size_t bytes = request->get_payload()->get_length();
+    WireFormat format;
+    if (!supported_wire_format(request, bytes, start_ns, format)) return;
+    SensorBatchView batch;
+    if (!decode_batch_header(PayloadView(*request->get_payload()), batch, format)) {
+        acknowledge(request, vsomeip::return_code_e::E_MALFORMED_MESSAGE);
+        gateway_metrics().record_message(kSensorBatchMethod, request->get_client(), bytes, false,
+                                         monotonic_ns() - start_ns);
+        return;
+    }
+    if (process_sensor_section(request, batch, format, monotonic_ns())) {
+        acknowledge(request, vsomeip::return_code_e::E_OK);
+        gateway_metrics().record_message(kSensorBatchMethod, request->get_client(), bytes, true,
+                                         monotonic_ns() - start_ns);
+    } else {
+        acknowledge(request, vsomeip::return_code_e::E_UNKNOWN_METHOD);
+        gateway_metrics().record_unknown(request->get_client(), bytes);
+    }
+}
+
+void on_sensor_snapshot_message(const std::shared_ptr<vsomeip::message> &request) {
+    const uint64_t start_ns = monotonic_ns();
+    record_traffic(*request, start_ns);
+    gateway_metrics().record_instance(request->get_instance());
+    const size_t bytes = request->get_payload()->get_length();
+    WireFormat format;
+    if (!supported_wire_format(request, bytes, start_ns, format)) return;
     
-    std::cout << std::fixed << std::setprecision(1);
-    std::cout << "[#" << std::setw(4) << message_count << "] ";
-    std::cout << "🌡️ AMBIENT: " << std::setw(5) << ambient_data.temperature_celsius << "°C";
-    if (ambient_data.temperature_celsius < 0.0) std::cout << " ❄️ FREEZING!";
-    std::cout << " [Method 0x0003]" << std::endl;
+    // Every section must be complete before any is processed
+    SensorSnapshotView snapshot;
+    bool valid = bytes <= kMaxSnapshotSize &&
+                 decode_snapshot_header(PayloadView(*request->get_payload()), snapshot, format);
+    SensorBatchView section;
+    size_t offset = 0;
+    for (uint16_t i = 0; valid && i < snapshot.sections; ++i) {
+        valid = next_snapshot_section(snapshot, offset, section, format);
+    }
+    if (!valid) {
+        acknowledge(request, vsomeip::return_code_e::E_MALFORMED_MESSAGE);
+        gateway_metrics().record_message(kSensorSnapshotMethod, request->get_client(), bytes, false,
+                                         monotonic_ns() - start_ns);
+        return;
+    }
+    
+    // Sections of sensors this gateway does not know are skipped
+    const uint64_t receive_ns = monotonic_ns();
+    offset = 0;
+    for (uint16_t i = 0; i < snapshot.sections; ++i) {
+        next_snapshot_section(snapshot, offset, section, format);
+        process_sensor_section(request, section, format, receive_ns);
+    }
+    acknowledge(request, vsomeip::return_code_e::E_OK);
+    gateway_metrics().record_message(kSensorSnapshotMethod, request->get_client(), bytes, true,
+                                     monotonic_ns() - start_ns);
+}
+
+void start_dispatch_workers(size_t workers, bool pin_cores) {
+    dispatch_stage().start(workers, pin_cores);
+}
+
+void stop_dispatch_workers() {
+    dispatch_stage().stop();
+}
+
+size_t dispatch_worker_count() {
+    return dispatch_stage().workers();
+}
+
+size_t dispatch_queue_depth(uint16_t method) {
+    if (method < Sensors::min_method || method > Sensors::max_method) return 0;
+    return dispatch_stage().depth(method - Sensors::min_method);
 }
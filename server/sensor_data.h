@@ -2,27 +2,24 @@
 #define SENSOR_DATA_H
 
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vsomeip/vsomeip.hpp>
+#include "payload_view.h"
+#include "sensor_registry.h"
+#include "sensor_batch.h"
+#include "sensor_snapshot.h"
 
-// Sensor data structures
-struct SpeedData {
-    float speed_kmh;
-    uint32_t timestamp;
-};
+// View-based decoders: return false and leave out untouched on short payloads
+bool decode_speed_data(PayloadView payload, SpeedData& out);
+bool decode_engine_temp_data(PayloadView payload, EngineTemperatureData& out);
+bool decode_ambient_temp_data(PayloadView payload, AmbientTemperatureData& out);
 
-struct EngineTemperatureData {
-    float temperature_celsius;
-    uint32_t timestamp;
-};
-
-struct AmbientTemperatureData {
-    float temperature_celsius;
-    uint32_t timestamp;
-};
-
-// Deserialization function declarations
+// Deserialization function declarations (zero-filled result on short payloads)
+SpeedData deserialize_speed_data(PayloadView payload);
+EngineTemperatureData deserialize_engine_temp_data(PayloadView payload);
+AmbientTemperatureData deserialize_ambient_temp_data(PayloadView payload);
 SpeedData deserialize_speed_data(const std::vector<uint8_t>& payload);
 EngineTemperatureData deserialize_engine_temp_data(const std::vector<uint8_t>& payload);
 AmbientTemperatureData deserialize_ambient_temp_data(const std::vector<uint8_t>& payload);
@@ -32,7 +29,45 @@ void on_speed_message(const std::shared_ptr<vsomeip::message> &request);
 void on_engine_temp_message(const std::shared_ptr<vsomeip::message> &request);
 void on_ambient_temp_message(const std::shared_ptr<vsomeip::message> &request);
 
-// Global message counter (for testing)
-extern int message_count;
+// Single entry point for every method in Sensors; dispatches through a
+// flat table indexed by method ID. Unknown methods are ignored; short
+// payloads are counted as decode errors but their samples are dropped.
+void dispatch_sensor_message(const std::shared_ptr<vsomeip::message> &request);
+
+// Handler for kSensorBatchMethod: decodes all samples of the batch in one pass.
+// Malformed batches (truncated records, unknown sensor) are ignored.
+void on_sensor_batch_message(const std::shared_ptr<vsomeip::message> &request);
+
+// Handler for kSensorSnapshotMethod: vsomeip has already reassembled the
+// SOME/IP-TP segments; each section is decoded in place like a batch.
+// Truncated or oversized snapshots are rejected as a whole.
+void on_sensor_snapshot_message(const std::shared_ptr<vsomeip::message> &request);
+
+// Sends responses for acknowledged requests; the gateway passes app->send.
+// Requests of type MT_REQUEST are answered by dispatch_sensor_message,
+// on_sensor_batch_message and on_sensor_snapshot_message (E_OK,
+// E_MALFORMED_MESSAGE or E_UNKNOWN_METHOD);
+// MT_REQUEST_NO_RETURN requests never are. Without a sink nothing is sent.
+typedef void (*ResponseSink)(const std::shared_ptr<vsomeip::message> &response);
+void set_response_sink(ResponseSink sink);
+
+// Optional worker pool behind the sensor handlers: one lock-free queue per
+// sensor method, each drained by a single worker. Single samples, batches
+// and snapshot sections of a method all go through its queue, so every
+// method's state (history, latest values, alert state) has one writer and
+// per-method order is kept. Parallelism is therefore per method: workers is
+// capped at the number of methods. 0 keeps all processing on the calling
+// vsomeip dispatcher, which is then the single writer; several dispatchers
+// (gateway shards) need the stage. stop_dispatch_workers() processes
+// everything still queued.
+void start_dispatch_workers(size_t workers, bool pin_cores);
+void stop_dispatch_workers();
+size_t dispatch_worker_count();
+// Samples of method waiting for their worker; 0 without workers
+size_t dispatch_queue_depth(uint16_t method);
+
+// Messages processed so far, summed over all handler threads
+int get_message_count();
+void reset_message_count();
 
 #endif // SENSOR_DATA_H
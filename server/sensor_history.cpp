@@ -0,0 +1,157 @@
+#include "sensor_history.h"
+#include "sensor_registry.h"
+#include <array>
+#include <cmath>
+
+static size_t round_up_pow2(size_t value) {
+    size_t result = 2;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+SensorHistory::SensorHistory(size_t capacity, const std::vector<uint32_t>& windows_ms)
+    : mask_(round_up_pow2(capacity) - 1),
+      values_(make_cache_aligned_array<float>(mask_ + 1)),
+      times_(make_cache_aligned_array<uint64_t>(mask_ + 1)),
+      published_next_(0) {
+    for (uint32_t span_ms : windows_ms) {
+        std::unique_ptr<Window> window(new Window());
+        window->span_ms = span_ms;
+        window->span_ns = static_cast<uint64_t>(span_ms) * 1000000;
+        window->first = 0;
+        window->mean = 0.0;
+        window->squared_deviations = 0.0;
+        window->min_queue.positions = make_cache_aligned_array<uint64_t>(mask_ + 1);
+        window->max_queue.positions = make_cache_aligned_array<uint64_t>(mask_ + 1);
+        windows_.push_back(std::move(window));
+    }
+}
+
+size_t SensorHistory::size() const {
+    uint64_t count = published_next_.load(std::memory_order_acquire);
+    return count < capacity() ? static_cast<size_t>(count) : capacity();
+}
+
+void SensorHistory::evict_oldest(Window& window) {
+    const uint64_t remaining = next_ - window.first - 1;
+    if (remaining == 0) {
+        // Empty window: drop accumulated rounding error
+        window.mean = 0.0;
+        window.squared_deviations = 0.0;
+    } else {
+        double value = values_[window.first & mask_];
+        double delta = value - window.mean;
+        window.mean -= delta / remaining;
+        window.squared_deviations -= delta * (value - window.mean);
+    }
+    if (window.min_queue.positions[window.min_queue.head & mask_] == window.first) ++window.min_queue.head;
+    if (window.max_queue.positions[window.max_queue.head & mask_] == window.first) ++window.max_queue.head;
+    ++window.first;
+}
+
+void SensorHistory::publish(Window& window) {
+    WindowStats stats = {window.span_ms, static_cast<uint32_t>(next_ - window.first), 0.0f, 0.0f, 0.0f, 0.0f};
+    if (stats.count > 0) {
+        double variance = window.squared_deviations / stats.count;
+        stats.min = values_[window.min_queue.positions[window.min_queue.head & mask_] & mask_];
+        stats.max = values_[window.max_queue.positions[window.max_queue.head & mask_] & mask_];
+        stats.mean = static_cast<float>(window.mean);
+        stats.stddev = static_cast<float>(variance > 0.0 ? std::sqrt(variance) : 0.0);
+    }
+    window.published.try_store(stats);
+}
+
+void SensorHistory::add(float value, uint64_t time_ns) {
+    const uint64_t position = next_;
+    
+    // The slot about to be overwritten leaves every window still holding it
+    if (position > mask_) {
+        for (auto& window : windows_) {
+            if (window->first == position - mask_ - 1) evict_oldest(*window);
+        }
+    }
+    
+    values_[position & mask_] = value;
+    times_[position & mask_] = time_ns;
+    ++next_;
+    
+    for (auto& window : windows_) {
+        double delta = value - window->mean;
+        window->mean += delta / static_cast<double>(next_ - window->first);
+        window->squared_deviations += delta * (value - window->mean);
+        
+        ExtremeQueue& min_queue = window->min_queue;
+        while (min_queue.tail != min_queue.head && values_[min_queue.positions[(min_queue.tail - 1) & mask_] & mask_] >= value) {
+            --min_queue.tail;
+        }
+        min_queue.positions[min_queue.tail++ & mask_] = position;
+        
+        ExtremeQueue& max_queue = window->max_queue;
+        while (max_queue.tail != max_queue.head && values_[max_queue.positions[(max_queue.tail - 1) & mask_] & mask_] <= value) {
+            --max_queue.tail;
+        }
+        max_queue.positions[max_queue.tail++ & mask_] = position;
+        
+        // Samples at or before time_ns - span have left the window
+        while (window->first < position && times_[window->first & mask_] + window->span_ns <= time_ns) {
+            evict_oldest(*window);
+        }
+        publish(*window);
+    }
+    published_next_.store(next_, std::memory_order_release);
+}
+
+bool SensorHistory::stats(size_t window, WindowStats& out) const {
+    if (window >= windows_.size()) return false;
+    if (!windows_[window]->published.load(out)) {
+        out = WindowStats{windows_[window]->span_ms, 0, 0.0f, 0.0f, 0.0f, 0.0f};
+    }
+    return true;
+}
+
+// Configuration picked up when the histories are first created
+static size_t history_capacity = 16384;
+static std::vector<uint32_t> history_windows_ms = {1000, 10000, 60000};
+
+void configure_sensor_history(size_t capacity, const std::vector<uint32_t>& windows_ms) {
+    history_capacity = capacity;
+    history_windows_ms = windows_ms;
+}
+
+SensorHistory* sensor_history(uint16_t method) {
+    static std::array<std::unique_ptr<SensorHistory>, Sensors::max_method - Sensors::min_method + 1> histories = []() {
+        std::array<std::unique_ptr<SensorHistory>, Sensors::max_method - Sensors::min_method + 1> created;
+        for (auto& history : created) {
+            history.reset(new SensorHistory(history_capacity, history_windows_ms));
+        }
+        return created;
+    }();
+    size_t index = static_cast<size_t>(method - Sensors::min_method);
+    return index < histories.size() ? histories[index].get() : nullptr;
+}
+
+std::shared_ptr<vsomeip::message> make_sensor_stats_response(const std::shared_ptr<vsomeip::message> &request) {
+    uint16_t method = 0;
+    SensorHistory* history = nullptr;
+    PayloadView query(*request->get_payload());
+    WireFormat query_format = WireFormat::Legacy;
+    wire_format_from_interface_version(request->get_interface_version(), query_format);
+    if (query.contains(0, sizeof(method))) {
+        method = load_wire<uint16_t>(query_format, query.data());
+        history = sensor_history(method);
+    }
+    size_t windows = history ? history->window_count() : 0;
+    
+    std::vector<vsomeip::byte_t> bytes(stats_payload_size(windows));
+    encode_stats_header(history ? method : 0, static_cast<uint16_t>(windows), bytes.data(), kCurrentWireFormat);
+    for (size_t i = 0; i < windows; ++i) {
+        WindowStats stats;
+        history->stats(i, stats);
+        encode_stats_record(stats, i, bytes.data(), kCurrentWireFormat);
+    }
+    
+    auto response = vsomeip::runtime::get()->create_response(request);
+    response->set_interface_version(interface_version_of(kCurrentWireFormat));
+    response->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    return response;
+}
@@ -0,0 +1,95 @@
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+#include <vsomeip/vsomeip.hpp>
+#include "seqlock.h"
+#include "window_stats.h"
+
+// Heap array on its own cache lines
+template <typename T>
+struct CacheAlignedDelete {
+    void operator()(T* ptr) const { ::operator delete[](ptr, std::align_val_t(64)); }
+};
+
+template <typename T>
+using CacheAlignedArray = std::unique_ptr<T[], CacheAlignedDelete<T>>;
+
+template <typename T>
+CacheAlignedArray<T> make_cache_aligned_array(size_t count) {
+    return CacheAlignedArray<T>(static_cast<T*>(::operator new[](count * sizeof(T), std::align_val_t(64))));
+}
+
+// Fixed-capacity circular history of one sensor, kept as separate value and
+// time arrays, with rolling min/max/mean/stddev over several time windows.
+// add() is O(1) amortized: mean and variance follow Welford's updates (with
+// removal) and min/max come from monotonic queues, so nothing is ever
+// rescanned. After every sample each window's statistics are published
+// through a seqlock, so stats() never blocks the writer. Windows hold at
+// most capacity samples. add() has a single writer, the worker of the
+// sensor's method queue; stats() may be called from any thread.
+class SensorHistory {
+public:
+    SensorHistory(size_t capacity, const std::vector<uint32_t>& windows_ms);
+
+    SensorHistory(const SensorHistory&) = delete;
+    SensorHistory& operator=(const SensorHistory&) = delete;
+
+    // Appends a sample received at time_ns (monotonic, non-decreasing).
+    // Calls must not overlap.
+    void add(float value, uint64_t time_ns);
+
+    // Latest published statistics of window index; false if out of range
+    bool stats(size_t window, WindowStats& out) const;
+
+    size_t capacity() const { return mask_ + 1; }
+    size_t window_count() const { return windows_.size(); }
+    // Samples currently retained (at most capacity)
+    size_t size() const;
+
+private:
+    // Ring of sample positions with monotonic values, front = window extreme
+    struct ExtremeQueue {
+        CacheAlignedArray<uint64_t> positions;
+        uint64_t head = 0;
+        uint64_t tail = 0;
+    };
+
+    struct Window {
+        uint32_t span_ms;
+        uint64_t span_ns;
+        uint64_t first;          // position of the oldest sample in the window
+        double mean;
+        double squared_deviations; // sum of (value - mean)^2 over the window
+        ExtremeQueue min_queue;
+        ExtremeQueue max_queue;
+        SeqlockSlot<WindowStats> published;
+    };
+
+    void evict_oldest(Window& window);
+    void publish(Window& window);
+
+    const size_t mask_;
+    CacheAlignedArray<float> values_;
+    CacheAlignedArray<uint64_t> times_;
+    uint64_t next_ = 0;                      // position of the next sample
+    std::vector<std::unique_ptr<Window>> windows_;
+    std::atomic<uint64_t> published_next_;
+};
+
+// Capacity and windows used by every sensor history; only effective before
+// the first call to sensor_history()
+void configure_sensor_history(size_t capacity, const std::vector<uint32_t>& windows_ms);
+
+// History of the given sensor method; nullptr for methods outside Sensors
+SensorHistory* sensor_history(uint16_t method);
+
+// Builds the kSensorStatsMethod response for request
+std::shared_ptr<vsomeip::message> make_sensor_stats_response(const std::shared_ptr<vsomeip::message> &request);
+
+#endif // SENSOR_HISTORY_H
@@ -2,25 +2,214 @@
 #include <vsomeip/vsomeip.hpp>
 #include <iostream>
 #include <iomanip>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <memory>
 #include "sensor_data.h"
+#include "async_log.h"
+#include "latency_tracker.h"
+#include "latest_value_store.h"
+#include "sensor_history.h"
+#include "event_publisher.h"
+#include "server_options.h"
+#include "traffic_recorder.h"
+#include "gateway_metrics.h"
+#include "metrics_exporter.h"
+#include "alert_engine.h"
+#include "shard_ring.h"
+#include <fstream>
+#include <vector>
 
-std::shared_ptr<vsomeip::application> app;
+// One vsomeip application per gateway shard; shard i offers instance shard_instance(i)
+std::vector<std::shared_ptr<vsomeip::application>> gateways;
 
-int main() {
-    app = vsomeip::runtime::get()->create_application("central_gateway");
-    app->init();
+// Application of the shard offering instance; responses leave through the shard that received the request
+static vsomeip::application& gateway_for(uint16_t instance) {
+    size_t shard = static_cast<size_t>(instance - kFirstShardInstance);
+    return *gateways[shard < gateways.size() ? shard : 0];
+}
+
+// Event sink for the publisher: one notify per event, whatever the subscriber count.
+// Events are offered by shard 0 only, so subscribers see the samples of every shard.
+static void notify_subscribers(uint16_t service, uint16_t instance, uint16_t event,
+                               const std::shared_ptr<vsomeip::payload> &payload) {
+    (void)instance;
+    gateways.front()->notify(service, kFirstShardInstance, event, payload);
+}
+
+int main(int argc, char** argv) {
+    ServerOptions options;
+    std::string error;
+    if (!parse_server_options(argc, argv, options, error)) {
+        std::cerr << "❌ " << error << std::endl;
+        print_server_usage(argv[0]);
+        return 1;
+    }
+    
+    configure_sensor_history(options.history_capacity, options.windows_ms);
+    
+    if (!options.alert_rules_file.empty()) {
+        std::ifstream rules_file(options.alert_rules_file);
+        std::vector<AlertRule> rules;
+        if (!rules_file) {
+            std::cerr << "❌ Cannot read " << options.alert_rules_file << std::endl;
+            return 1;
+        }
+        if (!parse_alert_rules(rules_file, rules, error) || !alert_engine().configure(rules, error)) {
+            std::cerr << "❌ " << error << std::endl;
+            return 1;
+        }
+    }
+    
+    // Shard 0 initializes first and keeps the unsharded name, so it hosts routing as before
+    for (size_t shard = 0; shard < options.shards; ++shard) {
+        gateways.push_back(vsomeip::runtime::get()->create_application(shard_application_name(shard)));
+        gateways.back()->init();
+    }
     
     std::cout << "🏭 Central Gateway: Multi-Method Sensor Processor" << std::endl;
     std::cout << "📡 Methods: 0x0001(Speed), 0x0002(Engine), 0x0003(Ambient)" << std::endl;
     std::cout << "💾 Payload optimized: 8 bytes per sensor (vs 17 bytes before)" << std::endl;
+    if (!kLogPerMessage) {
+        std::cout << "🏎️  Perf build: per-message log lines compiled out" << std::endl;
+    }
+    
+    // Acknowledged clients get one response per request, sent from the handler
+    set_response_sink([](const std::shared_ptr<vsomeip::message> &response) {
+        gateway_for(response->get_instance()).send(response);
+    });
     
-    // Register specialized handlers for each method
-    app->register_message_handler(0x1234, 0x0001, 0x0001, on_speed_message);        // Speed sensor
-    app->register_message_handler(0x1234, 0x0001, 0x0002, on_engine_temp_message);  // Engine temperature
-    app->register_message_handler(0x1234, 0x0001, 0x0003, on_ambient_temp_message); // Ambient temperature
+    for (size_t shard = 0; shard < gateways.size(); ++shard) {
+        vsomeip::application* gateway = gateways[shard].get();
+        const uint16_t instance = shard_instance(shard);
+        
+        // Every sensor method goes through the generated dispatch table
+        for (auto method : Sensors::method_ids) {
+            gateway->register_message_handler(0x1234, instance, method, dispatch_sensor_message);
+        }
+        
+        gateway->register_message_handler(0x1234, instance, kSensorBatchMethod, on_sensor_batch_message);
+        
+        // Bulk snapshots arrive as SOME/IP-TP segments, reassembled by vsomeip
+        gateway->register_message_handler(0x1234, instance, kSensorSnapshotMethod, on_sensor_snapshot_message);
+        
+        // Latest value of every sensor in one response, for polling consumers
+        gateway->register_message_handler(0x1234, instance, kLatestValuesMethod,
+            [gateway](const std::shared_ptr<vsomeip::message> &request) {
+                gateway->send(make_latest_values_response(request));
+            });
+        
+        // Rolling window statistics of one sensor
+        gateway->register_message_handler(0x1234, instance, kSensorStatsMethod,
+            [gateway](const std::shared_ptr<vsomeip::message> &request) {
+                gateway->send(make_sensor_stats_response(request));
+            });
+        
+        // The major version becomes the interface version of every event: the wire format of its payload
+        gateway->offer_service(0x1234, instance, interface_version_of(kCurrentWireFormat));
+    }
+    if (gateways.size() > 1) {
+        std::cout << "🧩 Shards: " << gateways.size() << " gateway instances 0x" << std::hex << std::setw(4)
+                  << std::setfill('0') << kFirstShardInstance << "..0x" << std::setw(4)
+                  << shard_instance(gateways.size() - 1) << std::dec << std::setfill(' ')
+                  << ", one dispatcher each, one metrics registry" << std::endl;
+    }
     
-    app->offer_service(0x1234, 0x0001);
+    if (options.events) {
+        for_each_sensor(Sensors{}, [](auto tag) {
+            using S = typename decltype(tag)::type;
+            gateways.front()->offer_event(0x1234, kFirstShardInstance, sensor_event_id<S>(), {sensor_eventgroup<S>()},
+                                          vsomeip::event_type_e::ET_FIELD, std::chrono::milliseconds::zero(),
+                                          false, true, nullptr, vsomeip::reliability_type_e::RT_UNRELIABLE);
+        });
+        NotificationPolicy policy = {options.notify_epsilon, options.notify_cycle_ms};
+        enable_sensor_events(notify_subscribers, options.override_policy ? &policy : nullptr);
+        
+        // Sends samples held back by cycle-based coalescing
+        std::thread([]() {
+            for (;;) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                flush_sensor_events(monotonic_ns());
+            }
+        }).detach();
+        std::cout << "📣 Events: one eventgroup per sensor, event 0x8000 | method" << std::endl;
+    }
 
-    std::cout << "✅ Gateway ready with 3 specialized method handlers" << std::endl;
-    app->start();
+    // Alert edges leave the handler path through the engine's queue
+    std::thread([]() {
+        for (;;) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            log_alert_events();
+        }
+    }).detach();
+    std::cout << "🚨 Alerts: " << alert_engine().rules().size() << " rule(s) from "
+              << (options.alert_rules_file.empty() ? "sensor thresholds" : options.alert_rules_file) << std::endl;
+
+    std::cout << "✅ Gateway ready with " << Sensors::size << " sensor method handlers" << std::endl;
+    
+    // Capture traffic before any worker consumes it
+    std::unique_ptr<TrafficRecorder> recorder;
+    if (!options.record_directory.empty()) {
+        RecorderConfig config;
+        config.directory = options.record_directory;
+        config.segment_bytes = options.record_segment_mb << 20;
+        recorder.reset(new TrafficRecorder(config));
+        if (!recorder->start(error)) {
+            std::cerr << "❌ " << error << std::endl;
+            return 1;
+        }
+        set_traffic_recorder(recorder.get());
+        std::cout << "⏺️  Recording traffic to " << options.record_directory << std::endl;
+    }
+    
+    std::unique_ptr<MetricsExporter> exporter;
+    if (!options.metrics_file.empty() || !options.metrics_socket.empty()) {
+        MetricsExporterConfig config;
+        config.file = options.metrics_file;
+        config.socket = options.metrics_socket;
+        config.interval = std::chrono::milliseconds(options.metrics_interval_ms);
+        exporter.reset(new MetricsExporter(config, []() { return gateway_metrics().snapshot(); }));
+        if (!exporter->start(error)) {
+            std::cerr << "❌ " << error << std::endl;
+            return 1;
+        }
+        if (!config.file.empty()) {
+            std::cout << "📈 Metrics snapshot every " << options.metrics_interval_ms << "ms → " << config.file << std::endl;
+        }
+        if (!config.socket.empty()) {
+            std::cout << "📈 Metrics on unix:" << config.socket << std::endl;
+        }
+    }
+    
+    // Shards dispatch on threads of their own; the dispatch stage keeps one
+    // writer per sensor method behind all of them
+    size_t workers = options.workers;
+    if (workers == 0 && gateways.size() > 1) workers = 1;
+    if (workers > 0) {
+        start_dispatch_workers(workers, options.pin_cores);
+        std::cout << "🧵 Dispatch stage: " << dispatch_worker_count() << " worker(s)"
+                  << (options.pin_cores ? ", pinned to cores" : "") << std::endl;
+    }
+    
+    // Periodic latency summary for clients sending the latency extension
+    std::thread([]() {
+        for (;;) {
+            std::this_thread::sleep_for(std::chrono::seconds(10));
+            log_latency_report();
+        }
+    }).detach();
+
+    // Shards beyond the first run their dispatchers on threads of their own
+    std::vector<std::thread> shard_threads;
+    for (size_t shard = 1; shard < gateways.size(); ++shard) {
+        shard_threads.emplace_back([shard]() { gateways[shard]->start(); });
+    }
+    gateways.front()->start();
+    for (size_t shard = 1; shard < gateways.size(); ++shard) gateways[shard]->stop();
+    for (auto& thread : shard_threads) thread.join();
+    
+    if (exporter) exporter->stop();
+    set_traffic_recorder(nullptr);
+    if (recorder) recorder->stop();
 }
@@ -0,0 +1,160 @@
+#include "server_options.h"
+#include "shard_ring.h"
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+// Parses a non-negative integer option value
+static bool parse_count(const char* text, unsigned long& out) {
+    if (text == nullptr || *text == '\0' || *text == '-') return false;
+    char* end = nullptr;
+    out = std::strtoul(text, &end, 10);
+    return *end == '\0';
+}
+
+// Parses "MS[,MS...]" into a list of positive window lengths
+static bool parse_windows(const char* text, std::vector<uint32_t>& out) {
+    if (text == nullptr || *text == '\0') return false;
+    std::vector<uint32_t> windows;
+    const char* at = text;
+    for (;;) {
+        char* end = nullptr;
+        unsigned long ms = std::strtoul(at, &end, 10);
+        if (end == at || *at == '-' || ms == 0 || ms > UINT32_MAX) return false;
+        windows.push_back(static_cast<uint32_t>(ms));
+        if (*end == '\0') break;
+        if (*end != ',') return false;
+        at = end + 1;
+    }
+    out = windows;
+    return true;
+}
+
+bool parse_server_options(int argc, char** argv, ServerOptions& out, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        unsigned long number = 0;
+        
+        if (arg == "--workers") {
+            if (!parse_count(value, number)) {
+                error = "--workers expects a number of dispatch workers";
+                return false;
+            }
+            out.workers = number;
+            ++i;
+        } else if (arg == "--pin") {
+            out.pin_cores = true;
+        } else if (arg == "--shards") {
+            if (!parse_count(value, number) || number == 0 || number > kMaxShards) {
+                error = "--shards expects 1 to " + std::to_string(kMaxShards) + " gateway instances";
+                return false;
+            }
+            out.shards = number;
+            ++i;
+        } else if (arg == "--history") {
+            if (!parse_count(value, number) || number == 0) {
+                error = "--history expects a positive number of samples";
+                return false;
+            }
+            out.history_capacity = number;
+            ++i;
+        } else if (arg == "--no-events") {
+            out.events = false;
+        } else if (arg == "--epsilon") {
+            char* end = nullptr;
+            float epsilon = value ? std::strtof(value, &end) : -1.0f;
+            if (value == nullptr || *end != '\0' || epsilon < 0.0f) {
+                error = "--epsilon expects a non-negative value change";
+                return false;
+            }
+            out.notify_epsilon = epsilon;
+            out.override_policy = true;
+            ++i;
+        } else if (arg == "--cycle-ms") {
+            if (!parse_count(value, number)) {
+                error = "--cycle-ms expects a number of milliseconds";
+                return false;
+            }
+            out.notify_cycle_ms = static_cast<unsigned>(number);
+            out.override_policy = true;
+            ++i;
+        } else if (arg == "--record") {
+            if (value == nullptr || *value == '\0') {
+                error = "--record expects a capture directory";
+                return false;
+            }
+            out.record_directory = value;
+            ++i;
+        } else if (arg == "--record-segment-mb") {
+            if (!parse_count(value, number) || number == 0) {
+                error = "--record-segment-mb expects a positive segment size in MiB";
+                return false;
+            }
+            out.record_segment_mb = number;
+            ++i;
+        } else if (arg == "--metrics-file") {
+            if (value == nullptr || *value == '\0') {
+                error = "--metrics-file expects a file path";
+                return false;
+            }
+            out.metrics_file = value;
+            ++i;
+        } else if (arg == "--metrics-socket") {
+            if (value == nullptr || *value == '\0') {
+                error = "--metrics-socket expects a socket path";
+                return false;
+            }
+            out.metrics_socket = value;
+            ++i;
+        } else if (arg == "--metrics-interval-ms") {
+            if (!parse_count(value, number) || number == 0) {
+                error = "--metrics-interval-ms expects a positive number of milliseconds";
+                return false;
+            }
+            out.metrics_interval_ms = static_cast<unsigned>(number);
+            ++i;
+        } else if (arg == "--alert-rules") {
+            if (value == nullptr || *value == '\0') {
+                error = "--alert-rules expects a rules file";
+                return false;
+            }
+            out.alert_rules_file = value;
+            ++i;
+        } else if (arg == "--windows") {
+            if (!parse_windows(value, out.windows_ms)) {
+                error = "--windows expects MS[,MS...]";
+                return false;
+            }
+            ++i;
+        } else {
+            error = "unknown option " + arg;
+            return false;
+        }
+    }
+    return true;
+}
+
+void print_server_usage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --workers N     process sensor methods on N worker threads (0 = dispatcher thread,\n"
+              << "                  at most one worker per method; at least 1 with --shards)\n"
+              << "  --pin           pin dispatch worker i to CPU i\n"
+              << "  --shards N      offer N gateway instances 0x0001..N, each from its own vsomeip application\n"
+              << "                  and dispatcher (default 1, max " << kMaxShards << "); ports in the vsomeip config\n"
+              << "  --history N     samples kept per sensor for window statistics (default 16384)\n"
+              << "  --windows LIST  statistics windows in ms, comma separated (default 1000,10000,60000)\n"
+              << "Events (eventgroup per sensor, event 0x8000 | method):\n"
+              << "  --no-events     do not offer sensor events\n"
+              << "  --epsilon X     notify only changes of at least X (0 = every change; default per sensor)\n"
+              << "  --cycle-ms T    at most one event per T ms, newer samples coalesced (default per sensor)\n"
+              << "Recording:\n"
+              << "  --record DIR    append all received sensor traffic to capture segments in DIR\n"
+              << "  --record-segment-mb N  start a new segment after N MiB (default 256)\n"
+              << "Metrics (Prometheus text format):\n"
+              << "  --metrics-file PATH    rewrite PATH with a snapshot every interval\n"
+              << "  --metrics-socket PATH  answer each connection on Unix socket PATH with a snapshot\n"
+              << "  --metrics-interval-ms T  file snapshot interval (default 5000)\n"
+              << "Alerts (edge-triggered, with hysteresis and minimum duration):\n"
+              << "  --alert-rules FILE     load alert rules from FILE (default: one rule per sensor threshold)\n";
+}
@@ -0,0 +1,41 @@
+#ifndef SERVER_OPTIONS_H
+#define SERVER_OPTIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Command-line options of the central gateway
+struct ServerOptions {
+    // Dispatch workers behind the sensor handlers; 0 processes on the vsomeip dispatcher
+    size_t workers = 0;
+    // Bind dispatch worker i to CPU i
+    bool pin_cores = false;
+    // Gateway instances offered by this process, each from its own vsomeip application
+    size_t shards = 1;
+    // Samples kept per sensor and rolling statistics windows in milliseconds
+    size_t history_capacity = 16384;
+    std::vector<uint32_t> windows_ms = {1000, 10000, 60000};
+    // Publish sensor events to subscribers; the policy overrides the descriptors' when set
+    bool events = true;
+    bool override_policy = false;
+    float notify_epsilon = 0.0f;
+    unsigned notify_cycle_ms = 0;
+    // Capture all received sensor traffic into this directory; empty disables recording
+    std::string record_directory;
+    size_t record_segment_mb = 256;
+    // Prometheus metric snapshots: rewritten file and/or Unix socket; both empty disables export
+    std::string metrics_file;
+    std::string metrics_socket;
+    unsigned metrics_interval_ms = 5000;
+    // Alert rules loaded at startup; empty uses the descriptor thresholds
+    std::string alert_rules_file;
+};
+
+// Parses argv into out; on failure returns false and describes the problem in error
+bool parse_server_options(int argc, char** argv, ServerOptions& out, std::string& error);
+
+void print_server_usage(const char* program);
+
+#endif // SERVER_OPTIONS_H
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../alert_engine.h"
+#include "../sensor_data.h"
+#include "async_log.h"
+#include "test_helpers.h"
+
+static const uint64_t kMs = 1000000;
+
+static std::vector<AlertEvent> drain(AlertEngine& engine) {
+    std::vector<AlertEvent> events;
+    AlertEvent event;
+    while (engine.poll(event)) events.push_back(event);
+    return events;
+}
+
+static void configure(AlertEngine& engine, const std::vector<AlertRule>& rules) {
+    std::string error;
+    ASSERT_TRUE(engine.configure(rules, error)) << error;
+}
+
+// ==================== LEVEL RULES ====================
+
+TEST(AlertEngineTest, RaisesOnceWhileAboveThreshold) {
+    AlertEngine engine;
+    configure(engine, {AlertRule{EngineTempSensor::method_id, AlertCondition::Above, 100.0f, 0.0f, 0}});
+    for (int i = 0; i < 5; ++i) {
+        engine.evaluate(EngineTempSensor::method_id, 0x1234, 0x0001, 101.0f, (i + 1) * kMs);
+    }
+    std::vector<AlertEvent> events = drain(engine);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].edge, AlertEdge::Raised);
+    EXPECT_EQ(events[0].rule, 0);
+    EXPECT_EQ(events[0].service, 0x1234);
+    EXPECT_EQ(events[0].instance, 0x0001);
+    EXPECT_EQ(events[0].value, 101.0f);
+    EXPECT_EQ(events[0].time_ns, kMs);
+    EXPECT_TRUE(engine.active(0, 0x1234, 0x0001));
+    EXPECT_EQ(engine.raised(), 1u);
+}
+
+TEST(AlertEngineTest, HysteresisHoldsTheAlertUntilBackInsideTheBand) {
+    AlertEngine engine;
+    configure(engine, {AlertRule{EngineTempSensor::method_id, AlertCondition::Above, 100.0f, 2.0f, 0}});
+    const float temperatures[] = {101.0f, 99.5f, 100.5f, 97.5f, 101.0f, 97.0f};
+    for (size_t i = 0; i < 6; ++i) {
+        engine.evaluate(EngineTempSensor::method_id, 0x1234, 0x0001, temperatures[i], (i + 1) * kMs);
+    }
+    std::vector<AlertEvent> events = drain(engine);
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[0].edge, AlertEdge::Raised);
+    EXPECT_EQ(events[1].edge, AlertEdge::Cleared);
+    EXPECT_EQ(events[1].value, 97.5f);   // 99.5 was still inside the 2 °C band
+    EXPECT_EQ(events[2].edge, AlertEdge::Raised);
+    EXPECT_EQ(events[3].edge, AlertEdge::Cleared);
+    EXPECT_EQ(engine.cleared(), 2u);
+}
+
+TEST(AlertEngineTest, BelowRulesMirrorTheBand) {
+    AlertEngine engine;
+    configure(engine, {AlertRule{AmbientTempSensor::method_id, AlertCondition::Below, 0.0f, 1.0f, 0}});
+    const float temperatures[] = {-0.5f, 0.5f, 1.0f};
+    for (size_t i = 0; i < 3; ++i) {
+        engine.evaluate(AmbientTempSensor::method_id, 0x1234, 0x0001, temperatures[i], (i + 1) * kMs);
+    }
+    std::vector<AlertEvent> events = drain(engine);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].edge, AlertEdge::Raised);
+    EXPECT_EQ(events[1].edge, AlertEdge::Cleared);
+    EXPECT_EQ(events[1].value, 1.0f);
+}
+
+TEST(AlertEngineTest, MinimumDurationDebouncesShortExcursions) {
+    AlertEngine engine;
+    configure(engine, {AlertRule{SpeedSensor::method_id, AlertCondition::Above, 100.0f, 0.0f, 500}});
+    engine.evaluate(SpeedSensor::method_id, 0x1234, 0x0001, 110.0f, 0);
+    engine.evaluate(SpeedSensor::method_id, 0x1234, 0x0001, 110.0f, 400 * kMs);
+    engine.evaluate(SpeedSensor::method_id, 0x1234, 0x0001, 90.0f, 450 * kMs);    // excursion ends
+    engine.evaluate(SpeedSensor::method_id, 0x1234, 0x0001, 110.0f, 600 * kMs);
+    engine.evaluate(SpeedSensor::method_id, 0x1234, 0x0001, 110.0f, 1000 * kMs);
+    EXPECT_TRUE(drain(engine).empty());
+
+    engine.evaluate(SpeedSensor::method_id, 0x1234, 0x0001, 110.0f, 1100 * kMs);
+    std::vector<AlertEvent> events = drain(engine);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].time_ns, 1100 * kMs);
+}
+
+// ==================== RATE RULES ====================
+
+TEST(AlertEngineTest, RateRulesCompareChangePerSecond) {
+    AlertEngine engine;
+    configure(engine, {AlertRule{EngineTempSensor::method_id, AlertCondition::RiseRate, 1.0f, 0.5f, 0},
+                       AlertRule{EngineTempSensor::method_id, AlertCondition::FallRate, 3.0f, 0.0f, 0}});
+    engine.evaluate(EngineTempSensor::method_id, 0x1234, 0x0001, 80.0f, 1000 * kMs);
+    engine.evaluate(EngineTempSensor::method_id, 0x1234, 0x0001, 82.0f, 2000 * kMs);   // +2 °C/s
+    engine.evaluate(EngineTempSensor::method_id, 0x1234, 0x0001, 82.8f, 3000 * kMs);   // +0.8 °C/s, in band
+    engine.evaluate(EngineTempSensor::method_id, 0x1234, 0x0001, 83.0f, 4000 * kMs);   // +0.2 °C/s
+    engine.evaluate(EngineTempSensor::method_id, 0x1234, 0x0001, 81.0f, 4500 * kMs);   // -4 °C/s
+    std::vector<AlertEvent> events = drain(engine);
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].rule, 0);
+    EXPECT_EQ(events[0].edge, AlertEdge::Raised);
+    EXPECT_FLOAT_EQ(events[0].metric, 2.0f);
+    EXPECT_EQ(events[1].rule, 0);
+    EXPECT_EQ(events[1].edge, AlertEdge::Cleared);
+    EXPECT_EQ(events[1].value, 83.0f);
+    EXPECT_EQ(events[2].rule, 1);
+    EXPECT_EQ(events[2].edge, AlertEdge::Raised);
+    EXPECT_FLOAT_EQ(events[2].metric, -4.0f);
+}
+
+// ==================== SOURCES AND BATCHES ====================
+
+TEST(AlertEngineTest, SourcesHaveIndependentState) {
+    AlertEngine engine;
+    configure(engine, {AlertRule{SpeedSensor::method_id, AlertCondition::Above, 100.0f, 0.0f, 0}});
+    engine.evaluate(SpeedSensor::method_id, 0x1234, 0x0001, 120.0f, kMs);
+    engine.evaluate(SpeedSensor::method_id, 0x1234, 0x0002, 50.0f, kMs);
+    engine.evaluate(SpeedSensor::method_id, 0x1234, 0x0002, 120.0f, 2 * kMs);
+    std::vector<AlertEvent> events = drain(engine);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].instance, 0x0001);
+    EXPECT_EQ(events[1].instance, 0x0002);
+    EXPECT_TRUE(engine.active(0, 0x1234, 0x0001));
+    EXPECT_TRUE(engine.active(0, 0x1234, 0x0002));
+    EXPECT_FALSE(engine.active(0, 0x1234, 0x0003));
+}
+
+TEST(AlertEngineTest, BatchSamplesAreEvaluatedInOrder) {
+    AlertEngine engine;
+    configure(engine, {AlertRule{EngineTempSensor::method_id, AlertCondition::Above, 100.0f, 1.0f, 0},
+                       AlertRule{EngineTempSensor::method_id, AlertCondition::RiseRate, 0.1f, 0.0f, 0}});
+    const float batch[] = {99.0f, 101.0f, 102.0f, 98.0f, 101.5f};
+    engine.evaluate(EngineTempSensor::method_id, 0x1234, 0x0001, batch, 5, kMs);
+    std::vector<AlertEvent> events = drain(engine);
+    // Raised, cleared, raised again; samples received together have no rate
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[0].value, 101.0f);
+    EXPECT_EQ(events[1].value, 98.0f);
+    EXPECT_EQ(events[2].value, 101.5f);
+}
+
+TEST(AlertEngineTest, FullQueueDropsAndCountsEdges) {
+    AlertEngine engine(2);
+    configure(engine, {AlertRule{SpeedSensor::method_id, AlertCondition::Above, 100.0f, 0.0f, 0}});
+    for (uint64_t i = 0; i < 6; ++i) {
+        engine.evaluate(SpeedSensor::method_id, 0x1234, 0x0001, i % 2 == 0 ? 120.0f : 80.0f, (i + 1) * kMs);
+    }
+    EXPECT_EQ(drain(engine).size(), 2u);
+    EXPECT_EQ(engine.dropped(), 4u);
+    EXPECT_EQ(engine.raised() + engine.cleared(), 6u);
+}
+
+TEST(AlertEngineTest, MethodsWithoutRulesAreNotTracked) {
+    AlertEngine engine;
+    configure(engine, {AlertRule{SpeedSensor::method_id, AlertCondition::Above, 100.0f, 0.0f, 0}});
+    engine.evaluate(EngineTempSensor::method_id, 0x1234, 0x0001, 500.0f, kMs);
+    engine.evaluate(0x0042, 0x1234, 0x0001, 500.0f, kMs);
+    EXPECT_TRUE(drain(engine).empty());
+    EXPECT_FALSE(engine.active(0, 0x1234, 0x0001));
+}
+
+// ==================== CONFIGURATION ====================
+
+TEST(AlertEngineTest, ParsesRulesFile) {
+    std::istringstream in("# method condition threshold hysteresis min-duration-ms\n"
+                          "0x0002 above 100 2 500   # overheat\n"
+                          "\n"
+                          "3 below 0.5\n"
+                          "0x0002 rise-rate 1.5 0.5\n");
+    std::vector<AlertRule> rules;
+    std::string error;
+    ASSERT_TRUE(parse_alert_rules(in, rules, error)) << error;
+    ASSERT_EQ(rules.size(), 3u);
+    EXPECT_EQ(rules[0].method, 0x0002);
+    EXPECT_EQ(rules[0].condition, AlertCondition::Above);
+    EXPECT_EQ(rules[0].threshold, 100.0f);
+    EXPECT_EQ(rules[0].hysteresis, 2.0f);
+    EXPECT_EQ(rules[0].min_duration_ms, 500u);
+    EXPECT_EQ(rules[1].method, 0x0003);
+    EXPECT_EQ(rules[1].condition, AlertCondition::Below);
+    EXPECT_EQ(rules[1].hysteresis, 0.0f);
+    EXPECT_EQ(rules[1].min_duration_ms, 0u);
+    EXPECT_EQ(rules[2].condition, AlertCondition::RiseRate);
+}
+
+TEST(AlertEngineTest, RejectsMalformedRules) {
+    const char* bad[] = {"0x0002 over 100\n", "0x0002 above\n", "0x0002 above 100 -1\n",
+                         "0x0002 above 100 1 -5\n", "0x0002 above 100 1 5 extra\n", "two above 100\n"};
+    for (const char* text : bad) {
+        std::istringstream in(std::string("0x0001 above 100\n") + text);
+        std::vector<AlertRule> rules;
+        std::string error;
+        EXPECT_FALSE(parse_alert_rules(in, rules, error)) << text;
+        EXPECT_NE(error.find("line 2"), std::string::npos) << error;
+    }
+
+    AlertEngine engine;
+    std::string error;
+    EXPECT_FALSE(engine.configure({AlertRule{0x0042, AlertCondition::Above, 1.0f, 0.0f, 0}}, error));
+    EXPECT_NE(error.find("0x0042"), std::string::npos);
+}
+
+TEST(AlertEngineTest, DefaultRulesFollowDescriptorThresholds) {
+    std::vector<AlertRule> rules = default_alert_rules();
+    ASSERT_EQ(rules.size(), Sensors::size);
+    EXPECT_EQ(rules[0].method, SpeedSensor::method_id);
+    EXPECT_EQ(rules[0].condition, AlertCondition::Above);
+    EXPECT_EQ(rules[0].threshold, SpeedSensor::alarm_limit);
+    EXPECT_EQ(rules[2].condition, AlertCondition::Below);
+}
+
+TEST(AlertEngineTest, DescribesEdges) {
+    AlertEngine engine;
+    configure(engine, {AlertRule{EngineTempSensor::method_id, AlertCondition::Above, 100.0f, 2.0f, 0},
+                       AlertRule{EngineTempSensor::method_id, AlertCondition::RiseRate, 1.0f, 0.0f, 0}});
+    AlertEvent raised = {0, EngineTempSensor::method_id, 0x1234, 0x0001, AlertEdge::Raised, 104.0f, 104.0f, 0};
+    EXPECT_EQ(describe_alert(engine, raised),
+              "🚨 ALERT 🔥 ENGINE above 100.0°C: 104.0°C [0x1234.0x0001 Method 0x0002]");
+    AlertEvent cleared = {1, EngineTempSensor::method_id, 0x1234, 0x0001, AlertEdge::Cleared, 90.0f, 0.5f, 0};
+    EXPECT_EQ(describe_alert(engine, cleared),
+              "✅ CLEARED 🔥 ENGINE rising faster than 1.0°C/s: 0.5°C/s [0x1234.0x0001 Method 0x0002]");
+}
+
+// ==================== GATEWAY HANDLERS ====================
+
+TEST(AlertEngineTest, HandlersRaiseOneAlertPerExcursion) {
+    std::string error;
+    ASSERT_TRUE(alert_engine().configure(default_alert_rules(), error));
+    console_log().set_enabled(false);
+    for (int i = 0; i < 10; ++i) {
+        dispatch_sensor_message(make_sample_request(EngineTempSensor::method_id, 105.0f, 1, 0x0A01, 0x0007));
+    }
+    dispatch_sensor_message(make_sample_request(EngineTempSensor::method_id, 95.0f, 1, 0x0A01, 0x0007));
+    console_log().set_enabled(true);
+
+    std::vector<AlertEvent> events = drain(alert_engine());
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].edge, AlertEdge::Raised);
+    EXPECT_EQ(events[0].method, EngineTempSensor::method_id);
+    EXPECT_EQ(events[0].instance, 0x0007);
+    EXPECT_EQ(events[1].edge, AlertEdge::Cleared);
+}
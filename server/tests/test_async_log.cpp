@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include "async_log.h"
+
+struct ValueArgs {
+    int id;
+    float value;
+};
+
+static void format_value(std::string& out, const void* raw) {
+    const ValueArgs& args = *static_cast<const ValueArgs*>(raw);
+    out.append("value ").append(std::to_string(args.id)).append("=").append(std::to_string(args.value));
+}
+
+// ==================== ASYNC LOG TESTS ====================
+
+TEST(AsyncLogTest, WritesTextLinesInOrder) {
+    std::ostringstream out;
+    AsyncLog log(out, 64);
+    
+    log.write("first");
+    log.write("second");
+    log.flush();
+    
+    EXPECT_EQ(out.str(), "first\nsecond\n");
+}
+
+TEST(AsyncLogTest, DeferredFormattingOnWriterThread) {
+    std::ostringstream out;
+    AsyncLog log(out, 64);
+    
+    EXPECT_TRUE(log.post(format_value, ValueArgs{7, 1.5f}));
+    log.flush();
+    
+    EXPECT_EQ(out.str(), "value 7=1.500000\n");
+}
+
+TEST(AsyncLogTest, TruncatesOverlongText) {
+    std::ostringstream out;
+    AsyncLog log(out, 8);
+    std::string line(500, 'x');
+    
+    log.write(line.c_str());
+    log.flush();
+    
+    EXPECT_EQ(out.str(), std::string(kLogArgBytes - 1, 'x') + "\n");
+}
+
+TEST(AsyncLogTest, ReportsDroppedLinesWhenFull) {
+    std::ostringstream out;
+    size_t accepted = 0;
+    {
+        AsyncLog log(out, 4);
+        // Far more lines than the ring holds; the writer cannot keep up
+        for (int i = 0; i < 10000; ++i) {
+            if (log.write("burst")) ++accepted;
+        }
+        log.stop();
+        EXPECT_EQ(accepted + log.dropped(), 10000u);
+        if (log.dropped() > 0) {
+            EXPECT_NE(out.str().find("line(s) dropped"), std::string::npos);
+        }
+    }
+}
+
+TEST(AsyncLogTest, StopDrainsPendingLines) {
+    std::ostringstream out;
+    {
+        AsyncLog log(out, 1024);
+        for (int i = 0; i < 100; ++i) log.write("line");
+    }
+    
+    size_t lines = 0;
+    for (char c : out.str()) lines += (c == '\n');
+    EXPECT_EQ(lines, 100u);
+}
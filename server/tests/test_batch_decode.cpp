@@ -0,0 +1,196 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../batch_decode.h"
+#include "sensor_batch.h"
+
+// Decoded columns and summary of one kernel run
+struct DecodedBatch {
+    std::vector<float> values;
+    std::vector<uint32_t> timestamps;
+    std::vector<uint8_t> alarm_bits;
+    BatchSummary summary;
+};
+
+static std::vector<uint8_t> pack_records(const std::vector<float>& values, WireFormat format = WireFormat::Legacy) {
+    std::vector<uint8_t> records(values.size() * kBatchRecordSize);
+    for (size_t i = 0; i < values.size(); ++i) {
+        uint32_t timestamp = 0x10000000u + static_cast<uint32_t>(i) * 7;
+        store_wire(format, &records[i * kBatchRecordSize], values[i]);
+        store_wire(format, &records[i * kBatchRecordSize + 4], timestamp);
+    }
+    return records;
+}
+
+static DecodedBatch run_kernel(BatchKernel kernel, const uint8_t* records, size_t count,
+                               Threshold alarm, float limit, WireFormat format = WireFormat::Legacy) {
+    DecodedBatch out;
+    out.values.assign(count, -1.0f);
+    out.timestamps.assign(count, 0);
+    out.alarm_bits.assign((count + 7) / 8, 0xFF);
+    EXPECT_TRUE(decode_batch_columns_with(kernel, records, count, format, alarm, limit,
+                                          BatchColumns{out.values.data(), out.timestamps.data(),
+                                                       out.alarm_bits.data()},
+                                          out.summary));
+    return out;
+}
+
+static uint32_t bits_of(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Compares bit patterns, so NaN and signed zeros must match exactly as well
+static void expect_identical(const DecodedBatch& expected, const DecodedBatch& actual, const char* kernel) {
+    ASSERT_EQ(expected.values.size(), actual.values.size());
+    for (size_t i = 0; i < expected.values.size(); ++i) {
+        ASSERT_EQ(bits_of(expected.values[i]), bits_of(actual.values[i])) << kernel << " value " << i;
+        ASSERT_EQ(expected.timestamps[i], actual.timestamps[i]) << kernel << " timestamp " << i;
+    }
+    EXPECT_EQ(expected.alarm_bits, actual.alarm_bits) << kernel;
+    EXPECT_EQ(bits_of(expected.summary.min), bits_of(actual.summary.min)) << kernel;
+    EXPECT_EQ(bits_of(expected.summary.max), bits_of(actual.summary.max)) << kernel;
+    EXPECT_EQ(bits_of(expected.summary.sum), bits_of(actual.summary.sum)) << kernel;
+    EXPECT_EQ(expected.summary.alarms, actual.summary.alarms) << kernel;
+}
+
+static const BatchKernel kVectorKernels[] = {BatchKernel::Sse2, BatchKernel::Avx2};
+
+// ==================== SCALAR KERNEL ====================
+
+TEST(BatchDecodeTest, ScalarSplitsColumnsAndFlagsAlarms) {
+    std::vector<float> values = {90.0f, 101.0f, 100.0f, 130.5f, 12.0f};
+    std::vector<uint8_t> records = pack_records(values);
+    DecodedBatch out = run_kernel(BatchKernel::Scalar, records.data(), values.size(), Threshold::Above, 100.0f);
+
+    EXPECT_EQ(out.values, values);
+    EXPECT_EQ(out.timestamps[0], 0x10000000u);
+    EXPECT_EQ(out.timestamps[4], 0x10000000u + 28);
+    EXPECT_EQ(out.alarm_bits[0], 0x0A);   // samples 1 and 3; 100.0 is not above the limit
+    EXPECT_EQ(out.summary.alarms, 2u);
+    EXPECT_FLOAT_EQ(out.summary.min, 12.0f);
+    EXPECT_FLOAT_EQ(out.summary.max, 130.5f);
+    EXPECT_FLOAT_EQ(out.summary.sum, 433.5f);
+}
+
+TEST(BatchDecodeTest, BelowThresholdAndNoThreshold) {
+    std::vector<float> values = {5.0f, -0.5f, 0.0f, -12.0f, 3.0f, -1.0f, 7.0f, 8.0f, -9.0f};
+    std::vector<uint8_t> records = pack_records(values);
+    DecodedBatch freezing = run_kernel(BatchKernel::Scalar, records.data(), values.size(), Threshold::Below, 0.0f);
+    EXPECT_EQ(freezing.alarm_bits[0], 0x2A);
+    EXPECT_EQ(freezing.alarm_bits[1], 0x01);
+    EXPECT_EQ(freezing.summary.alarms, 4u);
+
+    DecodedBatch none = run_kernel(BatchKernel::Scalar, records.data(), values.size(), Threshold::None, 0.0f);
+    EXPECT_EQ(none.summary.alarms, 0u);
+    EXPECT_EQ(none.alarm_bits[0], 0);
+}
+
+TEST(BatchDecodeTest, EmptyBatchReportsInfiniteBounds) {
+    BatchSummary summary;
+    float value;
+    uint32_t timestamp;
+    uint8_t bits;
+    ASSERT_TRUE(decode_batch_columns_with(BatchKernel::Scalar, nullptr, 0, WireFormat::Legacy, Threshold::Above,
+                                          1.0f,
+                                          BatchColumns{&value, &timestamp, &bits}, summary));
+    EXPECT_EQ(summary.min, std::numeric_limits<float>::infinity());
+    EXPECT_EQ(summary.max, -std::numeric_limits<float>::infinity());
+    EXPECT_EQ(summary.sum, 0.0f);
+    EXPECT_EQ(summary.alarms, 0u);
+}
+
+TEST(BatchDecodeTest, NanSamplesAreNeitherBoundsNorAlarms) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    std::vector<float> values = {nan, 50.0f, nan, 150.0f};
+    std::vector<uint8_t> records = pack_records(values);
+    DecodedBatch out = run_kernel(BatchKernel::Scalar, records.data(), values.size(), Threshold::Above, 100.0f);
+    EXPECT_FLOAT_EQ(out.summary.min, 50.0f);
+    EXPECT_FLOAT_EQ(out.summary.max, 150.0f);
+    EXPECT_EQ(out.summary.alarms, 1u);
+    EXPECT_TRUE(std::isnan(out.summary.sum));
+}
+
+// ==================== VECTOR KERNELS ====================
+
+TEST(BatchDecodeTest, ActiveKernelIsSupported) {
+    EXPECT_TRUE(batch_kernel_supported(BatchKernel::Scalar));
+    EXPECT_TRUE(batch_kernel_supported(active_batch_kernel()));
+}
+
+TEST(BatchDecodeTest, VectorKernelsMatchScalarForEveryLength) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> speed(0.0f, 250.0f);
+    std::vector<float> values(kMaxUdpBatchSamples + 9);
+    for (float& value : values) value = speed(gen);
+    std::vector<uint8_t> records = pack_records(values);
+
+    for (BatchKernel kernel : kVectorKernels) {
+        if (!batch_kernel_supported(kernel)) continue;
+        for (size_t count = 0; count <= values.size(); ++count) {
+            DecodedBatch expected = run_kernel(BatchKernel::Scalar, records.data(), count, Threshold::Above, 100.0f);
+            DecodedBatch actual = run_kernel(kernel, records.data(), count, Threshold::Above, 100.0f);
+            expect_identical(expected, actual, batch_kernel_name(kernel));
+            if (HasFatalFailure()) return;
+        }
+    }
+}
+
+TEST(BatchDecodeTest, VectorKernelsMatchScalarOnSpecialValuesAndMisalignedInput) {
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    std::vector<float> values = {0.0f, -0.0f, nan, -inf, inf, 1e-45f, -1e-45f, 3.4e38f, -0.0f, 0.0f,
+                                 nan, 100.0f, -100.0f, 0.1f, -0.1f, 1e30f, -1e30f, 42.0f, nan, -0.0f,
+                                 7.0f, 0.0f, -3.0f, 1e-30f, 2.5f};
+    std::vector<uint8_t> packed = pack_records(values);
+    // Shift the records one byte so no load is aligned
+    std::vector<uint8_t> shifted(packed.size() + 1);
+    std::memcpy(shifted.data() + 1, packed.data(), packed.size());
+
+    const Threshold thresholds[] = {Threshold::Above, Threshold::Below, Threshold::None};
+    for (BatchKernel kernel : kVectorKernels) {
+        if (!batch_kernel_supported(kernel)) continue;
+        for (Threshold alarm : thresholds) {
+            DecodedBatch expected = run_kernel(BatchKernel::Scalar, shifted.data() + 1, values.size(), alarm, 0.0f);
+            DecodedBatch actual = run_kernel(kernel, shifted.data() + 1, values.size(), alarm, 0.0f);
+            expect_identical(expected, actual, batch_kernel_name(kernel));
+        }
+    }
+}
+
+TEST(BatchDecodeTest, BigEndianRecordsDecodeToTheSameColumns) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> temperature(60.0f, 120.0f);
+    std::vector<float> values(kMaxUdpBatchSamples);
+    for (float& value : values) value = temperature(gen);
+    std::vector<uint8_t> legacy = pack_records(values, WireFormat::Legacy);
+    std::vector<uint8_t> v1 = pack_records(values, WireFormat::V1);
+
+    const BatchKernel kernels[] = {BatchKernel::Scalar, BatchKernel::Sse2, BatchKernel::Avx2};
+    for (BatchKernel kernel : kernels) {
+        if (!batch_kernel_supported(kernel)) continue;
+        for (size_t count : {size_t(0), size_t(5), size_t(8), size_t(13), values.size()}) {
+            DecodedBatch expected = run_kernel(BatchKernel::Scalar, legacy.data(), count, Threshold::Above, 100.0f);
+            DecodedBatch actual = run_kernel(kernel, v1.data(), count, Threshold::Above, 100.0f, WireFormat::V1);
+            expect_identical(expected, actual, batch_kernel_name(kernel));
+        }
+    }
+}
+
+TEST(BatchDecodeTest, DescriptorWrapperUsesSensorThreshold) {
+    std::vector<float> values = {-5.0f, 10.0f, -1.0f};
+    std::vector<uint8_t> records = pack_records(values);
+    std::vector<float> out_values(3);
+    std::vector<uint32_t> out_timestamps(3);
+    uint8_t bits = 0;
+    BatchSummary summary;
+    decode_batch_columns<AmbientTempSensor>(records.data(), values.size(), WireFormat::Legacy,
+                                            BatchColumns{out_values.data(), out_timestamps.data(), &bits}, summary);
+    EXPECT_EQ(bits, 0x05);
+    EXPECT_EQ(summary.alarms, 2u);
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../sensor_data.h"
+#include "../traffic_recorder.h"
+#include "../capture_reader.h"
+#include "../capture_replayer.h"
+#include "async_log.h"
+
+// Fresh capture directory per test
+static std::string make_replay_dir() {
+    char path[] = "/tmp/replay-test-XXXXXX";
+    return mkdtemp(path) ? std::string(path) : std::string();
+}
+
+static std::shared_ptr<vsomeip::message> make_sensor_message(vsomeip::method_t method, uint16_t session, float value) {
+    auto message = vsomeip::runtime::get()->create_request();
+    message->set_service(0x1234);
+    message->set_instance(0x0001);
+    message->set_method(method);
+    message->set_client(0x0C01);
+    message->set_session(session);
+    std::vector<vsomeip::byte_t> bytes(8, 0);
+    std::memcpy(bytes.data(), &value, sizeof(value));
+    message->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    return message;
+}
+
+// ==================== CAPTURE READER / REPLAY TESTS ====================
+
+class CaptureReplayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        console_log().set_enabled(false);
+        reset_message_count();
+        directory = make_replay_dir();
+        ASSERT_FALSE(directory.empty());
+    }
+
+    void TearDown() override {
+        console_log().set_enabled(true);
+        std::string command = "rm -rf " + directory;
+        std::system(command.c_str());
+    }
+
+    // Records count messages, receive times step_ns apart, cycling over the three sensors
+    void record_capture(size_t count, uint64_t step_ns, size_t segment_bytes = size_t(256) << 20) {
+        RecorderConfig config;
+        config.directory = directory;
+        config.segment_bytes = segment_bytes;
+        config.chunk_bytes = 4096;
+        config.chunks = 256;
+        TrafficRecorder recorder(config);
+        std::string error;
+        ASSERT_TRUE(recorder.start(error)) << error;
+        for (size_t i = 0; i < count; ++i) {
+            vsomeip::method_t method = static_cast<vsomeip::method_t>(0x0001 + i % 3);
+            ASSERT_TRUE(recorder.record(*make_sensor_message(method, static_cast<uint16_t>(i), 20.0f), i * step_ns));
+        }
+        recorder.stop();
+        ASSERT_EQ(recorder.dropped(), 0u);
+    }
+
+    std::string directory;
+};
+
+TEST_F(CaptureReplayTest, ReaderWalksAllSegmentsInOrder) {
+    record_capture(500, 1000, 4096);
+
+    CaptureReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.open(directory, error)) << error;
+    CaptureRecordHeader header;
+    PayloadView payload;
+    uint64_t expected = 0;
+    while (reader.next(header, payload)) {
+        EXPECT_EQ(header.receive_ns, expected * 1000);
+        EXPECT_EQ(header.session, static_cast<uint16_t>(expected));
+        EXPECT_EQ(payload.size(), 8u);
+        ++expected;
+    }
+    EXPECT_EQ(expected, 500u);
+    EXPECT_GT(reader.segment(), 0u);
+    EXPECT_TRUE(reader.error().empty());
+
+    // A second pass sees the same records
+    ASSERT_TRUE(reader.rewind(error)) << error;
+    ASSERT_TRUE(reader.next(header, payload));
+    EXPECT_EQ(header.receive_ns, 0u);
+}
+
+TEST_F(CaptureReplayTest, OpenFailsWithoutCapture) {
+    CaptureReader reader;
+    std::string error;
+    EXPECT_FALSE(reader.open(directory, error));
+    EXPECT_FALSE(error.empty());
+}
+
+TEST_F(CaptureReplayTest, FastReplayDrivesHandlers) {
+    record_capture(300, 1000000);
+
+    CaptureReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.open(directory, error)) << error;
+    ReplayConfig config;
+    config.speed = 0.0;
+    config.repeat = 2;
+    CaptureReplayer replayer(config);
+    HandlerReplayTarget target;
+    std::atomic<bool> running(true);
+    ReplayResult result;
+    ASSERT_TRUE(replayer.run(reader, std::ref(target), running, result, error)) << error;
+
+    EXPECT_EQ(result.records, 600u);
+    EXPECT_EQ(result.skipped, 0u);
+    EXPECT_EQ(result.bytes, 600u * 8);
+    EXPECT_EQ(get_message_count(), 600);
+    EXPECT_EQ(result.per_method[0x0001], 200u);
+    EXPECT_EQ(result.per_method[0x0003], 200u);
+    EXPECT_EQ(result.call_ns->count(), 600u);
+    // 300 ms of recorded traffic replayed back to back
+    EXPECT_LT(result.elapsed_s, 0.3);
+}
+
+TEST_F(CaptureReplayTest, PacedReplayKeepsScaledSpacing) {
+    // 40 ms of recorded traffic at 4x speed takes about 10 ms
+    record_capture(41, 1000000);
+
+    CaptureReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.open(directory, error)) << error;
+    ReplayConfig config;
+    config.speed = 4.0;
+    CaptureReplayer replayer(config);
+    std::atomic<bool> running(true);
+    ReplayResult result;
+    std::vector<uint64_t> replayed_at;
+    auto sink = [&](const CaptureRecordHeader&, PayloadView) {
+        replayed_at.push_back(monotonic_ns());
+        return true;
+    };
+    ASSERT_TRUE(replayer.run(reader, sink, running, result, error)) << error;
+
+    ASSERT_EQ(replayed_at.size(), 41u);
+    EXPECT_GE(replayed_at.back() - replayed_at.front(), 10000000u - 100000u);
+    EXPECT_GE(result.elapsed_s, 0.0099);
+}
+
+TEST_F(CaptureReplayTest, HandlerTargetSkipsNonSensorMethods) {
+    HandlerReplayTarget target;
+    CaptureRecordHeader header = {};
+    header.service = 0x1234;
+    header.instance = 0x0001;
+    header.method = 0x0077;
+    header.message_type = static_cast<uint8_t>(vsomeip::message_type_e::MT_REQUEST_NO_RETURN);
+    uint8_t bytes[8] = {};
+    EXPECT_FALSE(target(header, PayloadView(bytes, sizeof(bytes))));
+
+    header.method = 0x0002;
+    EXPECT_TRUE(target(header, PayloadView(bytes, sizeof(bytes))));
+    EXPECT_EQ(get_message_count(), 1);
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <chrono>
+
+#include "deadline_pacer.h"
+
+// ==================== DEADLINE PACER TESTS ====================
+
+TEST(DeadlinePacerTest, IntervalSpreadsBurstsOverTheRate) {
+    EXPECT_EQ(DeadlinePacer::interval_for(1000.0, 1), std::chrono::milliseconds(1));
+    EXPECT_EQ(DeadlinePacer::interval_for(1000.0, 10), std::chrono::milliseconds(10));
+    EXPECT_EQ(DeadlinePacer::interval_for(1000.0, 0), std::chrono::milliseconds(1));
+}
+
+TEST(DeadlinePacerTest, IntervalNeverTruncatesToZero) {
+    // 4 ECUs at 1e9 Hz each would be 0.25 ns per message
+    EXPECT_EQ(DeadlinePacer::interval_for(4e9, 1), std::chrono::nanoseconds(1));
+    EXPECT_EQ(DeadlinePacer::interval_for(1e300, 1), std::chrono::nanoseconds(1));
+    EXPECT_GT(DeadlinePacer::interval_for(1e-300, 1), std::chrono::hours(24 * 365));
+}
+
+TEST(DeadlinePacerTest, ZeroIntervalIsClampedWhenFarBehind) {
+    typedef DeadlinePacer::clock clock;
+    DeadlinePacer pacer(std::chrono::nanoseconds(0), clock::now() - std::chrono::seconds(1));
+    EXPECT_EQ(pacer.interval(), std::chrono::nanoseconds(1));
+
+    // A second of backlog is dropped, not divided by a zero interval
+    EXPECT_GE(pacer.wait(), std::chrono::seconds(1));
+    EXPECT_EQ(pacer.late_ticks(), 1u);
+    EXPECT_GE(pacer.skipped_ticks(), 1000000000u);
+}
+
+TEST(DeadlinePacerTest, WaitsForTheNextDeadline) {
+    typedef DeadlinePacer::clock clock;
+    const auto start = clock::now();
+    DeadlinePacer pacer(std::chrono::milliseconds(2), start);
+    for (int i = 0; i < 5; ++i) pacer.wait();
+    // Deadlines at start, +2, +4, +6 and +8 ms
+    EXPECT_GE(clock::now() - start, std::chrono::milliseconds(8));
+    EXPECT_EQ(pacer.skipped_ticks(), 0u);
+}
+
+TEST(DeadlinePacerTest, SleepThenSpinReturnsAtTheDeadline) {
+    typedef std::chrono::steady_clock clock;
+    const auto deadline = clock::now() + std::chrono::milliseconds(2);
+    sleep_then_spin_until(deadline);
+    EXPECT_GE(clock::now(), deadline);
+
+    // A deadline already passed does not wait
+    const auto before = clock::now();
+    sleep_then_spin_until(before - std::chrono::seconds(1));
+    EXPECT_LT(clock::now() - before, std::chrono::milliseconds(100));
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <iostream>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "../sensor_data.h"
+#include "../dispatch_stage.h"
+#include "../latest_value_store.h"
+#include "sharded_counter.h"
+#include "async_log.h"
+#include "test_helpers.h"
+
+// ==================== SHARDED COUNTER TESTS ====================
+
+TEST(ShardedCounterTest, SumsConcurrentIncrements) {
+    ShardedCounter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&counter]() {
+            for (int i = 0; i < 100000; ++i) counter.add();
+        });
+    }
+    for (auto &thread : threads) thread.join();
+    
+    EXPECT_EQ(counter.load(), 400000u);
+    counter.reset();
+    EXPECT_EQ(counter.load(), 0u);
+}
+
+// ==================== DISPATCH STAGE TESTS ====================
+
+// Values seen per queue; each queue has a single worker, so no locking needed
+static std::vector<uint32_t> seen[2];
+
+static void record_queue0(const SensorSample &sample) { seen[0].push_back(sample.timestamp); }
+static void record_queue1(const SensorSample &sample) { seen[1].push_back(sample.timestamp); }
+
+static void slow_record_queue0(const SensorSample &sample) {
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    record_queue0(sample);
+}
+
+TEST(DispatchStageTest, KeepsPerQueueOrder) {
+    seen[0].clear();
+    seen[1].clear();
+    DispatchStage stage(2, 64);
+    stage.start(2, false);
+    EXPECT_EQ(stage.workers(), 2u);
+    
+    SensorSample sample = {};
+    for (uint32_t i = 0; i < 5000; ++i) {
+        sample.timestamp = i;
+        ASSERT_TRUE(stage.push(i % 2, i % 2 ? record_queue1 : record_queue0, sample));
+    }
+    stage.stop();
+    
+    EXPECT_EQ(stage.processed(), 5000u);
+    ASSERT_EQ(seen[0].size(), 2500u);
+    ASSERT_EQ(seen[1].size(), 2500u);
+    for (size_t i = 0; i < 2500; ++i) {
+        EXPECT_EQ(seen[0][i], 2 * i);
+        EXPECT_EQ(seen[1][i], 2 * i + 1);
+    }
+}
+
+// Sections are recorded by their receive time, which the test numbers like timestamps
+static void record_section0(const SensorSection &section) {
+    seen[0].push_back(static_cast<uint32_t>(section.receive_ns));
+}
+
+TEST(DispatchStageTest, SectionsShareTheQueueOfTheirMethod) {
+    seen[0].clear();
+    DispatchStage stage(1, 64);
+    stage.start(1, false);
+    
+    SensorSample sample = {};
+    SensorSection section = {};
+    section.request = vsomeip::runtime::get()->create_request();
+    for (uint32_t i = 0; i < 1000; ++i) {
+        if (i % 2) {
+            section.receive_ns = i;
+            ASSERT_TRUE(stage.push(0, record_section0, section));
+        } else {
+            sample.timestamp = i;
+            ASSERT_TRUE(stage.push(0, record_queue0, sample));
+        }
+    }
+    stage.stop();
+    
+    ASSERT_EQ(seen[0].size(), 1000u);
+    for (uint32_t i = 0; i < 1000; ++i) EXPECT_EQ(seen[0][i], i);
+    // Processed sections no longer hold their message
+    EXPECT_EQ(section.request.use_count(), 1);
+}
+
+TEST(DispatchStageTest, FullQueueBackPressuresInsteadOfDropping) {
+    seen[0].clear();
+    DispatchStage stage(1, 2);
+    stage.start(4, false);
+    EXPECT_EQ(stage.workers(), 1u);
+    
+    SensorSample sample = {};
+    for (uint32_t i = 0; i < 200; ++i) {
+        sample.timestamp = i;
+        ASSERT_TRUE(stage.push(0, slow_record_queue0, sample));
+    }
+    stage.stop();
+    
+    EXPECT_GT(stage.stalls(), 0u);
+    ASSERT_EQ(seen[0].size(), 200u);
+    EXPECT_EQ(seen[0].back(), 199u);
+}
+
+TEST(DispatchStageTest, RejectsPushWhenStopped) {
+    DispatchStage stage(1, 8);
+    SensorSample sample = {};
+    
+    EXPECT_FALSE(stage.push(0, record_queue0, sample));
+    stage.start(1, false);
+    EXPECT_FALSE(stage.push(1, record_queue0, sample));
+    stage.stop();
+    EXPECT_FALSE(stage.push(0, record_queue0, sample));
+}
+
+// ==================== HANDLER INTEGRATION ====================
+
+static size_t count_substr(const std::string &text, const std::string &needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) ++count;
+    return count;
+}
+
+TEST(DispatchStageTest, WorkersProcessEveryHandlerMessage) {
+    console_log().flush();
+    std::ostringstream buffer;
+    std::streambuf* old = std::cout.rdbuf(buffer.rdbuf());
+    int before = get_message_count();
+    
+    start_dispatch_workers(8, false);
+    EXPECT_EQ(dispatch_worker_count(), static_cast<size_t>(Sensors::size));
+    for (int i = 0; i < 100; ++i) {
+        for (auto method : Sensors::method_ids) {
+            dispatch_sensor_message(make_sample_request(method, 20.0f));
+        }
+    }
+    stop_dispatch_workers();
+    console_log().flush();
+    std::cout.rdbuf(old);
+    
+    EXPECT_EQ(get_message_count(), before + 300);
+    EXPECT_EQ(dispatch_worker_count(), 0u);
+    std::string output = buffer.str();
+    EXPECT_EQ(count_substr(output, "[Method 0x0001]"), 100u);
+    EXPECT_EQ(count_substr(output, "[Method 0x0002]"), 100u);
+    EXPECT_EQ(count_substr(output, "[Method 0x0003]"), 100u);
+}
+
+TEST(DispatchStageTest, BatchesRunOnTheMethodWorkerInOrder) {
+    console_log().set_enabled(false);
+    start_dispatch_workers(1, false);
+    // Single samples and batches of one method interleave; the last one pushed must win
+    for (uint32_t i = 0; i < 50; ++i) {
+        dispatch_sensor_message(make_sample_request(AmbientTempSensor::method_id, 1.0f, 2 * i, 0x0A0D));
+        std::vector<vsomeip::byte_t> bytes(batch_payload_size(2));
+        encode_batch_header<AmbientTempSensor>(2, bytes.data());
+        for (size_t r = 0; r < 2; ++r) {
+            AmbientTemperatureData data = {2.0f, 2 * i + 1};
+            encode_batch_record<AmbientTempSensor>(data, r, bytes.data());
+        }
+        on_sensor_batch_message(make_request(kSensorBatchMethod, bytes, 0x0A0D));
+    }
+    stop_dispatch_workers();
+    console_log().set_enabled(true);
+    
+    LatestValue value;
+    ASSERT_TRUE(latest_values().lookup(0x0A0D, 0x0001, AmbientTempSensor::method_id, value));
+    EXPECT_FLOAT_EQ(value.value, 2.0f);
+    EXPECT_EQ(value.timestamp, 99u);
+    EXPECT_EQ(dispatch_queue_depth(AmbientTempSensor::method_id), 0u);
+}
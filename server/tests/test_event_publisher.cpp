@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "../sensor_data.h"
+#include "../event_publisher.h"
+#include "async_log.h"
+#include "test_helpers.h"
+
+static const uint64_t kMs = 1000000;
+
+// ==================== NOTIFICATION FILTER TESTS ====================
+
+TEST(NotificationFilterTest, NotifiesEverySampleWithoutPolicy) {
+    NotificationFilter filter(NotificationPolicy{0.0f, 0});
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(filter.offer(1.0f, i));
+        filter.notified(1.0f, i);
+    }
+    EXPECT_EQ(filter.suppressed(), 0u);
+}
+
+TEST(NotificationFilterTest, DeadbandSuppressesSmallChanges) {
+    NotificationFilter filter(NotificationPolicy{1.0f, 0});
+    ASSERT_TRUE(filter.offer(50.0f, 0));
+    filter.notified(50.0f, 0);
+    
+    EXPECT_FALSE(filter.offer(50.5f, 1));
+    EXPECT_FALSE(filter.offer(49.2f, 2));
+    EXPECT_TRUE(filter.offer(51.0f, 3));
+    filter.notified(51.0f, 3);
+    // Measured against the last notified value, not the last sample
+    EXPECT_FALSE(filter.offer(51.9f, 4));
+    EXPECT_EQ(filter.suppressed(), 3u);
+}
+
+TEST(NotificationFilterTest, CycleCoalescesIntoPendingSample) {
+    NotificationFilter filter(NotificationPolicy{0.0f, 100});
+    ASSERT_TRUE(filter.offer(1.0f, 0));
+    filter.notified(1.0f, 0);
+    
+    EXPECT_FALSE(filter.offer(2.0f, 10 * kMs));
+    EXPECT_FALSE(filter.offer(3.0f, 20 * kMs));
+    EXPECT_TRUE(filter.pending());
+    EXPECT_FALSE(filter.due(99 * kMs));
+    EXPECT_TRUE(filter.due(100 * kMs));
+    EXPECT_EQ(filter.coalesced(), 1u);
+    
+    filter.notified(3.0f, 100 * kMs);
+    EXPECT_FALSE(filter.pending());
+    EXPECT_TRUE(filter.offer(4.0f, 250 * kMs));
+}
+
+TEST(NotificationFilterTest, ReturnToDeadbandDropsPendingSample) {
+    NotificationFilter filter(NotificationPolicy{1.0f, 100});
+    filter.offer(10.0f, 0);
+    filter.notified(10.0f, 0);
+    
+    EXPECT_FALSE(filter.offer(15.0f, 10 * kMs));
+    EXPECT_TRUE(filter.pending());
+    EXPECT_FALSE(filter.offer(10.2f, 20 * kMs));
+    EXPECT_FALSE(filter.pending());
+    EXPECT_FALSE(filter.due(500 * kMs));
+}
+
+// ==================== EVENT CHANNEL TESTS ====================
+
+struct Notification {
+    uint16_t event;
+    const vsomeip::payload* payload;
+    std::vector<vsomeip::byte_t> bytes;
+};
+
+static std::vector<Notification> notifications;
+
+static void record_notification(uint16_t, uint16_t, uint16_t event, const std::shared_ptr<vsomeip::payload> &payload) {
+    notifications.push_back({event, payload.get(),
+                             std::vector<vsomeip::byte_t>(payload->get_data(), payload->get_data() + payload->get_length())});
+}
+
+static float value_of(const Notification& notification) {
+    float value = 0.0f;
+    std::memcpy(&value, notification.bytes.data(), sizeof(value));
+    return value;
+}
+
+TEST(SensorEventChannelTest, ReusesOnePayloadAndFlushesCoalescedSample) {
+    notifications.clear();
+    SensorEventChannel channel;
+    channel.configure(0x8001, 8, NotificationPolicy{0.0f, 100});
+    
+    uint8_t bytes[8] = {};
+    for (int i = 0; i < 5; ++i) {
+        float value = static_cast<float>(i);
+        std::memcpy(bytes, &value, 4);
+        channel.publish(0x1234, 0x0001, bytes, value, i * 10 * kMs, record_notification);
+    }
+    ASSERT_EQ(notifications.size(), 1u);
+    
+    channel.flush(50 * kMs, record_notification);
+    EXPECT_EQ(notifications.size(), 1u);
+    channel.flush(100 * kMs, record_notification);
+    ASSERT_EQ(notifications.size(), 2u);
+    
+    EXPECT_EQ(notifications[0].event, 0x8001);
+    EXPECT_FLOAT_EQ(value_of(notifications[0]), 0.0f);
+    EXPECT_FLOAT_EQ(value_of(notifications[1]), 4.0f);
+    EXPECT_EQ(notifications[0].payload, notifications[1].payload);
+    EXPECT_EQ(channel.notifications(), 2u);
+    EXPECT_EQ(channel.coalesced(), 3u);
+}
+
+TEST(SensorEventChannelTest, HandlersPublishToSensorEvent) {
+    notifications.clear();
+    ScopedSensorEvents events_on(record_notification);
+    
+    std::vector<vsomeip::byte_t> bytes(8);
+    float value = 72.5f;
+    std::memcpy(bytes.data(), &value, 4);
+    auto request = vsomeip::runtime::get()->create_request();
+    request->set_method(EngineTempSensor::method_id);
+    request->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    
+    console_log().set_enabled(false);
+    dispatch_sensor_message(request);
+    console_log().set_enabled(true);
+    
+    ASSERT_EQ(notifications.size(), 1u);
+    EXPECT_EQ(notifications[0].event, sensor_event_id<EngineTempSensor>());
+    EXPECT_EQ(notifications[0].bytes.size(), EngineTempSensor::payload_size);
+    // Events leave in the current wire format, whatever the request used
+    EngineTemperatureData data = {};
+    ASSERT_TRUE(decode_sensor_data<EngineTempSensor>(PayloadView(notifications[0].bytes), data, kCurrentWireFormat));
+    EXPECT_FLOAT_EQ(data.temperature_celsius, 72.5f);
+}
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../sensor_data.h"
+#include "../gateway_metrics.h"
+#include "../metrics_exporter.h"
+#include "async_log.h"
+#include "test_helpers.h"
+
+// Fire-and-forget request of client for method carrying length zero bytes
+static std::shared_ptr<vsomeip::message> make_client_request(vsomeip::method_t method, uint16_t client, size_t length) {
+    auto message = make_request(method, std::vector<vsomeip::byte_t>(length, 0));
+    message->set_client(client);
+    message->set_message_type(vsomeip::message_type_e::MT_REQUEST_NO_RETURN);
+    return message;
+}
+
+static bool contains_line(const std::string& text, const std::string& line) {
+    return text.find("\n" + line + "\n") != std::string::npos || text.compare(0, line.size() + 1, line + "\n") == 0;
+}
+
+// Reads everything the metrics socket sends after request was written
+static std::string query_socket(const std::string& path, const std::string& request) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return std::string();
+    }
+    if (!request.empty() && ::send(fd, request.data(), request.size(), 0) < 0) {
+        ::close(fd);
+        return std::string();
+    }
+    std::string response;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) response.append(buffer, static_cast<size_t>(received));
+    ::close(fd);
+    return response;
+}
+
+// ==================== GATEWAY METRICS TESTS ====================
+
+class GatewayMetricsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        console_log().set_enabled(false);
+        gateway_metrics().reset();
+    }
+
+    void TearDown() override {
+        console_log().set_enabled(true);
+    }
+};
+
+TEST_F(GatewayMetricsTest, CountsMessagesBytesAndClientsPerMethod) {
+    GatewayMetrics metrics;
+    metrics.record_message(0x0001, 0x0B01, 8, true, 500);
+    metrics.record_message(0x0001, 0x0B02, 20, true, 700);
+    metrics.record_message(0x0002, 0x0B01, 4, false, 300);
+    metrics.record_message(kSensorBatchMethod, 0x0B01, 100, true, 2000);
+
+    EXPECT_EQ(metrics.messages(0x0001), 2u);
+    EXPECT_EQ(metrics.bytes(0x0001), 28u);
+    EXPECT_EQ(metrics.decode_errors(0x0001), 0u);
+    EXPECT_EQ(metrics.decode_errors(0x0002), 1u);
+    EXPECT_EQ(metrics.messages(kSensorBatchMethod), 1u);
+    EXPECT_EQ(metrics.client_messages(0x0B01), 3u);
+    EXPECT_EQ(metrics.client_messages(0x0B02), 1u);
+    EXPECT_EQ(metrics.client_messages(0x0B03), 0u);
+    EXPECT_EQ(metrics.handler_histogram(0x0001)->count(), 2u);
+    EXPECT_EQ(metrics.handler_histogram(0x0001)->max(), 700u);
+}
+
+TEST_F(GatewayMetricsTest, UnknownMethodsAreCountedSeparately) {
+    GatewayMetrics metrics;
+    metrics.record_message(0x0077, 0x0B01, 8, true, 100);
+    metrics.record_unknown(0x0B01, 8);
+    EXPECT_EQ(metrics.unknown_methods(), 2u);
+    EXPECT_EQ(metrics.messages(0x0077), 0u);
+    EXPECT_EQ(metrics.client_messages(0x0B01), 2u);
+}
+
+TEST_F(GatewayMetricsTest, ClientsBeyondTableAreSummedAsOther) {
+    GatewayMetrics metrics;
+    for (uint16_t client = 1; client <= GatewayMetrics::kClientSlots + 5; ++client) {
+        metrics.record_message(0x0003, client, 8, true, 100);
+    }
+    std::string text = metrics.snapshot();
+    EXPECT_TRUE(contains_line(text, "gateway_client_messages_total{client=\"other\"} 5")) << text;
+    EXPECT_EQ(metrics.messages(0x0003), GatewayMetrics::kClientSlots + 5);
+}
+
+TEST_F(GatewayMetricsTest, SnapshotUsesPrometheusTextFormat) {
+    GatewayMetrics metrics;
+    metrics.record_message(0x0001, 0x0B01, 8, true, 1000);
+    metrics.record_message(0x0001, 0x0B01, 2, false, 1000);
+    std::string text = metrics.snapshot();
+
+    EXPECT_TRUE(contains_line(text, "# TYPE gateway_messages_total counter"));
+    EXPECT_TRUE(contains_line(text, "gateway_messages_total{method=\"0x0001\"} 2"));
+    EXPECT_TRUE(contains_line(text, "gateway_payload_bytes_total{method=\"0x0001\"} 10"));
+    EXPECT_TRUE(contains_line(text, "gateway_decode_errors_total{method=\"0x0001\"} 1"));
+    EXPECT_TRUE(contains_line(text, "gateway_messages_total{method=\"0x0010\"} 0"));
+    EXPECT_TRUE(contains_line(text, "gateway_client_messages_total{client=\"0x0B01\"} 2"));
+    EXPECT_TRUE(contains_line(text, "gateway_handler_seconds_count{method=\"0x0001\"} 2"));
+    EXPECT_TRUE(contains_line(text, "# TYPE gateway_handler_seconds summary"));
+    EXPECT_TRUE(contains_line(text, "gateway_dispatch_queue_depth{method=\"0x0002\"} 0"));
+    EXPECT_NE(text.find("gateway_log_queue_depth "), std::string::npos);
+    // Every sample line is "name[{labels}] value"
+    EXPECT_EQ(text.back(), '\n');
+}
+
+TEST_F(GatewayMetricsTest, HandlersRecordDecodeErrorsForShortPayloads) {
+    dispatch_sensor_message(make_client_request(0x0001, 0x0B05, 8));
+    dispatch_sensor_message(make_client_request(0x0002, 0x0B05, 3));   // rejected by the decoder
+    dispatch_sensor_message(make_client_request(0x0055, 0x0B05, 8));
+    on_sensor_batch_message(make_client_request(kSensorBatchMethod, 0x0B05, 2));
+
+    GatewayMetrics& metrics = gateway_metrics();
+    EXPECT_EQ(metrics.messages(0x0001), 1u);
+    EXPECT_EQ(metrics.decode_errors(0x0001), 0u);
+    EXPECT_EQ(metrics.messages(0x0002), 1u);
+    EXPECT_EQ(metrics.decode_errors(0x0002), 1u);
+    EXPECT_EQ(metrics.bytes(0x0002), 3u);
+    EXPECT_EQ(metrics.unknown_methods(), 1u);
+    EXPECT_EQ(metrics.decode_errors(kSensorBatchMethod), 1u);
+    EXPECT_EQ(metrics.client_messages(0x0B05), 4u);
+}
+
+TEST_F(GatewayMetricsTest, ShardInstancesAreAggregatedInOneSnapshot) {
+    auto to_shard = [](vsomeip::method_t method, uint16_t instance) {
+        auto request = make_client_request(method, 0x0B06, 8);
+        request->set_instance(instance);
+        return request;
+    };
+    dispatch_sensor_message(to_shard(0x0001, 0x0001));
+    dispatch_sensor_message(to_shard(0x0001, 0x0002));
+    dispatch_sensor_message(to_shard(0x0003, 0x0002));
+    dispatch_sensor_message(to_shard(0x0003, 0x0042));
+
+    GatewayMetrics& metrics = gateway_metrics();
+    EXPECT_EQ(metrics.instance_messages(0x0001), 1u);
+    EXPECT_EQ(metrics.instance_messages(0x0002), 2u);
+    EXPECT_EQ(metrics.messages(0x0001), 2u);
+    std::string text = metrics.snapshot();
+    EXPECT_TRUE(contains_line(text, "gateway_instance_messages_total{instance=\"0x0001\"} 1")) << text;
+    EXPECT_TRUE(contains_line(text, "gateway_instance_messages_total{instance=\"0x0002\"} 2")) << text;
+    EXPECT_TRUE(contains_line(text, "gateway_instance_messages_total{instance=\"other\"} 1")) << text;
+    EXPECT_EQ(text.find("instance=\"0x0003\""), std::string::npos);
+}
+
+// ==================== METRICS EXPORTER TESTS ====================
+
+class MetricsExporterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char path[] = "/tmp/metrics-test-XXXXXX";
+        directory = mkdtemp(path) ? std::string(path) : std::string();
+        ASSERT_FALSE(directory.empty());
+    }
+
+    void TearDown() override {
+        std::string command = "rm -rf " + directory;
+        std::system(command.c_str());
+    }
+
+    std::string directory;
+};
+
+TEST_F(MetricsExporterTest, WritesSnapshotFile) {
+    MetricsExporterConfig config;
+    config.file = directory + "/gateway.prom";
+    config.interval = std::chrono::milliseconds(10);
+    int snapshots = 0;
+    MetricsExporter exporter(config, [&snapshots]() {
+        return "gateway_test_total " + std::to_string(++snapshots) + "\n";
+    });
+    std::string error;
+    ASSERT_TRUE(exporter.start(error)) << error;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    exporter.stop();
+
+    std::ifstream in(config.file);
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_GT(snapshots, 1);
+    EXPECT_EQ(text, "gateway_test_total " + std::to_string(snapshots) + "\n");
+    EXPECT_FALSE(std::ifstream(config.file + ".tmp").good());
+}
+
+TEST_F(MetricsExporterTest, AnswersSocketConnections) {
+    MetricsExporterConfig config;
+    config.socket = directory + "/metrics.sock";
+    MetricsExporter exporter(config, []() { return std::string("gateway_up 1\n"); });
+    std::string error;
+    ASSERT_TRUE(exporter.start(error)) << error;
+
+    EXPECT_EQ(query_socket(config.socket, ""), "gateway_up 1\n");
+    std::string http = query_socket(config.socket, "GET /metrics HTTP/1.0\r\n\r\n");
+    EXPECT_EQ(http.compare(0, 15, "HTTP/1.0 200 OK"), 0) << http;
+    EXPECT_NE(http.find("\r\n\r\ngateway_up 1\n"), std::string::npos);
+
+    exporter.stop();
+    EXPECT_NE(::access(config.socket.c_str(), F_OK), 0);
+}
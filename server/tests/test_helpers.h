@@ -0,0 +1,64 @@
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <vsomeip/vsomeip.hpp>
+#include "../event_publisher.h"
+
+// Requests and sinks shared by the gateway handler tests
+
+// 8-byte legacy sensor payload: value, then timestamp, in host byte order
+inline std::vector<vsomeip::byte_t> sample_bytes(float value, uint32_t timestamp = 0) {
+    std::vector<vsomeip::byte_t> bytes(8);
+    std::memcpy(bytes.data(), &value, 4);
+    std::memcpy(bytes.data() + 4, &timestamp, 4);
+    return bytes;
+}
+
+// Request for method carrying bytes, tagged with interface_version
+inline std::shared_ptr<vsomeip::message> make_request(vsomeip::method_t method,
+                                                      const std::vector<vsomeip::byte_t>& bytes,
+                                                      vsomeip::service_t service = 0x1234,
+                                                      vsomeip::instance_t instance = 0x0001,
+                                                      uint8_t interface_version = 0) {
+    auto request = vsomeip::runtime::get()->create_request();
+    request->set_service(service);
+    request->set_instance(instance);
+    request->set_method(method);
+    request->set_interface_version(interface_version);
+    request->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    return request;
+}
+
+// Request for method carrying one legacy sensor sample
+inline std::shared_ptr<vsomeip::message> make_sample_request(vsomeip::method_t method, float value,
+                                                             uint32_t timestamp = 0,
+                                                             vsomeip::service_t service = 0x1234,
+                                                             vsomeip::instance_t instance = 0x0001) {
+    return make_request(method, sample_bytes(value, timestamp), service, instance);
+}
+
+// Responses the gateway sent while record_response was the response sink
+inline std::vector<std::shared_ptr<vsomeip::message>> responses;
+
+inline void record_response(const std::shared_ptr<vsomeip::message> &response) {
+    responses.push_back(response);
+}
+
+// Sends every handled sample to sink as an event while in scope, then
+// disables events again, so no test leaks its sink into later ones
+class ScopedSensorEvents {
+public:
+    explicit ScopedSensorEvents(EventSink sink) {
+        NotificationPolicy every_sample = {0.0f, 0};
+        enable_sensor_events(sink, &every_sample);
+    }
+    ~ScopedSensorEvents() { enable_sensor_events(nullptr, nullptr); }
+
+    ScopedSensorEvents(const ScopedSensorEvents&) = delete;
+    ScopedSensorEvents& operator=(const ScopedSensorEvents&) = delete;
+};
+
+#endif // TEST_HELPERS_H
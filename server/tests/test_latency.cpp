@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "../sensor_data.h"
+#include "../latency_tracker.h"
+#include "latency_histogram.h"
+#include "async_log.h"
+
+// ==================== HISTOGRAM TESTS ====================
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 10; ++v) histogram.record(v);
+    
+    EXPECT_EQ(histogram.count(), 10u);
+    EXPECT_EQ(histogram.percentile(0.5), 5u);
+    EXPECT_EQ(histogram.percentile(1.0), 10u);
+    EXPECT_EQ(histogram.max(), 10u);
+    EXPECT_DOUBLE_EQ(histogram.mean(), 5.5);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinRelativeError) {
+    LatencyHistogram histogram;
+    // 1..100000 ns, uniformly
+    for (uint64_t v = 1; v <= 100000; ++v) histogram.record(v);
+    
+    EXPECT_NEAR(histogram.percentile(0.50), 50000.0, 50000.0 * 0.035);
+    EXPECT_NEAR(histogram.percentile(0.99), 99000.0, 99000.0 * 0.035);
+    EXPECT_NEAR(histogram.percentile(0.999), 99900.0, 99900.0 * 0.035);
+    EXPECT_EQ(histogram.max(), 100000u);
+}
+
+TEST(LatencyHistogramTest, BucketBoundariesAreContiguous) {
+    for (size_t i = 1; i < LatencyHistogram::kBuckets; ++i) {
+        uint64_t lower = LatencyHistogram::bucket_upper(i - 1) + 1;
+        EXPECT_EQ(LatencyHistogram::bucket_index(lower), i);
+        EXPECT_EQ(LatencyHistogram::bucket_index(LatencyHistogram::bucket_upper(i)), i);
+    }
+}
+
+TEST(LatencyHistogramTest, ClampsHugeValuesAndMerges) {
+    LatencyHistogram a, b;
+    a.record(UINT64_MAX);
+    b.record(100);
+    a.merge(b);
+    
+    EXPECT_EQ(a.count(), 2u);
+    EXPECT_EQ(a.max(), LatencyHistogram::kMaxValue);
+    EXPECT_NEAR(static_cast<double>(a.percentile(0.5)), 100.0, 100.0 * 0.035);
+}
+
+// ==================== SEQUENCE TRACKER TESTS ====================
+
+TEST(SequenceTrackerTest, CountsGapsAsLoss) {
+    SequenceTracker tracker;
+    for (uint32_t seq : {0u, 1u, 2u, 5u, 6u}) tracker.observe(1, 0, seq);
+    
+    EXPECT_EQ(tracker.lost(), 2u);
+    EXPECT_EQ(tracker.reordered(), 0u);
+}
+
+TEST(SequenceTrackerTest, LateSampleIsReorderedNotLost) {
+    SequenceTracker tracker;
+    for (uint32_t seq : {0u, 2u, 1u, 3u}) tracker.observe(1, 0, seq);
+    
+    EXPECT_EQ(tracker.lost(), 0u);
+    EXPECT_EQ(tracker.reordered(), 1u);
+}
+
+TEST(SequenceTrackerTest, ClientsAreTrackedIndependently) {
+    SequenceTracker tracker;
+    tracker.observe(1, 0, 10);
+    tracker.observe(2, 0, 500);
+    tracker.observe(1, 0, 11);
+    tracker.observe(2, 0, 501);
+    
+    EXPECT_EQ(tracker.lost(), 0u);
+}
+
+TEST(SequenceTrackerTest, StreamsOfOneClientAreTrackedIndependently) {
+    // Two signals of one client interleave their own sequences
+    SequenceTracker tracker;
+    for (uint32_t seq = 0; seq < 100; ++seq) {
+        tracker.observe(1, 0, seq);
+        tracker.observe(1, 1, seq);
+    }
+    
+    EXPECT_EQ(tracker.lost(), 0u);
+    EXPECT_EQ(tracker.reordered(), 0u);
+}
+
+TEST(SequenceTrackerTest, SequenceWrapAroundIsNotLoss) {
+    SequenceTracker tracker;
+    tracker.observe(1, 0, UINT32_MAX);
+    tracker.observe(1, 0, 0);
+    
+    EXPECT_EQ(tracker.lost(), 0u);
+    EXPECT_EQ(tracker.reordered(), 0u);
+}
+
+// ==================== HANDLER INTEGRATION ====================
+
+TEST(LatencyHandlerTest, ExtendedPayloadIsRecorded) {
+    LatencyTracker* tracker = latency_tracker(AmbientTempSensor::method_id);
+    ASSERT_NE(tracker, nullptr);
+    uint64_t before = tracker->histogram().count();
+    
+    std::vector<vsomeip::byte_t> bytes(extended_payload_size<AmbientTempSensor>());
+    encode_sensor_data<AmbientTempSensor>(AmbientTemperatureData{21.0f, 1}, bytes.data());
+    encode_sample_extension<AmbientTempSensor>(SampleExtension{0, monotonic_ns(), 0}, bytes.data());
+    auto request = vsomeip::runtime::get()->create_request();
+    request->set_method(AmbientTempSensor::method_id);
+    request->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    
+    on_ambient_temp_message(request);
+    console_log().flush();
+    
+    EXPECT_EQ(tracker->histogram().count(), before + 1);
+    EXPECT_LT(tracker->histogram().max(), 10ull * 1000 * 1000 * 1000);
+}
+
+TEST(LatencyHandlerTest, PlainPayloadIsNotRecorded) {
+    LatencyTracker* tracker = latency_tracker(SpeedSensor::method_id);
+    uint64_t before = tracker->histogram().count();
+    
+    std::vector<vsomeip::byte_t> bytes(SpeedSensor::payload_size);
+    encode_sensor_data<SpeedSensor>(SpeedData{50.0f, 1}, bytes.data());
+    auto request = vsomeip::runtime::get()->create_request();
+    request->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    
+    on_speed_message(request);
+    console_log().flush();
+    
+    EXPECT_EQ(tracker->histogram().count(), before);
+    EXPECT_EQ(latency_tracker(0x0042), nullptr);
+}
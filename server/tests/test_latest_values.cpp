@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "../sensor_data.h"
+#include "../latest_value_store.h"
+#include "seqlock.h"
+#include "latency_histogram.h"
+#include "async_log.h"
+#include "test_helpers.h"
+
+// ==================== SEQLOCK TESTS ====================
+
+// Every field carries the same number, so a torn read is easy to spot
+struct Wide {
+    uint64_t a, b, c, d;
+};
+
+TEST(SeqlockSlotTest, EmptyUntilFirstStore) {
+    SeqlockSlot<Wide> slot;
+    Wide value;
+    EXPECT_FALSE(slot.load(value));
+    EXPECT_TRUE(slot.try_store(Wide{1, 1, 1, 1}));
+    ASSERT_TRUE(slot.load(value));
+    EXPECT_EQ(value.d, 1u);
+    EXPECT_EQ(slot.version(), 1u);
+}
+
+TEST(SeqlockSlotTest, ReadersNeverSeeTornValues) {
+    SeqlockSlot<Wide> slot;
+    slot.try_store(Wide{0, 0, 0, 0});
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0);
+    
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&]() {
+            Wide value{};
+            while (!done.load()) {
+                if (!slot.load(value)) continue;
+                if (value.a != value.b || value.b != value.c || value.c != value.d) ++torn;
+            }
+        });
+    }
+    for (uint64_t i = 1; i <= 200000; ++i) slot.try_store(Wide{i, i, i, i});
+    done = true;
+    for (auto &reader : readers) reader.join();
+    
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(slot.version(), 200001u);
+}
+
+TEST(SeqlockSlotTest, TryStoreIfKeepsTheValueItDoesNotReplace) {
+    SeqlockSlot<Wide> slot;
+    auto newer = [](uint64_t a) { return [a](const Wide& current) { return a > current.a; }; };
+    EXPECT_TRUE(slot.try_store_if(Wide{5, 5, 5, 5}, newer(5)));   // empty slot: always stored
+    EXPECT_FALSE(slot.try_store_if(Wide{3, 3, 3, 3}, newer(3)));
+    EXPECT_TRUE(slot.try_store_if(Wide{7, 7, 7, 7}, newer(7)));
+    
+    Wide value;
+    ASSERT_TRUE(slot.load(value));
+    EXPECT_EQ(value.a, 7u);
+    EXPECT_EQ(slot.version(), 2u);
+}
+
+TEST(SeqlockSlotTest, ConcurrentWritersNeverWaitOrTear) {
+    SeqlockSlot<Wide> slot;
+    const uint64_t kPerWriter = 50000;
+    std::atomic<uint64_t> stored(0);
+    std::vector<std::thread> writers;
+    for (uint64_t w = 0; w < 2; ++w) {
+        writers.emplace_back([&slot, &stored, w, kPerWriter]() {
+            for (uint64_t i = 0; i < kPerWriter; ++i) {
+                if (slot.try_store(Wide{w, w, w, w})) ++stored;
+            }
+        });
+    }
+    for (auto &writer : writers) writer.join();
+    
+    // A writer that met the other gave up, and every published store counts
+    EXPECT_EQ(slot.version(), stored.load());
+    Wide value{};
+    ASSERT_TRUE(slot.load(value));
+    EXPECT_TRUE(value.a == value.b && value.b == value.c && value.c == value.d);
+}
+
+// ==================== STORE TESTS ====================
+
+TEST(LatestValueStoreTest, KeepsNewestValuePerKey) {
+    LatestValueStore store;
+    LatestValue value;
+    EXPECT_FALSE(store.lookup(0x1234, 0x0001, 0x0001, value));
+    
+    EXPECT_TRUE(store.update(0x1234, 0x0001, 0x0001, LatestValue{10.0f, 1, 100, false}));
+    EXPECT_TRUE(store.update(0x1234, 0x0001, 0x0001, LatestValue{20.0f, 2, 200, false}));
+    EXPECT_TRUE(store.update(0x1234, 0x0102, 0x0001, LatestValue{30.0f, 3, 300, true}));
+    
+    ASSERT_TRUE(store.lookup(0x1234, 0x0001, 0x0001, value));
+    EXPECT_FLOAT_EQ(value.value, 20.0f);
+    EXPECT_EQ(value.timestamp, 2u);
+    ASSERT_TRUE(store.lookup(0x1234, 0x0102, 0x0001, value));
+    EXPECT_TRUE(value.alarm);
+    EXPECT_FALSE(store.lookup(0x1234, 0x0001, 0x0002, value));
+}
+
+TEST(LatestValueStoreTest, OlderSampleNeverReplacesANewerOne) {
+    LatestValueStore store;
+    EXPECT_TRUE(store.update(0x1234, 0x0001, 0x0001, LatestValue{20.0f, 2, 200, false}));
+    // Published late by a slower thread, but received first
+    EXPECT_FALSE(store.update(0x1234, 0x0001, 0x0001, LatestValue{10.0f, 1, 100, false}));
+    
+    LatestValue value;
+    ASSERT_TRUE(store.lookup(0x1234, 0x0001, 0x0001, value));
+    EXPECT_FLOAT_EQ(value.value, 20.0f);
+    EXPECT_EQ(value.receive_ns, 200u);
+}
+
+TEST(LatestValueStoreTest, VisitsOnlyTheRequestedInstance) {
+    LatestValueStore store;
+    store.update(0x1234, 0x0001, 0x0001, LatestValue{1.0f, 0, 0, false});
+    store.update(0x1234, 0x0001, 0x0003, LatestValue{3.0f, 0, 0, false});
+    store.update(0x1234, 0x0102, 0x0002, LatestValue{2.0f, 0, 0, false});
+    store.update(0x4321, 0x0001, 0x0002, LatestValue{2.0f, 0, 0, false});
+    
+    std::vector<uint16_t> methods;
+    store.for_each(0x1234, 0x0001, [&](uint16_t method, const LatestValue&) { methods.push_back(method); });
+    std::sort(methods.begin(), methods.end());
+    EXPECT_EQ(methods, (std::vector<uint16_t>{0x0001, 0x0003}));
+}
+
+TEST(LatestValueStoreTest, ShardInstancesShareOneLogicalInstance) {
+    LatestValueStore store;
+    store.update(0x1234, shard_instance(2), 0x0001, LatestValue{12.0f, 1, 0, false});
+    store.update(0x1234, shard_instance(0), 0x0002, LatestValue{90.0f, 2, 0, false});
+    store.update(0x1234, shard_instance(1), 0x0001, LatestValue{14.0f, 3, 0, false});
+    store.update(0x1234, 0x0042, 0x0003, LatestValue{-1.0f, 4, 0, false});
+    
+    LatestValue value;
+    for (size_t shard = 0; shard < kMaxShards; ++shard) {
+        ASSERT_TRUE(store.lookup(0x1234, shard_instance(shard), 0x0001, value)) << "shard " << shard;
+        EXPECT_FLOAT_EQ(value.value, 14.0f);
+    }
+    std::vector<uint16_t> methods;
+    store.for_each(0x1234, shard_instance(3), [&](uint16_t method, const LatestValue&) { methods.push_back(method); });
+    std::sort(methods.begin(), methods.end());
+    EXPECT_EQ(methods, (std::vector<uint16_t>{0x0001, 0x0002}));
+    EXPECT_FALSE(store.lookup(0x1234, 0x0001, 0x0003, value));
+    EXPECT_TRUE(store.lookup(0x1234, 0x0042, 0x0003, value));
+}
+
+TEST(LatestValueStoreTest, RejectsKeysWhenFull) {
+    LatestValueStore store;
+    for (uint16_t method = 0; method < LatestValueStore::kCapacity; ++method) {
+        EXPECT_TRUE(store.update(0x0100, 0x0001, method, LatestValue{}));
+    }
+    EXPECT_FALSE(store.update(0x0100, 0x0001, 0x7777, LatestValue{}));
+    EXPECT_TRUE(store.update(0x0100, 0x0001, 5, LatestValue{5.0f, 0, 0, false}));
+}
+
+// ==================== QUERY METHOD TESTS ====================
+
+TEST(LatestValuesMethodTest, HandlersPublishAndQueryReturnsAll) {
+    console_log().set_enabled(false);
+    dispatch_sensor_message(make_sample_request(0x0002, 80.0f, 1, 0x0A01));
+    dispatch_sensor_message(make_sample_request(0x0001, 55.0f, 2, 0x0A01));
+    dispatch_sensor_message(make_sample_request(0x0002, 104.0f, 3, 0x0A01));
+    console_log().set_enabled(true);
+    
+    auto response = make_latest_values_response(make_request(kLatestValuesMethod, {}, 0x0A01));
+    WireFormat format;
+    ASSERT_TRUE(wire_format_from_interface_version(response->get_interface_version(), format));
+    PayloadView payload(*response->get_payload());
+    uint16_t count = 0;
+    ASSERT_TRUE(decode_latest_header(payload, count, format));
+    ASSERT_EQ(count, 2u);
+    
+    LatestValueRecord speed = decode_latest_record(payload, 0, format);
+    LatestValueRecord engine = decode_latest_record(payload, 1, format);
+    EXPECT_EQ(speed.method, 0x0001);
+    EXPECT_FLOAT_EQ(speed.value, 55.0f);
+    EXPECT_EQ(speed.flags, 0u);
+    EXPECT_EQ(engine.method, 0x0002);
+    EXPECT_FLOAT_EQ(engine.value, 104.0f);
+    EXPECT_EQ(engine.timestamp, 3u);
+    EXPECT_EQ(engine.flags, kLatestFlagAlarm);
+    EXPECT_EQ(response->get_method(), kLatestValuesMethod);
+}
+
+TEST(LatestValuesMethodTest, ExplicitMethodListInRequestOrder) {
+    latest_values().update(0x0A02, 0x0001, 0x0001, LatestValue{10.0f, 0, monotonic_ns(), false});
+    latest_values().update(0x0A02, 0x0001, 0x0003, LatestValue{-5.0f, 0, monotonic_ns(), true});
+    
+    std::vector<vsomeip::byte_t> query(6);
+    const uint16_t methods[3] = {0x0003, 0x0042, 0x0001};
+    std::memcpy(query.data(), methods, sizeof(methods));
+    auto response = make_latest_values_response(make_request(kLatestValuesMethod, query, 0x0A02));
+    
+    WireFormat format;
+    ASSERT_TRUE(wire_format_from_interface_version(response->get_interface_version(), format));
+    PayloadView payload(*response->get_payload());
+    uint16_t count = 0;
+    ASSERT_TRUE(decode_latest_header(payload, count, format));
+    ASSERT_EQ(count, 2u);
+    EXPECT_EQ(decode_latest_record(payload, 0, format).method, 0x0003);
+    EXPECT_EQ(decode_latest_record(payload, 1, format).method, 0x0001);
+    EXPECT_LT(decode_latest_record(payload, 0, format).age_ms, 1000u);
+}
+
+TEST(LatestValuesMethodTest, BatchPublishesLastSample) {
+    std::vector<vsomeip::byte_t> bytes(batch_payload_size(3));
+    encode_batch_header<AmbientTempSensor>(3, bytes.data());
+    for (size_t i = 0; i < 3; ++i) {
+        AmbientTemperatureData data = {static_cast<float>(i) - 1.0f, static_cast<uint32_t>(10 + i)};
+        encode_batch_record<AmbientTempSensor>(data, i, bytes.data());
+    }
+    console_log().set_enabled(false);
+    on_sensor_batch_message(make_request(kSensorBatchMethod, bytes, 0x0A03));
+    console_log().set_enabled(true);
+    
+    LatestValue value;
+    ASSERT_TRUE(latest_values().lookup(0x0A03, 0x0001, 0x0003, value));
+    EXPECT_FLOAT_EQ(value.value, 1.0f);
+    EXPECT_EQ(value.timestamp, 12u);
+    EXPECT_FALSE(value.alarm);
+}
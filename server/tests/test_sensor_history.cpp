@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../sensor_data.h"
+#include "../sensor_history.h"
+#include "async_log.h"
+
+static const uint64_t kMs = 1000000;
+
+// ==================== ROLLING STATISTICS TESTS ====================
+
+TEST(SensorHistoryTest, EmptyWindowReportsZeroCount) {
+    SensorHistory history(16, {1000});
+    WindowStats stats;
+    ASSERT_TRUE(history.stats(0, stats));
+    EXPECT_EQ(stats.window_ms, 1000u);
+    EXPECT_EQ(stats.count, 0u);
+    EXPECT_FALSE(history.stats(1, stats));
+}
+
+TEST(SensorHistoryTest, ComputesMinMaxMeanStddev) {
+    SensorHistory history(16, {1000});
+    for (int i = 1; i <= 5; ++i) history.add(static_cast<float>(i), i * kMs);
+    
+    WindowStats stats;
+    ASSERT_TRUE(history.stats(0, stats));
+    EXPECT_EQ(stats.count, 5u);
+    EXPECT_FLOAT_EQ(stats.min, 1.0f);
+    EXPECT_FLOAT_EQ(stats.max, 5.0f);
+    EXPECT_FLOAT_EQ(stats.mean, 3.0f);
+    EXPECT_NEAR(stats.stddev, std::sqrt(2.0f), 1e-5);
+}
+
+TEST(SensorHistoryTest, ExpiresSamplesOlderThanWindow) {
+    SensorHistory history(64, {10, 1000});
+    history.add(100.0f, 0);
+    history.add(50.0f, 5 * kMs);
+    history.add(20.0f, 12 * kMs);
+    
+    WindowStats short_window, long_window;
+    history.stats(0, short_window);
+    history.stats(1, long_window);
+    // 10 ms window at t=12 ms keeps only samples newer than t=2 ms
+    EXPECT_EQ(short_window.count, 2u);
+    EXPECT_FLOAT_EQ(short_window.max, 50.0f);
+    EXPECT_FLOAT_EQ(short_window.min, 20.0f);
+    EXPECT_EQ(long_window.count, 3u);
+    EXPECT_FLOAT_EQ(long_window.max, 100.0f);
+}
+
+TEST(SensorHistoryTest, WindowIsBoundedByCapacity) {
+    SensorHistory history(4, {60000});
+    for (int i = 0; i < 10; ++i) history.add(static_cast<float>(10 - i), i * kMs);
+    
+    WindowStats stats;
+    history.stats(0, stats);
+    EXPECT_EQ(history.size(), 4u);
+    EXPECT_EQ(stats.count, 4u);
+    EXPECT_FLOAT_EQ(stats.max, 4.0f);
+    EXPECT_FLOAT_EQ(stats.min, 1.0f);
+    EXPECT_FLOAT_EQ(stats.mean, 2.5f);
+}
+
+TEST(SensorHistoryTest, MatchesBruteForceOnRandomWalk) {
+    const size_t capacity = 32;
+    const uint32_t window_ms = 20;
+    SensorHistory history(capacity, {window_ms});
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> step(-5.0f, 5.0f);
+    std::uniform_int_distribution<int> gap(0, 3);
+    
+    std::vector<std::pair<uint64_t, float>> samples;
+    float value = 50.0f;
+    uint64_t now = 0;
+    for (int i = 0; i < 2000; ++i) {
+        value += step(rng);
+        now += gap(rng) * kMs;
+        history.add(value, now);
+        samples.emplace_back(now, value);
+        
+        // Reference: last capacity samples, restricted to the time window
+        size_t begin = samples.size() > capacity ? samples.size() - capacity : 0;
+        float lo = value, hi = value;
+        double sum = 0.0;
+        uint32_t count = 0;
+        for (size_t k = begin; k < samples.size(); ++k) {
+            if (samples[k].first + window_ms * kMs <= now) continue;
+            lo = std::min(lo, samples[k].second);
+            hi = std::max(hi, samples[k].second);
+            sum += samples[k].second;
+            ++count;
+        }
+        
+        WindowStats stats;
+        history.stats(0, stats);
+        ASSERT_EQ(stats.count, count) << "sample " << i;
+        ASSERT_FLOAT_EQ(stats.min, lo) << "sample " << i;
+        ASSERT_FLOAT_EQ(stats.max, hi) << "sample " << i;
+        ASSERT_NEAR(stats.mean, sum / count, 1e-3) << "sample " << i;
+    }
+}
+
+TEST(SensorHistoryTest, StddevStaysPreciseForLargeValuesWithSmallSpread) {
+    // Engine temperature: about 90 degrees, swinging by a few float steps
+    const size_t capacity = 256;
+    SensorHistory history(capacity, {60000});
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> noise(-0.00003f, 0.00003f);
+    
+    std::vector<float> values;
+    for (int i = 0; i < 200000; ++i) {
+        float value = 90.0f + noise(rng);
+        history.add(value, i * 1000);
+        values.push_back(value);
+    }
+    
+    // Reference: two-pass over the samples still held
+    double mean = 0.0, squared_deviations = 0.0;
+    for (size_t k = values.size() - capacity; k < values.size(); ++k) mean += values[k];
+    mean /= capacity;
+    for (size_t k = values.size() - capacity; k < values.size(); ++k) {
+        squared_deviations += (values[k] - mean) * (values[k] - mean);
+    }
+    double stddev = std::sqrt(squared_deviations / capacity);
+    
+    WindowStats stats;
+    history.stats(0, stats);
+    ASSERT_EQ(stats.count, capacity);
+    EXPECT_NEAR(stats.mean, mean, 1e-5);
+    EXPECT_NEAR(stats.stddev, stddev, stddev * 1e-2);
+}
+
+// ==================== QUERY METHOD TESTS ====================
+
+static std::shared_ptr<vsomeip::message> make_stats_request(uint16_t sensor) {
+    std::vector<vsomeip::byte_t> bytes(2);
+    std::memcpy(bytes.data(), &sensor, 2);
+    auto request = vsomeip::runtime::get()->create_request();
+    request->set_method(kSensorStatsMethod);
+    request->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    return request;
+}
+
+TEST(SensorStatsMethodTest, ReportsEveryWindowOfHandledSensor) {
+    std::vector<vsomeip::byte_t> bytes(8);
+    float value = 150.0f;
+    std::memcpy(bytes.data(), &value, 4);
+    auto request = vsomeip::runtime::get()->create_request();
+    request->set_method(SpeedSensor::method_id);
+    request->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    console_log().set_enabled(false);
+    dispatch_sensor_message(request);
+    console_log().set_enabled(true);
+    
+    auto response = make_sensor_stats_response(make_stats_request(SpeedSensor::method_id));
+    WireFormat format;
+    ASSERT_TRUE(wire_format_from_interface_version(response->get_interface_version(), format));
+    PayloadView payload(*response->get_payload());
+    uint16_t method = 0, windows = 0;
+    ASSERT_TRUE(decode_stats_header(payload, method, windows, format));
+    EXPECT_EQ(method, SpeedSensor::method_id);
+    ASSERT_EQ(windows, sensor_history(SpeedSensor::method_id)->window_count());
+    ASSERT_GT(windows, 0u);
+    
+    WindowStats stats = decode_stats_record(payload, 0, format);
+    EXPECT_GE(stats.count, 1u);
+    EXPECT_GE(stats.max, 150.0f);
+}
+
+TEST(SensorStatsMethodTest, UnknownSensorHasNoWindows) {
+    auto response = make_sensor_stats_response(make_stats_request(0x0042));
+    PayloadView payload(*response->get_payload());
+    uint16_t method = 0xFFFF, windows = 0xFFFF;
+    ASSERT_TRUE(decode_stats_header(payload, method, windows));
+    EXPECT_EQ(method, 0u);
+    EXPECT_EQ(windows, 0u);
+}
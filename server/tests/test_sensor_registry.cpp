@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <sstream>
+#include <iostream>
+#include <set>
+
+#include "../sensor_data.h"
+#include "async_log.h"
+#include "test_helpers.h"
+#include "sensor_registry.h"
+
+// ==================== DESCRIPTOR TESTS ====================
+
+TEST(SensorRegistryTest, MethodIdsAreUniqueAndContiguous) {
+    std::set<uint16_t> methods(Sensors::method_ids.begin(), Sensors::method_ids.end());
+    
+    EXPECT_EQ(methods.size(), Sensors::size);
+    EXPECT_EQ(Sensors::min_method, 0x0001);
+    EXPECT_EQ(Sensors::max_method, 0x0003);
+}
+
+TEST(SensorRegistryTest, AlarmThresholdsFromDescriptors) {
+    static_assert(is_alarm<SpeedSensor>(100.1f), "speed above limit must alarm");
+    static_assert(!is_alarm<SpeedSensor>(100.0f), "speed at limit must not alarm");
+    
+    EXPECT_TRUE(is_alarm<EngineTempSensor>(105.0f));
+    EXPECT_FALSE(is_alarm<EngineTempSensor>(100.0f));
+    EXPECT_TRUE(is_alarm<AmbientTempSensor>(-0.1f));
+    EXPECT_FALSE(is_alarm<AmbientTempSensor>(0.0f));
+}
+
+TEST(SensorRegistryTest, CriticalSensorsUseReliableTransport) {
+    EXPECT_EQ(SpeedSensor::transport, Transport::Unreliable);
+    EXPECT_EQ(EngineTempSensor::transport, Transport::Reliable);
+    EXPECT_EQ(AmbientTempSensor::transport, Transport::Unreliable);
+}
+
+TEST(SensorRegistryTest, EncodeDecodeRoundTrip) {
+    uint8_t buffer[EngineTempSensor::payload_size];
+    EngineTemperatureData in = {97.25f, 123456};
+    EngineTemperatureData out = {};
+    
+    encode_sensor_data<EngineTempSensor>(in, buffer);
+    
+    ASSERT_TRUE(decode_sensor_data<EngineTempSensor>(PayloadView(buffer, sizeof(buffer)), out));
+    EXPECT_FLOAT_EQ(out.temperature_celsius, in.temperature_celsius);
+    EXPECT_EQ(out.timestamp, in.timestamp);
+}
+
+TEST(SensorRegistryTest, DecodeRejectsShortPayload) {
+    uint8_t buffer[SpeedSensor::payload_size - 1] = {};
+    SpeedData out = {1.0f, 1};
+    
+    EXPECT_FALSE(decode_sensor_data<SpeedSensor>(PayloadView(buffer, sizeof(buffer)), out));
+    EXPECT_FLOAT_EQ(out.speed_kmh, 1.0f);
+}
+
+// ==================== DISPATCH TABLE TESTS ====================
+
+static std::string dispatch_and_capture(vsomeip::method_t method, float value) {
+    auto request = make_sample_request(method, value);
+    console_log().flush();
+    std::ostringstream buffer;
+    std::streambuf* old = std::cout.rdbuf(buffer.rdbuf());
+    dispatch_sensor_message(request);
+    console_log().flush();
+    std::cout.rdbuf(old);
+    return buffer.str();
+}
+
+TEST(SensorDispatchTest, RoutesEachMethodToItsHandler) {
+    EXPECT_THAT(dispatch_and_capture(0x0001, 50.0f), ::testing::HasSubstr("SPEED:  50.0 km/h [Method 0x0001]"));
+    EXPECT_THAT(dispatch_and_capture(0x0002, 90.0f), ::testing::HasSubstr("ENGINE:  90.0°C [Method 0x0002]"));
+    EXPECT_THAT(dispatch_and_capture(0x0003, -3.0f), ::testing::HasSubstr("AMBIENT:  -3.0°C ❄️ FREEZING! [Method 0x0003]"));
+}
+
+TEST(SensorDispatchTest, IgnoresUnknownMethods) {
+    int before = get_message_count();
+    
+    EXPECT_EQ(dispatch_and_capture(0x0000, 1.0f), "");
+    EXPECT_EQ(dispatch_and_capture(0x0004, 1.0f), "");
+    EXPECT_EQ(dispatch_and_capture(0xFFFF, 1.0f), "");
+    EXPECT_EQ(get_message_count(), before);
+}
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "../sensor_data.h"
+#include "../latest_value_store.h"
+#include "../gateway_metrics.h"
+#include "async_log.h"
+#include "sensor_snapshot.h"
+#include "test_helpers.h"
+
+// Snapshot under construction: header plus sections appended in order
+class SnapshotBuilder {
+public:
+    explicit SnapshotBuilder(WireFormat format) : format_(format), bytes_(kSnapshotHeaderSize), sections_(0) {}
+
+    template <typename S>
+    SnapshotBuilder& section(const std::vector<float>& values) {
+        size_t offset = bytes_.size();
+        bytes_.resize(offset + snapshot_section_size(values.size()));
+        encode_batch_header<S>(static_cast<uint16_t>(values.size()), bytes_.data() + offset, format_);
+        for (size_t i = 0; i < values.size(); ++i) {
+            typename S::data_type data = {};
+            data.*S::value = values[i];
+            data.timestamp = static_cast<uint32_t>(100 + i);
+            encode_batch_record<S>(data, i, bytes_.data() + offset, format_);
+        }
+        ++sections_;
+        return *this;
+    }
+
+    std::vector<uint8_t> finish(uint32_t id) {
+        encode_snapshot_header(id, sections_, bytes_.data(), format_);
+        return bytes_;
+    }
+
+private:
+    WireFormat format_;
+    std::vector<uint8_t> bytes_;
+    uint16_t sections_;
+};
+
+static std::shared_ptr<vsomeip::message> make_snapshot_request(const std::vector<uint8_t>& bytes) {
+    auto request = vsomeip::runtime::get()->create_request();
+    request->set_service(0x0C01);
+    request->set_instance(0x0001);
+    request->set_method(kSensorSnapshotMethod);
+    request->set_interface_version(interface_version_of(WireFormat::V1));
+    request->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    return request;
+}
+
+class SnapshotHandlerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        console_log().set_enabled(false);
+        responses.clear();
+        set_response_sink(record_response);
+    }
+
+    void TearDown() override {
+        set_response_sink(nullptr);
+        console_log().set_enabled(true);
+    }
+};
+
+// ==================== LAYOUT ====================
+
+TEST(SensorSnapshotTest, SectionsAreViewsIntoThePayload) {
+    std::vector<uint8_t> bytes = SnapshotBuilder(WireFormat::V1)
+                                     .section<SpeedSensor>({10.0f, 20.0f, 30.0f})
+                                     .section<AmbientTempSensor>({-1.5f})
+                                     .finish(77);
+    ASSERT_EQ(bytes.size(), kSnapshotHeaderSize + snapshot_section_size(3) + snapshot_section_size(1));
+
+    SensorSnapshotView snapshot;
+    ASSERT_TRUE(decode_snapshot_header(PayloadView(bytes), snapshot, WireFormat::V1));
+    EXPECT_EQ(snapshot.id, 77u);
+    EXPECT_EQ(snapshot.sections, 2);
+
+    size_t offset = 0;
+    SensorBatchView section;
+    ASSERT_TRUE(next_snapshot_section(snapshot, offset, section, WireFormat::V1));
+    EXPECT_EQ(section.method, SpeedSensor::method_id);
+    EXPECT_EQ(section.count, 3);
+    EXPECT_EQ(section.records.data(), bytes.data() + kSnapshotHeaderSize + kBatchHeaderSize);
+    EXPECT_EQ(decode_batch_record<SpeedSensor>(section, 2, WireFormat::V1).speed_kmh, 30.0f);
+
+    ASSERT_TRUE(next_snapshot_section(snapshot, offset, section, WireFormat::V1));
+    EXPECT_EQ(section.method, AmbientTempSensor::method_id);
+    EXPECT_EQ(decode_batch_record<AmbientTempSensor>(section, 0, WireFormat::V1).temperature_celsius, -1.5f);
+    EXPECT_EQ(offset, snapshot.body.size());
+    EXPECT_FALSE(next_snapshot_section(snapshot, offset, section, WireFormat::V1));
+}
+
+TEST(SensorSnapshotTest, TruncatedSectionIsRejected) {
+    std::vector<uint8_t> bytes = SnapshotBuilder(WireFormat::Legacy).section<SpeedSensor>({1.0f, 2.0f}).finish(1);
+    bytes.pop_back();
+    SensorSnapshotView snapshot;
+    ASSERT_TRUE(decode_snapshot_header(PayloadView(bytes), snapshot));
+    size_t offset = 0;
+    SensorBatchView section;
+    EXPECT_FALSE(next_snapshot_section(snapshot, offset, section));
+
+    std::vector<uint8_t> short_header(kSnapshotHeaderSize - 1);
+    EXPECT_FALSE(decode_snapshot_header(PayloadView(short_header), snapshot));
+}
+
+// ==================== GATEWAY HANDLER ====================
+
+TEST_F(SnapshotHandlerTest, ProcessesEverySection) {
+    std::vector<float> speeds(1000);
+    for (size_t i = 0; i < speeds.size(); ++i) speeds[i] = static_cast<float>(i % 90);
+    std::vector<uint8_t> bytes = SnapshotBuilder(WireFormat::V1)
+                                     .section<SpeedSensor>(speeds)
+                                     .section<EngineTempSensor>({95.0f, 104.0f})
+                                     .finish(5);
+    ASSERT_GT(bytes.size(), 1400u);   // more than one UDP datagram: SOME/IP-TP territory
+    int before = get_message_count();
+    uint64_t snapshots = gateway_metrics().messages(kSensorSnapshotMethod);
+
+    on_sensor_snapshot_message(make_snapshot_request(bytes));
+
+    EXPECT_EQ(get_message_count(), before + 1002);
+    EXPECT_EQ(gateway_metrics().messages(kSensorSnapshotMethod), snapshots + 1);
+    LatestValue value = {};
+    ASSERT_TRUE(latest_values().lookup(0x0C01, 0x0001, SpeedSensor::method_id, value));
+    EXPECT_EQ(value.value, speeds.back());
+    ASSERT_TRUE(latest_values().lookup(0x0C01, 0x0001, EngineTempSensor::method_id, value));
+    EXPECT_EQ(value.value, 104.0f);
+    EXPECT_TRUE(value.alarm);
+    ASSERT_EQ(responses.size(), 1u);
+    EXPECT_EQ(responses[0]->get_return_code(), vsomeip::return_code_e::E_OK);
+}
+
+TEST_F(SnapshotHandlerTest, TruncatedSnapshotIsRejectedAsAWhole) {
+    std::vector<uint8_t> bytes = SnapshotBuilder(WireFormat::V1)
+                                     .section<SpeedSensor>({50.0f})
+                                     .section<AmbientTempSensor>({5.0f, 6.0f})
+                                     .finish(6);
+    bytes.resize(bytes.size() - 3);
+    int before = get_message_count();
+    uint64_t errors = gateway_metrics().decode_errors(kSensorSnapshotMethod);
+
+    on_sensor_snapshot_message(make_snapshot_request(bytes));
+
+    EXPECT_EQ(get_message_count(), before);
+    EXPECT_EQ(gateway_metrics().decode_errors(kSensorSnapshotMethod), errors + 1);
+    ASSERT_EQ(responses.size(), 1u);
+    EXPECT_EQ(responses[0]->get_return_code(), vsomeip::return_code_e::E_MALFORMED_MESSAGE);
+}
+
+TEST_F(SnapshotHandlerTest, UnknownSensorSectionsAreSkipped) {
+    std::vector<uint8_t> bytes = SnapshotBuilder(WireFormat::V1).section<SpeedSensor>({42.0f}).finish(7);
+    // Append a section of a sensor this gateway does not know (method 0x0009, one record)
+    size_t offset = bytes.size();
+    bytes.resize(offset + snapshot_section_size(1));
+    store_wire(WireFormat::V1, bytes.data() + offset + kBatchMethodOffset, uint16_t(0x0009));
+    store_wire(WireFormat::V1, bytes.data() + offset + kBatchCountOffset, uint16_t(1));
+    store_wire(WireFormat::V1, bytes.data() + kSnapshotSectionsOffset, uint16_t(2));
+    int before = get_message_count();
+
+    on_sensor_snapshot_message(make_snapshot_request(bytes));
+
+    EXPECT_EQ(get_message_count(), before + 1);
+    ASSERT_EQ(responses.size(), 1u);
+    EXPECT_EQ(responses[0]->get_return_code(), vsomeip::return_code_e::E_OK);
+}
+
+TEST_F(SnapshotHandlerTest, OversizedSnapshotIsRejected) {
+    std::vector<uint8_t> bytes = SnapshotBuilder(WireFormat::V1).section<SpeedSensor>({1.0f}).finish(8);
+    bytes.resize(kMaxSnapshotSize + 1);
+    int before = get_message_count();
+
+    on_sensor_snapshot_message(make_snapshot_request(bytes));
+
+    EXPECT_EQ(get_message_count(), before);
+    ASSERT_EQ(responses.size(), 1u);
+    EXPECT_EQ(responses[0]->get_return_code(), vsomeip::return_code_e::E_MALFORMED_MESSAGE);
+}
@@ -236,3 +236,49 @@ TEST(MemoryTest, MultipleDeserializationCalls) {
         EXPECT_EQ(result.timestamp, test_timestamp);
     }
 }
+
+// ==================== PAYLOAD VIEW TESTS ====================
+
+TEST(PayloadViewTest, DeserializeFromRawBuffer) {
+    auto payload = create_payload(72.5f, 4242);
+    PayloadView view(payload.data(), payload.size());
+    
+    SpeedData result = deserialize_speed_data(view);
+    
+    EXPECT_FLOAT_EQ(result.speed_kmh, 72.5f);
+    EXPECT_EQ(result.timestamp, 4242u);
+}
+
+TEST(PayloadViewTest, DeserializeFromVsomeipPayload) {
+    auto payload = create_payload(-12.0f, 777);
+    auto someip_payload = vsomeip::runtime::get()->create_payload(payload);
+    
+    AmbientTemperatureData result = deserialize_ambient_temp_data(PayloadView(*someip_payload));
+    
+    EXPECT_FLOAT_EQ(result.temperature_celsius, -12.0f);
+    EXPECT_EQ(result.timestamp, 777u);
+}
+
+TEST(PayloadViewTest, DecodeRejectsShortPayload) {
+    std::vector<uint8_t> short_payload(7, 0x42);
+    EngineTemperatureData result = {42.0f, 42};
+    
+    EXPECT_FALSE(decode_engine_temp_data(PayloadView(short_payload), result));
+    
+    // Output must be left untouched on failure
+    EXPECT_FLOAT_EQ(result.temperature_celsius, 42.0f);
+    EXPECT_EQ(result.timestamp, 42u);
+}
+
+TEST(PayloadViewTest, ReadIsBoundsChecked) {
+    auto payload = create_payload(1.0f, 2);
+    PayloadView view(payload);
+    uint32_t value = 0;
+    
+    EXPECT_TRUE(view.read(4, value));
+    EXPECT_EQ(value, 2u);
+    EXPECT_FALSE(view.read(5, value));
+    EXPECT_FALSE(view.read(SIZE_MAX, value));
+    EXPECT_FALSE(PayloadView().contains(0, 1));
+    EXPECT_TRUE(PayloadView().contains(0, 0));
+}
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <sstream>
+#include <iostream>
+#include <cstring>
+#include <functional>
+
+#include "../sensor_data.h"
+#include "../latest_value_store.h"
+#include "../sensor_history.h"
+#include "../event_publisher.h"
+#include "async_log.h"
+#include "test_helpers.h"
+
+// Runs func and returns everything the console sink wrote meanwhile
+static std::string capture_console_output(const std::function<void()>& func) {
+    console_log().flush();
+    std::ostringstream buffer;
+    std::streambuf* old = std::cout.rdbuf(buffer.rdbuf());
+    func();
+    console_log().flush();
+    std::cout.rdbuf(old);
+    return buffer.str();
+}
+
+// ==================== MESSAGE HANDLER TESTS ====================
+
+TEST(HandlerTest, SpeedMessageNormalSpeed) {
+    auto request = make_sample_request(0x0001, 85.5f, 12345);
+    
+    std::string output = capture_console_output([&]() { on_speed_message(request); });
+    
+    EXPECT_THAT(output, ::testing::HasSubstr("SPEED:  85.5 km/h"));
+    EXPECT_THAT(output, ::testing::HasSubstr("[Method 0x0001]"));
+    EXPECT_THAT(output, ::testing::Not(::testing::HasSubstr("HIGH SPEED")));
+}
+
+TEST(HandlerTest, SpeedMessageHighSpeed) {
+    auto request = make_sample_request(0x0001, 120.0f, 98765);
+    
+    std::string output = capture_console_output([&]() { on_speed_message(request); });
+    
+    EXPECT_THAT(output, ::testing::HasSubstr("120.0"));
+    EXPECT_THAT(output, ::testing::HasSubstr("⚠️ HIGH SPEED!"));
+}
+
+TEST(HandlerTest, EngineTemperatureOverheat) {
+    auto request = make_sample_request(0x0002, 105.0f, 11111);
+    
+    std::string output = capture_console_output([&]() { on_engine_temp_message(request); });
+    
+    EXPECT_THAT(output, ::testing::HasSubstr("ENGINE: 105.0°C"));
+    EXPECT_THAT(output, ::testing::HasSubstr("🚨 OVERHEAT!"));
+    EXPECT_THAT(output, ::testing::HasSubstr("[Method 0x0002]"));
+}
+
+TEST(HandlerTest, AmbientTemperatureFreezing) {
+    auto request = make_sample_request(0x0003, -10.0f, 77777);
+    
+    std::string output = capture_console_output([&]() { on_ambient_temp_message(request); });
+    
+    EXPECT_THAT(output, ::testing::HasSubstr("AMBIENT: -10.0°C"));
+    EXPECT_THAT(output, ::testing::HasSubstr("❄️ FREEZING!"));
+    EXPECT_THAT(output, ::testing::HasSubstr("[Method 0x0003]"));
+}
+
+TEST(HandlerTest, MessageCountIncrements) {
+    auto request = make_sample_request(0x0001, 50.0f, 1);
+    int before = get_message_count();
+    
+    capture_console_output([&]() {
+        on_speed_message(request);
+        on_engine_temp_message(request);
+        on_ambient_temp_message(request);
+    });
+    
+    EXPECT_EQ(get_message_count(), before + 3);
+}
+
+static int malformed_notifications = 0;
+
+static void count_notification(uint16_t, uint16_t, uint16_t, const std::shared_ptr<vsomeip::payload> &) {
+    ++malformed_notifications;
+}
+
+TEST(HandlerTest, ShortPayloadIsNotIngested) {
+    ScopedSensorEvents events_on(count_notification);
+    auto good = make_sample_request(0x0002, 96.0f, 7);
+    good->set_service(0x0A10);
+    auto short_request = make_sample_request(0x0002, 0.0f, 0);
+    short_request->set_service(0x0A10);
+    std::vector<vsomeip::byte_t> three_bytes(3);
+    short_request->set_payload(vsomeip::runtime::get()->create_payload(three_bytes));
+    
+    capture_console_output([&]() { dispatch_sensor_message(good); });
+    malformed_notifications = 0;
+    const size_t history_before = sensor_history(0x0002)->size();
+    const uint64_t notified_before = sensor_event_channel(0x0002)->notifications();
+    int before = get_message_count();
+    
+    std::string output = capture_console_output([&]() { dispatch_sensor_message(short_request); });
+    
+    LatestValue latest;
+    ASSERT_TRUE(latest_values().lookup(0x0A10, 0x0001, 0x0002, latest));
+    EXPECT_FLOAT_EQ(latest.value, 96.0f);
+    EXPECT_EQ(latest.timestamp, 7u);
+    EXPECT_EQ(sensor_history(0x0002)->size(), history_before);
+    EXPECT_EQ(sensor_event_channel(0x0002)->notifications(), notified_before);
+    EXPECT_EQ(malformed_notifications, 0);
+    EXPECT_EQ(get_message_count(), before);
+    EXPECT_EQ(output, "");
+}
+
+// ==================== BATCH HANDLER TESTS ====================
+
+// Helper function to build a batch request from raw sensor values
+template <typename S>
+static std::shared_ptr<vsomeip::message> make_batch_request(const std::vector<float>& values) {
+    std::vector<vsomeip::byte_t> bytes(batch_payload_size(values.size()));
+    encode_batch_header<S>(static_cast<uint16_t>(values.size()), bytes.data());
+    for (size_t i = 0; i < values.size(); ++i) {
+        typename S::data_type data = {};
+        data.*S::value = values[i];
+        data.timestamp = static_cast<uint32_t>(i);
+        encode_batch_record<S>(data, i, bytes.data());
+    }
+    
+    auto request = vsomeip::runtime::get()->create_request();
+    request->set_method(kSensorBatchMethod);
+    request->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    return request;
+}
+
+TEST(BatchHandlerTest, DecodesAllSamplesInOnePass) {
+    auto request = make_batch_request<EngineTempSensor>({90.0f, 101.5f, 95.0f, 88.0f});
+    int before = get_message_count();
+    
+    std::string output = capture_console_output([&]() { on_sensor_batch_message(request); });
+    
+    EXPECT_EQ(get_message_count(), before + 4);
+    EXPECT_THAT(output, ::testing::HasSubstr("BATCH 🔥 ENGINE x4: min  88.0 max 101.5 last  88.0°C"));
+    EXPECT_THAT(output, ::testing::HasSubstr("🚨 OVERHEAT!"));
+    EXPECT_THAT(output, ::testing::HasSubstr("[Method 0x0010]"));
+}
+
+TEST(BatchHandlerTest, IgnoresTruncatedBatch) {
+    auto request = make_batch_request<SpeedSensor>({10.0f, 20.0f, 30.0f});
+    auto payload = request->get_payload();
+    std::vector<vsomeip::byte_t> truncated(payload->get_data(), payload->get_data() + payload->get_length() - 1);
+    request->set_payload(vsomeip::runtime::get()->create_payload(truncated));
+    int before = get_message_count();
+    
+    std::string output = capture_console_output([&]() { on_sensor_batch_message(request); });
+    
+    EXPECT_EQ(get_message_count(), before);
+    EXPECT_EQ(output, "");
+}
+
+TEST(BatchHandlerTest, IgnoresUnknownSensorMethod) {
+    auto request = make_batch_request<SpeedSensor>({10.0f});
+    uint16_t unknown = 0x0042;
+    request->get_payload()->get_data()[0] = static_cast<vsomeip::byte_t>(unknown & 0xFF);
+    request->get_payload()->get_data()[1] = static_cast<vsomeip::byte_t>(unknown >> 8);
+    int before = get_message_count();
+    
+    capture_console_output([&]() { on_sensor_batch_message(request); });
+    
+    EXPECT_EQ(get_message_count(), before);
+}
+
+// ==================== ACKNOWLEDGED REQUEST TESTS ====================
+
+// Runs func with the response sink installed and the console silenced
+static void with_response_sink(const std::function<void()>& func) {
+    responses.clear();
+    set_response_sink(record_response);
+    capture_console_output(func);
+    set_response_sink(nullptr);
+}
+
+TEST(AcknowledgeTest, RequestGetsOkResponse) {
+    auto request = make_sample_request(0x0002, 90.0f, 1);
+    request->set_session(0x0042);
+    
+    with_response_sink([&]() { dispatch_sensor_message(request); });
+    
+    ASSERT_EQ(responses.size(), 1u);
+    EXPECT_EQ(responses[0]->get_message_type(), vsomeip::message_type_e::MT_RESPONSE);
+    EXPECT_EQ(responses[0]->get_return_code(), vsomeip::return_code_e::E_OK);
+    EXPECT_EQ(responses[0]->get_method(), 0x0002);
+}
+
+TEST(AcknowledgeTest, NoReturnRequestIsNotAnswered) {
+    auto request = make_sample_request(0x0001, 50.0f, 1);
+    request->set_message_type(vsomeip::message_type_e::MT_REQUEST_NO_RETURN);
+    auto batch = make_batch_request<SpeedSensor>({10.0f});
+    batch->set_message_type(vsomeip::message_type_e::MT_REQUEST_NO_RETURN);
+    int before = get_message_count();
+    
+    with_response_sink([&]() {
+        dispatch_sensor_message(request);
+        on_sensor_batch_message(batch);
+    });
+    
+    EXPECT_TRUE(responses.empty());
+    EXPECT_EQ(get_message_count(), before + 2);
+}
+
+TEST(AcknowledgeTest, ErrorsCarryReturnCode) {
+    auto unknown = make_sample_request(0x0009, 1.0f, 1);
+    auto short_request = make_sample_request(0x0001, 1.0f, 1);
+    std::vector<vsomeip::byte_t> four_bytes(4);
+    short_request->set_payload(vsomeip::runtime::get()->create_payload(four_bytes));
+    auto truncated_batch = make_batch_request<SpeedSensor>({1.0f});
+    std::vector<vsomeip::byte_t> three_bytes(3);
+    truncated_batch->set_payload(vsomeip::runtime::get()->create_payload(three_bytes));
+    
+    with_response_sink([&]() {
+        dispatch_sensor_message(unknown);
+        dispatch_sensor_message(short_request);
+        on_sensor_batch_message(truncated_batch);
+    });
+    
+    ASSERT_EQ(responses.size(), 3u);
+    EXPECT_EQ(responses[0]->get_message_type(), vsomeip::message_type_e::MT_ERROR);
+    EXPECT_EQ(responses[0]->get_return_code(), vsomeip::return_code_e::E_UNKNOWN_METHOD);
+    EXPECT_EQ(responses[1]->get_return_code(), vsomeip::return_code_e::E_MALFORMED_MESSAGE);
+    EXPECT_EQ(responses[2]->get_return_code(), vsomeip::return_code_e::E_MALFORMED_MESSAGE);
+}
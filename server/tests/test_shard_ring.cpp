@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <vector>
+
+#include "shard_ring.h"
+
+// ==================== SHARD RING TESTS ====================
+
+TEST(ShardRingTest, EmptyRingHasNoInstance) {
+    ShardRing ring(std::vector<uint16_t>{});
+    EXPECT_EQ(ring.instance_for(7), 0);
+}
+
+TEST(ShardRingTest, SingleShardServesEveryEcu) {
+    ShardRing ring = ShardRing::of_shards(1);
+    for (uint32_t ecu = 0; ecu < 1000; ++ecu) {
+        EXPECT_EQ(ring.instance_for(ecu), kFirstShardInstance);
+    }
+}
+
+TEST(ShardRingTest, InstancesFollowTheShardIndex) {
+    ShardRing ring = ShardRing::of_shards(3);
+    EXPECT_EQ(ring.instances(), (std::vector<uint16_t>{0x0001, 0x0002, 0x0003}));
+    EXPECT_EQ(shard_application_name(0), "central_gateway");
+    EXPECT_EQ(shard_application_name(2), "central_gateway_2");
+}
+
+TEST(ShardRingTest, MappingDoesNotDependOnInstanceOrder) {
+    ShardRing forward(std::vector<uint16_t>{0x0001, 0x0002, 0x0003, 0x0004});
+    ShardRing backward(std::vector<uint16_t>{0x0004, 0x0003, 0x0002, 0x0001});
+    for (uint32_t ecu = 0; ecu < 1000; ++ecu) {
+        EXPECT_EQ(forward.instance_for(ecu), backward.instance_for(ecu));
+    }
+}
+
+TEST(ShardRingTest, EcusSpreadOverAllShards) {
+    ShardRing ring = ShardRing::of_shards(4);
+    std::map<uint16_t, int> ecus_per_instance;
+    for (uint32_t ecu = 0; ecu < 10000; ++ecu) ++ecus_per_instance[ring.instance_for(ecu)];
+
+    ASSERT_EQ(ecus_per_instance.size(), 4u);
+    for (const auto& entry : ecus_per_instance) {
+        EXPECT_GT(entry.second, 1500) << "instance " << entry.first;
+        EXPECT_LT(entry.second, 3500) << "instance " << entry.first;
+    }
+}
+
+TEST(ShardRingTest, AddingAShardOnlyMovesEcusToIt) {
+    ShardRing before = ShardRing::of_shards(4);
+    ShardRing after = ShardRing::of_shards(5);
+    int moved = 0;
+    for (uint32_t ecu = 0; ecu < 10000; ++ecu) {
+        uint16_t old_instance = before.instance_for(ecu);
+        uint16_t new_instance = after.instance_for(ecu);
+        if (old_instance == new_instance) continue;
+        EXPECT_EQ(new_instance, shard_instance(4));
+        ++moved;
+    }
+    // About a fifth of the ECUs, not a reshuffle of all of them
+    EXPECT_GT(moved, 1000);
+    EXPECT_LT(moved, 3000);
+}
+
+TEST(ShardRingTest, RemovingAShardOnlyMovesItsEcus) {
+    ShardRing before(std::vector<uint16_t>{0x0001, 0x0002, 0x0003});
+    ShardRing after(std::vector<uint16_t>{0x0001, 0x0003});
+    for (uint32_t ecu = 0; ecu < 10000; ++ecu) {
+        uint16_t old_instance = before.instance_for(ecu);
+        if (old_instance != 0x0002) {
+            EXPECT_EQ(after.instance_for(ecu), old_instance);
+        }
+    }
+}
+
+TEST(ShardRingTest, BoundedAssignmentCapsEveryShard) {
+    ShardRing ring = ShardRing::of_shards(4);
+    std::vector<uint16_t> assigned = ring.assign(16);
+    std::map<uint16_t, int> ecus_per_instance;
+    for (uint16_t instance : assigned) ++ecus_per_instance[instance];
+
+    ASSERT_EQ(assigned.size(), 16u);
+    for (const auto& entry : ecus_per_instance) {
+        EXPECT_GE(entry.first, 0x0001);
+        EXPECT_LE(entry.first, 0x0004);
+        EXPECT_LE(entry.second, 5) << "instance " << entry.first;   // ceil(16 / 4 * 1.25)
+    }
+}
+
+TEST(ShardRingTest, BoundedAssignmentFollowsTheRingWhileThereIsRoom) {
+    ShardRing ring = ShardRing::of_shards(3);
+    std::vector<uint16_t> unbounded = ring.assign(100, 100.0);
+    for (uint32_t ecu = 0; ecu < 100; ++ecu) {
+        EXPECT_EQ(unbounded[ecu], ring.instance_for(ecu));
+    }
+}
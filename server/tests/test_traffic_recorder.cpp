@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../sensor_data.h"
+#include "../traffic_recorder.h"
+#include "capture_format.h"
+#include "async_log.h"
+
+// Fresh capture directory per test
+static std::string make_capture_dir() {
+    char path[] = "/tmp/capture-test-XXXXXX";
+    return mkdtemp(path) ? std::string(path) : std::string();
+}
+
+static std::vector<uint8_t> read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static bool file_exists(const std::string& path) {
+    std::ifstream in(path);
+    return in.good();
+}
+
+static std::shared_ptr<vsomeip::message> make_message(vsomeip::method_t method, uint16_t session, size_t length) {
+    auto message = vsomeip::runtime::get()->create_request();
+    message->set_service(0x1234);
+    message->set_instance(0x0001);
+    message->set_method(method);
+    message->set_client(0x0B01);
+    message->set_session(session);
+    std::vector<vsomeip::byte_t> bytes(length);
+    for (size_t i = 0; i < length; ++i) bytes[i] = static_cast<vsomeip::byte_t>(session + i);
+    message->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    return message;
+}
+
+// Reads every record of one segment in order
+static std::vector<CaptureRecordHeader> read_segment(const std::string& path, std::vector<std::vector<uint8_t>>* payloads) {
+    std::vector<uint8_t> bytes = read_file(path);
+    std::vector<CaptureRecordHeader> records;
+    PayloadView data(bytes);
+    CaptureSegmentHeader segment;
+    if (!decode_capture_segment_header(data, segment)) return records;
+    
+    CaptureRecordHeader header;
+    PayloadView payload;
+    for (size_t offset = segment.header_size; decode_capture_record(data, offset, header, payload);
+         offset += header.record_size) {
+        records.push_back(header);
+        if (payloads) payloads->emplace_back(payload.data(), payload.data() + payload.size());
+    }
+    return records;
+}
+
+// ==================== TRAFFIC RECORDER TESTS ====================
+
+class TrafficRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        console_log().set_enabled(false);
+        directory = make_capture_dir();
+        ASSERT_FALSE(directory.empty());
+    }
+    
+    void TearDown() override {
+        set_traffic_recorder(nullptr);
+        console_log().set_enabled(true);
+        std::string command = "rm -rf " + directory;
+        std::system(command.c_str());
+    }
+    
+    std::string directory;
+};
+
+TEST_F(TrafficRecorderTest, RecordsMessagesInOrder) {
+    RecorderConfig config;
+    config.directory = directory;
+    config.chunk_bytes = 4096;
+    TrafficRecorder recorder(config);
+    std::string error;
+    ASSERT_TRUE(recorder.start(error)) << error;
+    
+    for (uint16_t session = 1; session <= 100; ++session) {
+        auto message = make_message(0x0002, session, session % 13);
+        message->set_reliable(session % 2 == 0);
+        ASSERT_TRUE(recorder.record(*message, 1000 + session));
+    }
+    recorder.stop();
+    
+    std::vector<std::vector<uint8_t>> payloads;
+    auto records = read_segment(capture_segment_path(directory, 0, "seg"), &payloads);
+    ASSERT_EQ(records.size(), 100u);
+    for (uint16_t i = 0; i < 100; ++i) {
+        uint16_t session = i + 1;
+        EXPECT_EQ(records[i].receive_ns, 1000u + session);
+        EXPECT_EQ(records[i].service, 0x1234);
+        EXPECT_EQ(records[i].method, 0x0002);
+        EXPECT_EQ(records[i].client, 0x0B01);
+        EXPECT_EQ(records[i].session, session);
+        EXPECT_EQ(records[i].reliable, session % 2 == 0 ? 1 : 0);
+        ASSERT_EQ(payloads[i].size(), session % 13u);
+        for (size_t j = 0; j < payloads[i].size(); ++j) {
+            EXPECT_EQ(payloads[i][j], static_cast<uint8_t>(session + j));
+        }
+    }
+    EXPECT_EQ(recorder.records(), 100u);
+    EXPECT_EQ(recorder.dropped(), 0u);
+}
+
+TEST_F(TrafficRecorderTest, WritesSegmentHeaderAndIndex) {
+    RecorderConfig config;
+    config.directory = directory;
+    TrafficRecorder recorder(config);
+    std::string error;
+    ASSERT_TRUE(recorder.start(error)) << error;
+    
+    const size_t count = 2 * kCaptureIndexStride + 10;
+    for (size_t i = 0; i < count; ++i) {
+        recorder.record(*make_message(0x0001, static_cast<uint16_t>(i), 8), 5000 + i);
+    }
+    recorder.stop();
+    
+    std::vector<uint8_t> segment_bytes = read_file(capture_segment_path(directory, 0, "seg"));
+    CaptureSegmentHeader segment;
+    ASSERT_TRUE(decode_capture_segment_header(PayloadView(segment_bytes), segment));
+    EXPECT_EQ(segment.segment, 0u);
+    EXPECT_EQ(segment.first_receive_ns, 5000u);
+    
+    std::vector<uint8_t> index = read_file(capture_segment_path(directory, 0, "idx"));
+    ASSERT_GE(index.size(), sizeof(CaptureIndexHeader));
+    CaptureIndexHeader header;
+    std::memcpy(&header, index.data(), sizeof(header));
+    EXPECT_EQ(std::memcmp(header.magic, "VSCAPIDX", 8), 0);
+    EXPECT_EQ(header.records, count);
+    EXPECT_EQ(header.last_receive_ns, 5000u + count - 1);
+    ASSERT_EQ(index.size(), sizeof(header) + 3 * sizeof(CaptureIndexEntry));
+    
+    // Every entry points at the record it names
+    for (size_t i = 0; i < 3; ++i) {
+        CaptureIndexEntry entry;
+        std::memcpy(&entry, index.data() + sizeof(header) + i * sizeof(entry), sizeof(entry));
+        EXPECT_EQ(entry.record, i * kCaptureIndexStride);
+        CaptureRecordHeader record;
+        PayloadView payload;
+        ASSERT_TRUE(decode_capture_record(PayloadView(segment_bytes), entry.offset, record, payload));
+        EXPECT_EQ(record.receive_ns, entry.receive_ns);
+        EXPECT_EQ(record.receive_ns, 5000u + entry.record);
+    }
+}
+
+TEST_F(TrafficRecorderTest, RotatesSegments) {
+    RecorderConfig config;
+    config.directory = directory;
+    config.segment_bytes = 8192;
+    config.chunk_bytes = 2048;
+    config.chunks = 64;
+    TrafficRecorder recorder(config);
+    std::string error;
+    ASSERT_TRUE(recorder.start(error)) << error;
+    
+    const size_t count = 1000;
+    for (size_t i = 0; i < count; ++i) {
+        recorder.record(*make_message(0x0003, static_cast<uint16_t>(i), 8), i);
+    }
+    recorder.stop();
+    EXPECT_EQ(recorder.dropped(), 0u);
+    EXPECT_GT(recorder.segments(), 1u);
+    
+    // Records continue across segments without gaps
+    size_t next = 0;
+    for (uint64_t segment = 0; segment < recorder.segments(); ++segment) {
+        std::string path = capture_segment_path(directory, segment, "seg");
+        ASSERT_TRUE(file_exists(capture_segment_path(directory, segment, "idx")));
+        EXPECT_LE(read_file(path).size(), config.segment_bytes);
+        for (const auto& record : read_segment(path, nullptr)) {
+            EXPECT_EQ(record.receive_ns, next);
+            ++next;
+        }
+    }
+    EXPECT_EQ(next, count);
+}
+
+TEST_F(TrafficRecorderTest, DropsInsteadOfBlockingWhenBuffersAreFull) {
+    RecorderConfig config;
+    config.directory = directory;
+    config.chunk_bytes = 256;
+    config.chunks = 2;
+    TrafficRecorder recorder(config);
+    
+    // Not started: nothing is buffered and nothing blocks
+    EXPECT_FALSE(recorder.record(*make_message(0x0001, 1, 8), 1));
+    EXPECT_EQ(recorder.dropped(), 1u);
+    
+    // Oversized records can never fit a chunk
+    std::string error;
+    ASSERT_TRUE(recorder.start(error)) << error;
+    EXPECT_FALSE(recorder.record(*make_message(0x0001, 2, 512), 2));
+    EXPECT_EQ(recorder.dropped(), 2u);
+    recorder.stop();
+}
+
+TEST_F(TrafficRecorderTest, HandlersFeedInstalledRecorder) {
+    RecorderConfig config;
+    config.directory = directory;
+    TrafficRecorder recorder(config);
+    std::string error;
+    ASSERT_TRUE(recorder.start(error)) << error;
+    set_traffic_recorder(&recorder);
+    
+    std::vector<vsomeip::byte_t> bytes(8, 0);
+    auto message = make_message(0x0001, 7, 0);
+    message->set_payload(vsomeip::runtime::get()->create_payload(bytes));
+    dispatch_sensor_message(message);
+    dispatch_sensor_message(make_message(0x0077, 8, 3));   // unknown methods are captured as well
+    
+    set_traffic_recorder(nullptr);
+    dispatch_sensor_message(make_message(0x0001, 9, 8));
+    recorder.stop();
+    
+    auto records = read_segment(capture_segment_path(directory, 0, "seg"), nullptr);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].session, 7);
+    EXPECT_EQ(records[0].payload_length, 8u);
+    EXPECT_EQ(records[1].method, 0x0077);
+}
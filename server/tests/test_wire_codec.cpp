@@ -0,0 +1,270 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <sstream>
+#include <iostream>
+#include <functional>
+#include <vector>
+
+#include "../sensor_data.h"
+#include "../latest_value_store.h"
+#include "../sensor_history.h"
+#include "../event_publisher.h"
+#include "../gateway_metrics.h"
+#include "async_log.h"
+#include "capture_format.h"
+#include "sensor_batch.h"
+#include "test_helpers.h"
+
+template <typename S>
+static std::vector<uint8_t> encode_sample(float value, uint32_t timestamp, WireFormat format) {
+    std::vector<uint8_t> bytes(S::payload_size);
+    typename S::data_type data = {};
+    data.*S::value = value;
+    data.timestamp = timestamp;
+    encode_sensor_data<S>(data, bytes.data(), format);
+    return bytes;
+}
+
+// Runs func with the console silenced
+static void silence_console(const std::function<void()>& func) {
+    console_log().flush();
+    std::ostringstream buffer;
+    std::streambuf* old = std::cout.rdbuf(buffer.rdbuf());
+    func();
+    console_log().flush();
+    std::cout.rdbuf(old);
+}
+
+// ==================== FIELD CODECS ====================
+
+TEST(WireCodecTest, StoreBigEndianWritesNetworkOrder) {
+    uint8_t bytes[8];
+    store_be<uint16_t>(bytes, 0x0102);
+    EXPECT_EQ(bytes[0], 0x01);
+    EXPECT_EQ(bytes[1], 0x02);
+
+    store_be<uint32_t>(bytes, 0x01020304u);
+    EXPECT_EQ(std::vector<uint8_t>(bytes, bytes + 4), (std::vector<uint8_t>{0x01, 0x02, 0x03, 0x04}));
+
+    store_be<uint64_t>(bytes, 0x0102030405060708ull);
+    EXPECT_EQ(std::vector<uint8_t>(bytes, bytes + 8),
+              (std::vector<uint8_t>{0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08}));
+
+    store_be(bytes, 1.0f);   // IEEE 754 0x3F800000
+    EXPECT_EQ(std::vector<uint8_t>(bytes, bytes + 4), (std::vector<uint8_t>{0x3F, 0x80, 0x00, 0x00}));
+}
+
+TEST(WireCodecTest, LoadInvertsStoreInBothFormats) {
+    const WireFormat formats[] = {WireFormat::Legacy, WireFormat::V1};
+    for (WireFormat format : formats) {
+        uint8_t bytes[8];
+        store_wire(format, bytes, -273.15f);
+        EXPECT_EQ(load_wire<float>(format, bytes), -273.15f);
+        store_wire(format, bytes, uint16_t(0xBEEF));
+        EXPECT_EQ(load_wire<uint16_t>(format, bytes), 0xBEEF);
+        store_wire(format, bytes, 0xDEADBEEFu);
+        EXPECT_EQ(load_wire<uint32_t>(format, bytes), 0xDEADBEEFu);
+        store_wire(format, bytes, 0x1122334455667788ull);
+        EXPECT_EQ(load_wire<uint64_t>(format, bytes), 0x1122334455667788ull);
+    }
+}
+
+TEST(WireCodecTest, LegacyIsHostOrder) {
+    uint8_t bytes[4];
+    store_wire(WireFormat::Legacy, bytes, 0x01020304u);
+    uint32_t host;
+    std::memcpy(&host, bytes, sizeof(host));
+    EXPECT_EQ(host, 0x01020304u);
+}
+
+TEST(WireCodecTest, InterfaceVersionMapsToFormat) {
+    WireFormat format = WireFormat::V1;
+    ASSERT_TRUE(wire_format_from_interface_version(0, format));
+    EXPECT_EQ(format, WireFormat::Legacy);
+    ASSERT_TRUE(wire_format_from_interface_version(1, format));
+    EXPECT_EQ(format, WireFormat::V1);
+    EXPECT_FALSE(wire_format_from_interface_version(2, format));
+    EXPECT_EQ(interface_version_of(kCurrentWireFormat), 1);
+}
+
+// ==================== PAYLOAD LAYOUTS ====================
+
+TEST(WireCodecTest, V1SamplePayloadIsBigEndian) {
+    std::vector<uint8_t> bytes = encode_sample<SpeedSensor>(1.0f, 0x01020304u, WireFormat::V1);
+    EXPECT_EQ(bytes, (std::vector<uint8_t>{0x3F, 0x80, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04}));
+
+    SpeedData data = {};
+    ASSERT_TRUE(decode_sensor_data<SpeedSensor>(PayloadView(bytes.data(), bytes.size()), data, WireFormat::V1));
+    EXPECT_EQ(data.speed_kmh, 1.0f);
+    EXPECT_EQ(data.timestamp, 0x01020304u);
+}
+
+TEST(WireCodecTest, V1BatchHeaderIsBigEndian) {
+    std::vector<uint8_t> bytes(batch_payload_size(1));
+    encode_batch_header<EngineTempSensor>(1, bytes.data(), WireFormat::V1);
+    EngineTemperatureData data = {95.5f, 7};
+    encode_batch_record<EngineTempSensor>(data, 0, bytes.data(), WireFormat::V1);
+    EXPECT_EQ(bytes[0], 0x00);
+    EXPECT_EQ(bytes[1], 0x02);
+    EXPECT_EQ(bytes[2], 0x00);
+    EXPECT_EQ(bytes[3], 0x01);
+
+    SensorBatchView batch;
+    ASSERT_TRUE(decode_batch_header(PayloadView(bytes.data(), bytes.size()), batch, WireFormat::V1));
+    EXPECT_EQ(batch.method, EngineTempSensor::method_id);
+    EXPECT_EQ(batch.count, 1);
+    EngineTemperatureData decoded = decode_batch_record<EngineTempSensor>(batch, 0, WireFormat::V1);
+    EXPECT_EQ(decoded.temperature_celsius, 95.5f);
+    EXPECT_EQ(decoded.timestamp, 7u);
+}
+
+TEST(WireCodecTest, TrailingFieldsAreIgnoredByOlderDecoders) {
+    // A later layout appends the latency extension and one more unknown field
+    std::vector<uint8_t> bytes(extended_payload_size<AmbientTempSensor>() + 6, 0xAB);
+    AmbientTemperatureData data = {-4.5f, 99};
+    encode_sensor_data<AmbientTempSensor>(data, bytes.data(), WireFormat::V1);
+    encode_sample_extension<AmbientTempSensor>(SampleExtension{12, 3456789ull, 0x0304}, bytes.data(), WireFormat::V1);
+
+    PayloadView payload(bytes.data(), bytes.size());
+    AmbientTemperatureData decoded = {};
+    ASSERT_TRUE(decode_sensor_data<AmbientTempSensor>(payload, decoded, WireFormat::V1));
+    EXPECT_EQ(decoded.temperature_celsius, -4.5f);
+    SampleExtension ext = {};
+    ASSERT_TRUE(decode_sample_extension<AmbientTempSensor>(payload, ext, WireFormat::V1));
+    EXPECT_EQ(ext.sequence, 12u);
+    EXPECT_EQ(ext.send_ns, 3456789ull);
+    EXPECT_EQ(ext.stream, 0x0304);
+
+    // Without the appended bytes the extension is simply absent
+    PayloadView plain(bytes.data(), AmbientTempSensor::payload_size);
+    EXPECT_FALSE(decode_sample_extension<AmbientTempSensor>(plain, ext, WireFormat::V1));
+}
+
+TEST(WireCodecTest, LayoutsAreCheckedAtCompileTime) {
+    static_assert(sensor_layouts_valid(Sensors{}), "registered sensors");
+    static_assert(sizeof(CaptureRecordHeader) == 32, "capture records keep their size");
+    SUCCEED();
+}
+
+// ==================== GATEWAY HANDLING ====================
+
+TEST(WireCodecTest, GatewayDecodesBothFormats) {
+    auto legacy = make_request(SpeedSensor::method_id, encode_sample<SpeedSensor>(42.0f, 1, WireFormat::Legacy),
+                               0x0B01, 0x0001, 0);
+    auto v1 = make_request(EngineTempSensor::method_id,
+                           encode_sample<EngineTempSensor>(104.25f, 2, WireFormat::V1), 0x0B01, 0x0001, 1);
+
+    silence_console([&]() {
+        dispatch_sensor_message(legacy);
+        dispatch_sensor_message(v1);
+    });
+
+    LatestValue value = {};
+    ASSERT_TRUE(latest_values().lookup(0x0B01, 0x0001, SpeedSensor::method_id, value));
+    EXPECT_EQ(value.value, 42.0f);
+    ASSERT_TRUE(latest_values().lookup(0x0B01, 0x0001, EngineTempSensor::method_id, value));
+    EXPECT_EQ(value.value, 104.25f);
+    EXPECT_EQ(value.timestamp, 2u);
+    EXPECT_TRUE(value.alarm);
+}
+
+TEST(WireCodecTest, GatewayDecodesV1Batches) {
+    std::vector<uint8_t> bytes(batch_payload_size(2));
+    encode_batch_header<AmbientTempSensor>(2, bytes.data(), WireFormat::V1);
+    encode_batch_record<AmbientTempSensor>(AmbientTemperatureData{3.0f, 10}, 0, bytes.data(), WireFormat::V1);
+    encode_batch_record<AmbientTempSensor>(AmbientTemperatureData{-2.0f, 11}, 1, bytes.data(), WireFormat::V1);
+    auto request = make_request(kSensorBatchMethod, bytes, 0x0B01, 0x0001, 1);
+    int before = get_message_count();
+
+    silence_console([&]() { on_sensor_batch_message(request); });
+
+    EXPECT_EQ(get_message_count(), before + 2);
+    LatestValue value = {};
+    ASSERT_TRUE(latest_values().lookup(0x0B01, 0x0001, AmbientTempSensor::method_id, value));
+    EXPECT_EQ(value.value, -2.0f);
+    EXPECT_EQ(value.timestamp, 11u);
+}
+
+TEST(WireCodecTest, UnknownVersionIsRejected) {
+    auto request = make_request(SpeedSensor::method_id, encode_sample<SpeedSensor>(10.0f, 1, WireFormat::V1),
+                                0x0B01, 0x0001, 2);
+    uint64_t errors = gateway_metrics().decode_errors(SpeedSensor::method_id);
+    int before = get_message_count();
+
+    responses.clear();
+    set_response_sink(record_response);
+    silence_console([&]() { dispatch_sensor_message(request); });
+    set_response_sink(nullptr);
+
+    ASSERT_EQ(responses.size(), 1u);
+    EXPECT_EQ(responses[0]->get_return_code(), vsomeip::return_code_e::E_WRONG_INTERFACE_VERSION);
+    EXPECT_EQ(gateway_metrics().decode_errors(SpeedSensor::method_id), errors + 1);
+    EXPECT_EQ(get_message_count(), before);
+}
+
+// ==================== GATEWAY OUTPUT ====================
+
+static std::vector<std::vector<uint8_t>> events;
+
+static void record_event(uint16_t, uint16_t, uint16_t, const std::shared_ptr<vsomeip::payload> &payload) {
+    events.emplace_back(payload->get_data(), payload->get_data() + payload->get_length());
+}
+
+TEST(WireCodecTest, EventsUseCurrentFormat) {
+    ScopedSensorEvents events_on(record_event);
+    events.clear();
+    auto legacy = make_request(SpeedSensor::method_id,
+                               encode_sample<SpeedSensor>(88.5f, 0x01020304, WireFormat::Legacy), 0x0B01, 0x0001, 0);
+
+    silence_console([&]() { dispatch_sensor_message(legacy); });
+
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0], encode_sample<SpeedSensor>(88.5f, 0x01020304, kCurrentWireFormat));
+    EXPECT_EQ(std::vector<uint8_t>(events[0].begin() + 4, events[0].end()),
+              (std::vector<uint8_t>{0x01, 0x02, 0x03, 0x04}));
+}
+
+TEST(WireCodecTest, LatestValuesResponseUsesCurrentFormat) {
+    latest_values().update(0x0B02, 0x0001, SpeedSensor::method_id, LatestValue{61.0f, 0x0A0B0C0D, monotonic_ns(), false});
+    latest_values().update(0x0B02, 0x0001, AmbientTempSensor::method_id, LatestValue{-3.5f, 9, monotonic_ns(), true});
+    // Method list of a version 1 request, in network order
+    std::vector<uint8_t> query(4);
+    store_be<uint16_t>(query.data(), AmbientTempSensor::method_id);
+    store_be<uint16_t>(query.data() + 2, SpeedSensor::method_id);
+    auto request = make_request(kLatestValuesMethod, query, 0x0B01, 0x0001, 1);
+    request->set_service(0x0B02);
+
+    auto response = make_latest_values_response(request);
+
+    EXPECT_EQ(response->get_interface_version(), interface_version_of(kCurrentWireFormat));
+    PayloadView payload(*response->get_payload());
+    uint16_t count = 0;
+    ASSERT_TRUE(decode_latest_header(payload, count, kCurrentWireFormat));
+    ASSERT_EQ(count, 2u);
+    LatestValueRecord ambient = decode_latest_record(payload, 0, kCurrentWireFormat);
+    LatestValueRecord speed = decode_latest_record(payload, 1, kCurrentWireFormat);
+    EXPECT_EQ(ambient.method, AmbientTempSensor::method_id);
+    EXPECT_EQ(ambient.value, -3.5f);
+    EXPECT_EQ(ambient.flags, kLatestFlagAlarm);
+    EXPECT_EQ(speed.method, SpeedSensor::method_id);
+    EXPECT_EQ(speed.timestamp, 0x0A0B0C0Du);
+    EXPECT_EQ(load_be<uint16_t>(payload.data()), 2u);
+}
+
+TEST(WireCodecTest, StatsResponseUsesCurrentFormat) {
+    std::vector<uint8_t> query(2);
+    store_be<uint16_t>(query.data(), EngineTempSensor::method_id);
+    auto response = make_sensor_stats_response(make_request(kSensorStatsMethod, query, 0x0B01, 0x0001, 1));
+
+    EXPECT_EQ(response->get_interface_version(), interface_version_of(kCurrentWireFormat));
+    PayloadView payload(*response->get_payload());
+    uint16_t method = 0, windows = 0;
+    ASSERT_TRUE(decode_stats_header(payload, method, windows, kCurrentWireFormat));
+    EXPECT_EQ(method, EngineTempSensor::method_id);
+    ASSERT_EQ(windows, sensor_history(EngineTempSensor::method_id)->window_count());
+    ASSERT_GT(windows, 0u);
+    EXPECT_EQ(load_be<uint16_t>(payload.data()), EngineTempSensor::method_id);
+    WindowStats stats;
+    sensor_history(EngineTempSensor::method_id)->stats(0, stats);
+    EXPECT_EQ(decode_stats_record(payload, 0, kCurrentWireFormat).window_ms, stats.window_ms);
+}
@@ -0,0 +1,268 @@
+#include "traffic_recorder.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A partially filled chunk is written after this long, so captures stay current
+static const std::chrono::milliseconds kFlushInterval(200);
+
+TrafficRecorder::TrafficRecorder(const RecorderConfig& config)
+    : config_(config), active_(nullptr), running_(false), fd_(-1), segment_(0), segment_bytes_(0),
+      segment_records_(0), first_receive_ns_(0), last_receive_ns_(0), write_failed_(false),
+      records_(0), dropped_(0), bytes_written_(0), segments_(0) {
+    size_t chunks = config_.chunks < 2 ? 2 : config_.chunks;
+    storage_.resize(chunks);
+    free_.reserve(chunks);
+    full_.reserve(chunks);
+    for (Chunk& chunk : storage_) {
+        chunk.data.reset(new uint8_t[config_.chunk_bytes]);
+        chunk.used = 0;
+        free_.push_back(&chunk);
+    }
+    active_ = free_.back();
+    free_.pop_back();
+}
+
+TrafficRecorder::~TrafficRecorder() {
+    stop();
+}
+
+bool TrafficRecorder::start(std::string& error) {
+    if (running_) return true;
+    ::mkdir(config_.directory.c_str(), 0755);
+    if (!open_segment(error)) return false;
+    
+    running_ = true;
+    writer_ = std::thread(&TrafficRecorder::run_writer, this);
+    return true;
+}
+
+void TrafficRecorder::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    chunk_full_.notify_one();
+    writer_.join();
+    close_segment();
+}
+
+bool TrafficRecorder::record(const vsomeip::message& message, uint64_t receive_ns) {
+    const vsomeip::payload* payload = message.get_payload().get();
+    const uint32_t length = payload ? payload->get_length() : 0;
+    const size_t size = capture_record_size(length);
+    
+    CaptureRecordHeader header = {};
+    header.receive_ns = receive_ns;
+    header.record_size = static_cast<uint32_t>(size);
+    header.payload_length = length;
+    header.service = message.get_service();
+    header.instance = message.get_instance();
+    header.method = message.get_method();
+    header.client = message.get_client();
+    header.session = message.get_session();
+    header.message_type = static_cast<uint8_t>(message.get_message_type());
+    header.interface_version = message.get_interface_version();
+    header.reliable = message.is_reliable() ? 1 : 0;
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_ || size > config_.chunk_bytes) {
+        lock.unlock();
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (active_->used + size > config_.chunk_bytes) {
+        if (free_.empty()) {
+            // The writer is behind: drop rather than block the handler
+            lock.unlock();
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        full_.push_back(active_);
+        active_ = free_.back();
+        free_.pop_back();
+        chunk_full_.notify_one();
+    }
+    
+    uint8_t* at = active_->data.get() + active_->used;
+    std::memcpy(at, &header, sizeof(header));
+    if (length > 0) std::memcpy(at + sizeof(header), payload->get_data(), length);
+    std::memset(at + sizeof(header) + length, 0, size - sizeof(header) - length);
+    active_->used += size;
+    lock.unlock();
+    
+    records_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void TrafficRecorder::run_writer() {
+    std::vector<Chunk*> batch;
+    batch.reserve(storage_.size());
+    for (;;) {
+        bool stopping = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            chunk_full_.wait_for(lock, kFlushInterval, [this]() { return !full_.empty() || !running_; });
+            stopping = !running_;
+            // Idle or stopping: hand over the partial chunk as well
+            if (full_.empty() || stopping) {
+                if (active_->used > 0 && !free_.empty()) {
+                    full_.push_back(active_);
+                    active_ = free_.back();
+                    free_.pop_back();
+                }
+            }
+            batch.swap(full_);
+        }
+        
+        for (Chunk* chunk : batch) write_chunk(*chunk);
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (Chunk* chunk : batch) {
+                chunk->used = 0;
+                free_.push_back(chunk);
+            }
+            // A partial chunk left behind while every chunk was queued
+            if (stopping && active_->used > 0) {
+                batch.clear();
+                batch.push_back(active_);
+            } else {
+                batch.clear();
+            }
+        }
+        
+        if (stopping) {
+            for (Chunk* chunk : batch) {
+                write_chunk(*chunk);
+                chunk->used = 0;
+            }
+            return;
+        }
+    }
+}
+
+void TrafficRecorder::write_chunk(const Chunk& chunk) {
+    if (chunk.used == 0) return;
+    if (segment_records_ > 0 && segment_bytes_ + chunk.used > config_.segment_bytes) {
+        close_segment();
+        ++segment_;
+        std::string error;
+        if (!open_segment(error)) {
+            std::cerr << "❌ Recorder: " << error << std::endl;
+            write_failed_ = true;
+        }
+    }
+    
+    // Walk the records once to maintain the sparse index
+    PayloadView data(chunk.data.get(), chunk.used);
+    CaptureRecordHeader header;
+    PayloadView payload;
+    for (size_t offset = 0; decode_capture_record(data, offset, header, payload); offset += header.record_size) {
+        if (segment_records_ % kCaptureIndexStride == 0) {
+            index_.push_back(CaptureIndexEntry{header.receive_ns, segment_bytes_ + offset, segment_records_});
+        }
+        if (segment_records_ == 0) first_receive_ns_ = header.receive_ns;
+        last_receive_ns_ = header.receive_ns;
+        ++segment_records_;
+    }
+    
+    write_all(chunk.data.get(), chunk.used);
+    segment_bytes_ += chunk.used;
+}
+
+void TrafficRecorder::write_all(const uint8_t* data, size_t length) {
+    while (length > 0 && fd_ >= 0 && !write_failed_) {
+        ssize_t written = ::write(fd_, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "❌ Recorder: write failed: " << std::strerror(errno) << std::endl;
+            write_failed_ = true;
+            return;
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+        bytes_written_.fetch_add(static_cast<uint64_t>(written), std::memory_order_relaxed);
+    }
+}
+
+bool TrafficRecorder::open_segment(std::string& error) {
+    std::string path = capture_segment_path(config_.directory, segment_, "seg");
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        error = "cannot create " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    
+    CaptureSegmentHeader header = {};
+    std::memcpy(header.magic, "VSCAPSEG", 8);
+    header.version = kCaptureVersion;
+    header.header_size = sizeof(header);
+    header.segment = segment_;
+    write_all(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    
+    segment_bytes_ = sizeof(header);
+    segment_records_ = 0;
+    first_receive_ns_ = 0;
+    last_receive_ns_ = 0;
+    index_.clear();
+    segments_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void TrafficRecorder::close_segment() {
+    if (fd_ < 0) return;
+    
+    // The first receive time is only known once records arrived
+    CaptureSegmentHeader header = {};
+    std::memcpy(header.magic, "VSCAPSEG", 8);
+    header.version = kCaptureVersion;
+    header.header_size = sizeof(header);
+    header.segment = segment_;
+    header.first_receive_ns = first_receive_ns_;
+    if (::pwrite(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+        std::cerr << "❌ Recorder: cannot update segment header" << std::endl;
+    }
+    ::close(fd_);
+    fd_ = -1;
+    
+    std::string path = capture_segment_path(config_.directory, segment_, "idx");
+    int index_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (index_fd < 0) {
+        std::cerr << "❌ Recorder: cannot create " << path << std::endl;
+        return;
+    }
+    CaptureIndexHeader index_header = {};
+    std::memcpy(index_header.magic, "VSCAPIDX", 8);
+    index_header.version = kCaptureVersion;
+    index_header.stride = static_cast<uint32_t>(kCaptureIndexStride);
+    index_header.records = segment_records_;
+    index_header.last_receive_ns = last_receive_ns_;
+    bool ok = ::write(index_fd, &index_header, sizeof(index_header)) == static_cast<ssize_t>(sizeof(index_header));
+    size_t index_bytes = index_.size() * sizeof(CaptureIndexEntry);
+    if (ok && index_bytes > 0) {
+        ok = ::write(index_fd, index_.data(), index_bytes) == static_cast<ssize_t>(index_bytes);
+    }
+    if (!ok) std::cerr << "❌ Recorder: cannot write " << path << std::endl;
+    ::close(index_fd);
+}
+
+static std::atomic<TrafficRecorder*> installed_recorder(nullptr);
+
+void set_traffic_recorder(TrafficRecorder* recorder) {
+    installed_recorder.store(recorder, std::memory_order_release);
+}
+
+const TrafficRecorder* installed_traffic_recorder() {
+    return installed_recorder.load(std::memory_order_acquire);
+}
+
+void record_traffic(const vsomeip::message& message, uint64_t receive_ns) {
+    TrafficRecorder* recorder = installed_recorder.load(std::memory_order_acquire);
+    if (recorder) recorder->record(message, receive_ns);
+}
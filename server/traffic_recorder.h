@@ -0,0 +1,101 @@
+#ifndef TRAFFIC_RECORDER_H
+#define TRAFFIC_RECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <vsomeip/vsomeip.hpp>
+#include "capture_format.h"
+
+struct RecorderConfig {
+    std::string directory;
+    size_t segment_bytes = size_t(256) << 20;   // a new segment starts beyond this size
+    size_t chunk_bytes = size_t(1) << 20;       // unit of buffering and of each write()
+    size_t chunks = 16;                         // buffered chunks before records are dropped
+};
+
+// Append-only recorder of received traffic in the capture format.
+// Handler threads copy each message into the active in-memory chunk (the
+// lock only covers that memcpy); full chunks go to a background thread
+// that writes them to the current segment with one large write() each,
+// rotates segments and writes the sparse index when a segment closes.
+// The handler never waits for the disk: when every chunk is still queued
+// for writing, records are dropped and counted instead.
+class TrafficRecorder {
+public:
+    explicit TrafficRecorder(const RecorderConfig& config);
+    ~TrafficRecorder();
+
+    TrafficRecorder(const TrafficRecorder&) = delete;
+    TrafficRecorder& operator=(const TrafficRecorder&) = delete;
+
+    // Opens the first segment and starts the writer thread
+    bool start(std::string& error);
+
+    // Writes everything recorded so far and closes the current segment
+    void stop();
+
+    // Copies one message; returns false when it was dropped
+    bool record(const vsomeip::message& message, uint64_t receive_ns);
+
+    uint64_t records() const { return records_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t bytes_written() const { return bytes_written_.load(std::memory_order_relaxed); }
+    uint64_t segments() const { return segments_.load(std::memory_order_relaxed); }
+
+private:
+    struct Chunk {
+        std::unique_ptr<uint8_t[]> data;
+        size_t used;
+    };
+
+    void run_writer();
+    void write_chunk(const Chunk& chunk);
+    bool open_segment(std::string& error);
+    void close_segment();
+    void write_all(const uint8_t* data, size_t length);
+
+    const RecorderConfig config_;
+    std::vector<Chunk> storage_;
+
+    // Shared between handlers and writer, guarded by mutex_
+    std::mutex mutex_;
+    std::condition_variable chunk_full_;
+    Chunk* active_;
+    std::vector<Chunk*> free_;
+    std::vector<Chunk*> full_;
+    bool running_;
+
+    // Writer thread state
+    std::thread writer_;
+    int fd_;
+    uint64_t segment_;
+    uint64_t segment_bytes_;
+    uint64_t segment_records_;
+    uint64_t first_receive_ns_;
+    uint64_t last_receive_ns_;
+    std::vector<CaptureIndexEntry> index_;
+    bool write_failed_;
+
+    std::atomic<uint64_t> records_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> bytes_written_;
+    std::atomic<uint64_t> segments_;
+};
+
+// Recorder fed by the sensor handlers; nullptr (the default) disables recording
+void set_traffic_recorder(TrafficRecorder* recorder);
+
+// Currently installed recorder, nullptr when recording is off
+const TrafficRecorder* installed_traffic_recorder();
+
+// Records message if a recorder is installed
+void record_traffic(const vsomeip::message& message, uint64_t receive_ns);
+
+#endif // TRAFFIC_RECORDER_H